@@ -48,6 +48,7 @@
 #include "nodes/primnodes.hpp"
 #include "pg_definitions.hpp"
 #include "postgres_parser.hpp"
+#include "storage/page/pax_page.h"
 #include "type/type_id.h"
 
 namespace bustub {
@@ -112,7 +113,36 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  auto format = TableFormat::ROW;
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      if (std::string(option->defname) != "format" || option->arg == nullptr) {
+        throw NotImplementedException(fmt::format("unsupported table option: {}", option->defname));
+      }
+      // `format = pax` comes in as a type name, `format = 'pax'` as a string.
+      std::string value;
+      if (option->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(option->arg);
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+      } else if (option->arg->type == duckdb_libpgquery::T_PGString) {
+        value = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str;
+      }
+      value = StringUtil::Lower(value);
+      if (value == "row") {
+        format = TableFormat::ROW;
+      } else if (value == "pax") {
+        format = TableFormat::PAX;
+      } else {
+        throw NotImplementedException(fmt::format("unsupported table format: {}", value));
+      }
+    }
+  }
+  if (format == TableFormat::PAX && PaxPage::GetCapacity(Schema(columns)) == 0) {
+    throw bustub::Exception("a row of the table does not fit a PAX page");
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), format);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
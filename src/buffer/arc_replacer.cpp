@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : capacity_(num_frames), entries_(num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  ListId list = VictimList();
+  if (list == ListId::None) {
+    return false;
+  }
+  QueueOf(list).Front(frame_id);
+  auto &entry = entries_[*frame_id];
+  QueueOf(list).Erase(*frame_id, entry.timestamp_, true);
+  if (entry.page_id_ != INVALID_PAGE_ID && !entry.is_scan_only_) {
+    (list == ListId::Recent ? b1_ : b2_).Push(entry.page_id_);
+    TrimGhosts();
+  }
+  entry = FrameEntry{};
+  return true;
+}
+
+auto ARCReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames;
+  ListId list = VictimList();
+  if (list == ListId::None) {
+    return frames;
+  }
+  QueueOf(list).AppendEvictable(&frames, max_frames);
+  QueueOf(list == ListId::Recent ? ListId::Frequent : ListId::Recent).AppendEvictable(&frames, max_frames);
+  return frames;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  bool is_scan = access_type == AccessType::Scan;
+  if (page_id != INVALID_PAGE_ID) {
+    entry.page_id_ = page_id;
+  }
+
+  if (entry.list_ != ListId::None) {
+    // A hit. Any repeated access other than a scan makes the page frequent.
+    if (!is_scan) {
+      entry.is_scan_only_ = false;
+      MoveTo(frame_id, ListId::Frequent);
+    }
+    return;
+  }
+
+  // A miss: the page has just been loaded into the frame.
+  if (!is_scan && page_id != INVALID_PAGE_ID) {
+    size_t b1_size = b1_.Size();
+    size_t b2_size = b2_.Size();
+    if (b1_.Erase(page_id)) {
+      p_ = std::min(capacity_, p_ + std::max<size_t>(1, b2_size / b1_size));
+      MoveTo(frame_id, ListId::Frequent);
+      return;
+    }
+    if (b2_.Erase(page_id)) {
+      size_t delta = std::max<size_t>(1, b1_size / b2_size);
+      p_ = p_ > delta ? p_ - delta : 0;
+      MoveTo(frame_id, ListId::Frequent);
+      return;
+    }
+  }
+  entry.is_scan_only_ = is_scan;
+  MoveTo(frame_id, ListId::Recent);
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (entry.list_ == ListId::None || entry.is_evictable_ == set_evictable) {
+    return;
+  }
+  entry.is_evictable_ = set_evictable;
+  QueueOf(entry.list_).SetEvictable(frame_id, entry.timestamp_, set_evictable);
+}
+
+auto ARCReplacer::IsEvictable(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  return entries_[frame_id].is_evictable_;
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= entries_.size() || entries_[frame_id].list_ == ListId::None) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  BUSTUB_ENSURE(entry.is_evictable_, "cannot remove a non-evictable frame");
+  QueueOf(entry.list_).Erase(frame_id, entry.timestamp_, true);
+  entry = FrameEntry{};
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return t1_.NumEvictable() + t2_.NumEvictable();
+}
+
+auto ARCReplacer::GetRecentTarget() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return p_;
+}
+
+void ARCReplacer::MoveTo(frame_id_t frame_id, ListId list) {
+  auto &entry = entries_[frame_id];
+  if (entry.list_ != ListId::None) {
+    QueueOf(entry.list_).Erase(frame_id, entry.timestamp_, entry.is_evictable_);
+  }
+  entry.list_ = list;
+  entry.timestamp_ = current_timestamp_++;
+  QueueOf(list).Push(frame_id, entry.timestamp_, entry.is_evictable_);
+}
+
+auto ARCReplacer::VictimList() const -> ListId {
+  bool t1_evictable = t1_.NumEvictable() > 0;
+  bool t2_evictable = t2_.NumEvictable() > 0;
+  if (t1_evictable && (t1_.Size() > p_ || !t2_evictable)) {
+    return ListId::Recent;
+  }
+  if (t2_evictable) {
+    return ListId::Frequent;
+  }
+  return ListId::None;
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (b1_.Size() > 0 && t1_.Size() + b1_.Size() > capacity_) {
+    b1_.PopFront();
+  }
+  while (t1_.Size() + t2_.Size() + b1_.Size() + b2_.Size() > 2 * capacity_) {
+    if (b2_.Size() > 0) {
+      b2_.PopFront();
+    } else {
+      b1_.PopFront();
+    }
+  }
+}
+
+}  // namespace bustub
@@ -12,48 +12,799 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <functional>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <utility>
+
 #include "common/exception.h"
 #include "common/macros.h"
 
 namespace bustub {
 
+namespace {
+
+auto ReaderStripeOfThisThread(size_t num_stripes) -> size_t {
+  static thread_local size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  return hash % num_stripes;
+}
+
+}  // namespace
+
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     FreePageMap *free_page_map)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      replacer_type_(replacer_type),
+      replacer_k_(replacer_k),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      scan_ring_size_(ScanRingSize(pool_size)),
+      in_scan_ring_(pool_size, false),
+      io_pending_(pool_size, false) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
+  pages_.reserve(pool_size);
+  for (size_t i = 0; i < pool_size; i++) {
+    pages_.emplace_back(std::make_unique<Page>());
+  }
+  page_table_ = new ConcurrentPageTable(pool_size_);
+  replacer_ = MakeReplacer(replacer_type, pool_size, replacer_k);
+  if (bpm_victim_cache_bytes > 0) {
+    victim_cache_ = std::make_unique<CompressedPageCache>(bpm_victim_cache_bytes);
+  }
+  free_page_map_ = free_page_map;
+  if (free_page_map_ == nullptr && bpm_free_page_map) {
+    owned_free_page_map_ = std::make_unique<FreePageMap>(disk_manager, num_instances);
+    free_page_map_ = owned_free_page_map_.get();
+  }
 
   // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
+  for (size_t i = 0; i < pool_size; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
-
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  throw NotImplementedException(
-      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-      "exception line in `buffer_pool_manager_instance.cpp`.");
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  delete io_pool_;
+  StopBackgroundWriter();
   delete page_table_;
-  delete replacer_;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { return nullptr; }
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id) -> bool {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  if (replacer_->Evict(frame_id)) {
+    ReleaseFrame(*frame_id);
+    return true;
+  }
+  // The replacer never sees unpinned frames of the scan ring, so they are the last resort.
+  return ReuseScanRingFrame(frame_id, false);
+}
+
+auto BufferPoolManagerInstance::AcquireScanFrame(frame_id_t *frame_id) -> bool {
+  if (scan_ring_.size() >= scan_ring_size_ && ReuseScanRingFrame(frame_id, true)) {
+    return true;
+  }
+  if (!AcquireFrame(frame_id)) {
+    return false;
+  }
+  if (scan_ring_.size() < scan_ring_size_) {
+    scan_ring_.push_back(*frame_id);
+    in_scan_ring_[*frame_id] = true;
+  }
+  return true;
+}
+
+auto BufferPoolManagerInstance::ReuseScanRingFrame(frame_id_t *frame_id, bool keep_in_ring) -> bool {
+  for (auto it = scan_ring_.begin(); it != scan_ring_.end(); ++it) {
+    if (pages_[*it]->GetPinCount() != 0) {
+      continue;
+    }
+    *frame_id = *it;
+    if (keep_in_ring) {
+      scan_ring_.splice(scan_ring_.end(), scan_ring_, it);
+    } else {
+      scan_ring_.erase(it);
+      in_scan_ring_[*frame_id] = false;
+    }
+    // Ring frames are never evictable, but the replacer only forgets evictable frames.
+    replacer_->SetEvictable(*frame_id, true);
+    replacer_->Remove(*frame_id);
+    ReleaseFrame(*frame_id);
+    return true;
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::LeaveScanRing(frame_id_t frame_id) {
+  if (in_scan_ring_[frame_id]) {
+    scan_ring_.remove(frame_id);
+    in_scan_ring_[frame_id] = false;
+    if (pages_[frame_id]->GetPinCount() == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::ReleaseFrame(frame_id_t frame_id) {
+  Page *victim = pages_[frame_id].get();
+  if (victim->IsDirty()) {
+    disk_manager_->WritePage(victim->GetPageId(), victim->GetData());
+    SetDirty(victim, false);
+    Count(BufferPoolEvent::ForegroundWrite);
+  }
+  // A clean page that came from the victim cache may still have its copy there, so it need not be compressed again.
+  if (victim_cache_ != nullptr && !victim_cache_->Touch(victim->GetPageId())) {
+    victim_cache_->Insert(victim->GetPageId(), victim->GetData());
+  }
+  page_table_->Remove(victim->GetPageId());
+  Count(BufferPoolEvent::Eviction);
+}
+
+void BufferPoolManagerInstance::OnUnpinned(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) >= pool_size_) {
+    RetireFrame(frame_id);
+    num_retiring_--;
+    resize_cv_.notify_all();
+    return;
+  }
+  // Frames in the scan ring are only ever reused by scans, so the replacer never gets to evict them.
+  if (!in_scan_ring_[frame_id]) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+}
+
+void BufferPoolManagerInstance::RetireFrame(frame_id_t frame_id) {
+  replacer_->SetEvictable(frame_id, true);
+  replacer_->Remove(frame_id);
+  ReleaseFrame(frame_id);
+  Page *page = pages_[frame_id].get();
+  page->page_id_ = INVALID_PAGE_ID;
+}
+
+void BufferPoolManagerInstance::RebuildReplacer() {
+  auto replacer = MakeReplacer(replacer_type_, pages_.size(), replacer_k_);
+  std::vector<frame_id_t> evictable = replacer_->GetEvictionCandidates(pages_.size());
+  for (size_t i = 0; i < pages_.size(); i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    page_id_t page_id = pages_[i]->GetPageId();
+    if (page_id != INVALID_PAGE_ID && !replacer_->IsEvictable(frame_id)) {
+      replacer->RecordAccess(frame_id, page_id, in_scan_ring_[i] ? AccessType::Scan : AccessType::Unknown);
+      replacer->SetEvictable(frame_id, false);
+    }
+  }
+  // The next victim is recorded first, so that it is the least recently used frame of the new replacer.
+  for (frame_id_t frame_id : evictable) {
+    replacer->RecordAccess(frame_id, pages_[frame_id]->GetPageId(), AccessType::Unknown);
+    replacer->SetEvictable(frame_id, true);
+  }
+  replacer_ = std::move(replacer);
+}
+
+auto BufferPoolManagerInstance::Resize(size_t pool_size) -> bool {
+  if (pool_size == 0) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> resize_lock(resize_latch_);
+  std::unique_lock<std::mutex> lock(latch_);
+  size_t old_size = pages_.size();
+  if (pool_size >= old_size) {
+    BlockOptimisticReads();
+    pages_.reserve(pool_size);
+    for (size_t i = old_size; i < pool_size; i++) {
+      pages_.emplace_back(std::make_unique<Page>());
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+    UnblockOptimisticReads();
+    in_scan_ring_.resize(pool_size, false);
+    io_pending_.resize(pool_size, false);
+  } else {
+    // From here on, frames at or past pool_size_ are never handed out again, and OnUnpinned() retires them.
+    pool_size_ = pool_size;
+    free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+    for (auto it = scan_ring_.begin(); it != scan_ring_.end();) {
+      if (static_cast<size_t>(*it) >= pool_size) {
+        in_scan_ring_[*it] = false;
+        it = scan_ring_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (size_t i = pool_size; i < old_size; i++) {
+      Page *page = pages_[i].get();
+      if (page->GetPageId() == INVALID_PAGE_ID) {
+        continue;
+      }
+      if (page->GetPinCount() == 0) {
+        RetireFrame(static_cast<frame_id_t>(i));
+      } else {
+        num_retiring_++;
+      }
+    }
+    if (!resize_cv_.wait_for(lock, bpm_resize_timeout, [this] { return num_retiring_ == 0; })) {
+      // Give up. The frames still pinned keep their pages, and the ones emptied meanwhile are handed out again.
+      pool_size_ = old_size;
+      num_retiring_ = 0;
+      for (size_t i = pool_size; i < old_size; i++) {
+        if (pages_[i]->GetPageId() == INVALID_PAGE_ID) {
+          free_list_.emplace_back(static_cast<frame_id_t>(i));
+        }
+      }
+      return false;
+    }
+    BlockOptimisticReads();
+    pages_.resize(pool_size);
+    UnblockOptimisticReads();
+    in_scan_ring_.resize(pool_size);
+    io_pending_.resize(pool_size);
+  }
+  pool_size_ = pool_size;
+  scan_ring_size_ = ScanRingSize(pool_size);
+  RebuildReplacer();
+  return true;
+}
+
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id)) {
+    Count(BufferPoolEvent::NoFreeFrame);
+    return nullptr;
+  }
+  *page_id = AllocatePage();
+  Count(BufferPoolEvent::NewPage);
+  // The id may be one that was given back; a copy of the page it named must not come back to life.
+  if (victim_cache_ != nullptr) {
+    victim_cache_->Erase(*page_id);
+  }
+
+  Page *page = pages_[frame_id].get();
+  page->BeginUpdate();
+  page->ResetMemory();
+  page->page_id_ = *page_id;
+  page->EndUpdate();
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page_table_->Insert(*page_id, frame_id);
+
+  replacer_->RecordAccess(frame_id, *page_id, AccessType::Unknown);
+  replacer_->SetEvictable(frame_id, false);
+  return page;
+}
+
+auto BufferPoolManagerInstance::PinResidentPage(frame_id_t frame_id, page_id_t page_id, AccessType access_type)
+    -> Page * {
+  Page *page = pages_[frame_id].get();
+  page->pin_count_++;
+  if (access_type != AccessType::Scan) {
+    LeaveScanRing(frame_id);
+  }
+  replacer_->RecordAccess(frame_id, page_id, access_type);
+  replacer_->SetEvictable(frame_id, false);
+  Count(BufferPoolEvent::FetchHit);
+  return page;
+}
+
+auto BufferPoolManagerInstance::InstallPage(frame_id_t frame_id, page_id_t page_id, AccessType access_type) -> Page * {
+  Count(BufferPoolEvent::FetchMiss);
+  Page *page = pages_[frame_id].get();
+  // The version stays odd until the page has been read, so that optimistic readers keep away from the frame.
+  page->BeginUpdate();
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page_table_->Insert(page_id, frame_id);
+  replacer_->RecordAccess(frame_id, page_id, access_type);
+  replacer_->SetEvictable(frame_id, false);
+  io_pending_[frame_id] = true;
+  return page;
+}
+
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  ValidatePageId(page_id);
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_table_->Find(page_id, frame_id)) {
+    Page *page = PinResidentPage(frame_id, page_id, access_type);
+    // The page may still be on its way from disk, e.g. if it is being prefetched. Our pin keeps the frame in place.
+    if (io_pending_[frame_id]) {
+      Count(BufferPoolEvent::IoWait);
+      io_cv_.wait(lock, [this, frame_id] { return !io_pending_[frame_id]; });
+    }
+    return page;
+  }
+
+  bool acquired = access_type == AccessType::Scan ? AcquireScanFrame(&frame_id) : AcquireFrame(&frame_id);
+  if (!acquired) {
+    Count(BufferPoolEvent::NoFreeFrame);
+    return nullptr;
+  }
+  Page *page = InstallPage(frame_id, page_id, access_type);
+
+  // Read the page without holding the latch, so that other threads can use the pool meanwhile. Anyone else who
+  // fetches the page waits for io_pending_ to clear.
+  lock.unlock();
+  ReadPage(page_id, page->GetData());
+  lock.lock();
+  page->EndUpdate();
+  io_pending_[frame_id] = false;
+  io_cv_.notify_all();
+  return page;
+}
+
+auto BufferPoolManagerInstance::OptimisticReadPgImp(page_id_t page_id, const read_page_fn &read) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  ValidatePageId(page_id);
+  size_t stripe = ReaderStripeOfThisThread(NUM_READER_STRIPES);
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+    if (!EnterOptimisticRead(stripe)) {
+      break;
+    }
+    // Look the frame up only once inside, so that a shrinking Resize() cannot take it away in between.
+    frame_id_t frame_id;
+    if (!page_table_->Find(page_id, frame_id) || static_cast<size_t>(frame_id) >= pages_.size()) {
+      LeaveOptimisticRead(stripe);
+      break;
+    }
+    // The frame may be given another page at any time, so even its page id is only trusted once the version holds.
+    Page *page = pages_[frame_id].get();
+    uint64_t version = page->GetVersion();
+    bool valid = false;
+    if ((version & 1) == 0 && page->page_id_ == page_id) {
+      read(page);
+      valid = page->ValidateVersion(version);
+    }
+    LeaveOptimisticRead(stripe);
+    if (valid) {
+      Count(BufferPoolEvent::OptimisticRead);
+      return true;
+    }
+    Count(BufferPoolEvent::OptimisticReadConflict);
+  }
+  return BufferPoolManager::OptimisticReadPgImp(page_id, read);
+}
 
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { return nullptr; }
+auto BufferPoolManagerInstance::EnterOptimisticRead(size_t stripe) -> bool {
+  // Together with BlockOptimisticReads(), this is a Dekker handshake: either Resize() sees the reader, or the reader
+  // sees resizing_.
+  optimistic_readers_[stripe].count_.fetch_add(1, std::memory_order_seq_cst);
+  if (resizing_.load(std::memory_order_seq_cst)) {
+    LeaveOptimisticRead(stripe);
+    return false;
+  }
+  return true;
+}
 
-auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool { return false; }
+void BufferPoolManagerInstance::LeaveOptimisticRead(size_t stripe) {
+  optimistic_readers_[stripe].count_.fetch_sub(1, std::memory_order_release);
+}
 
-auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool { return false; }
+void BufferPoolManagerInstance::BlockOptimisticReads() {
+  resizing_.store(true, std::memory_order_seq_cst);
+  for (auto &readers : optimistic_readers_) {
+    while (readers.count_.load(std::memory_order_seq_cst) != 0) {
+      std::this_thread::yield();
+    }
+  }
+}
 
-void BufferPoolManagerInstance::FlushAllPgsImp() {}
+void BufferPoolManagerInstance::UnblockOptimisticReads() { resizing_.store(false, std::memory_order_release); }
 
-auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool { return false; }
+void BufferPoolManagerInstance::ReadPage(page_id_t page_id, char *page_data) {
+  if (victim_cache_ != nullptr) {
+    if (victim_cache_->Lookup(page_id, page_data)) {
+      Count(BufferPoolEvent::VictimCacheHit);
+      return;
+    }
+    Count(BufferPoolEvent::VictimCacheMiss);
+  }
+  auto start_time = std::chrono::steady_clock::now();
+  disk_manager_->ReadPage(page_id, page_data);
+  auto read_time = std::chrono::steady_clock::now() - start_time;
+  Count(BufferPoolEvent::DiskReadNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(read_time).count());
+}
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManagerInstance::FetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  std::vector<std::pair<page_id_t, char *>> reads;
+  std::vector<frame_id_t> read_frames;
+  std::vector<frame_id_t> wait_frames;
+  std::unique_lock<std::mutex> lock(latch_);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    page_id_t page_id = page_ids[i];
+    if (page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    ValidatePageId(page_id);
+    frame_id_t frame_id;
+    if (page_table_->Find(page_id, frame_id)) {
+      pages[i] = PinResidentPage(frame_id, page_id, access_type);
+      if (io_pending_[frame_id]) {
+        wait_frames.push_back(frame_id);
+      }
+      continue;
+    }
+    bool acquired = access_type == AccessType::Scan ? AcquireScanFrame(&frame_id) : AcquireFrame(&frame_id);
+    if (!acquired) {
+      Count(BufferPoolEvent::NoFreeFrame);
+      continue;
+    }
+    pages[i] = InstallPage(frame_id, page_id, access_type);
+    reads.emplace_back(page_id, pages[i]->GetData());
+    read_frames.push_back(frame_id);
+  }
+
+  // Read the misses that the victim cache does not have with one request, without holding the latch. Pages that
+  // appear twice in the batch, or that other threads are reading, are waited for afterwards, so that we never wait for
+  // a read we have yet to issue.
+  if (!read_frames.empty()) {
+    lock.unlock();
+    if (victim_cache_ != nullptr) {
+      auto end = std::remove_if(reads.begin(), reads.end(), [this](const auto &read) {
+        bool cached = victim_cache_->Lookup(read.first, read.second);
+        Count(cached ? BufferPoolEvent::VictimCacheHit : BufferPoolEvent::VictimCacheMiss);
+        return cached;
+      });
+      reads.erase(end, reads.end());
+    }
+    if (!reads.empty()) {
+      auto start_time = std::chrono::steady_clock::now();
+      disk_manager_->ReadPages(reads);
+      auto read_time = std::chrono::steady_clock::now() - start_time;
+      Count(BufferPoolEvent::DiskReadNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(read_time).count());
+    }
+    lock.lock();
+    for (frame_id_t frame_id : read_frames) {
+      pages_[frame_id]->EndUpdate();
+      io_pending_[frame_id] = false;
+    }
+    io_cv_.notify_all();
+  }
+  for (frame_id_t frame_id : wait_frames) {
+    if (io_pending_[frame_id]) {
+      Count(BufferPoolEvent::IoWait);
+      io_cv_.wait(lock, [this, frame_id] { return !io_pending_[frame_id]; });
+    }
+  }
+  return pages;
+}
+
+auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  ValidatePageId(page_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  return UnpinResidentPage(page_id, is_dirty);
+}
+
+auto BufferPoolManagerInstance::UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  bool unpinned = true;
+  for (page_id_t page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      ValidatePageId(page_id);
+      unpinned = UnpinResidentPage(page_id, is_dirty) && unpinned;
+    }
+  }
+  return unpinned;
+}
+
+auto BufferPoolManagerInstance::UnpinResidentPage(page_id_t page_id, bool is_dirty) -> bool {
+  frame_id_t frame_id;
+  if (!page_table_->Find(page_id, frame_id)) {
+    return false;
+  }
+  Page *page = pages_[frame_id].get();
+  if (page->GetPinCount() <= 0) {
+    return false;
+  }
+  if (is_dirty) {
+    // The copy in the victim cache, if any, is about to become stale.
+    if (victim_cache_ != nullptr && !page->IsDirty()) {
+      victim_cache_->Erase(page_id);
+    }
+    SetDirty(page, true);
+    if (writer_thread_ != nullptr && IsTooDirty()) {
+      writer_cv_.notify_one();
+    }
+  }
+  if (--page->pin_count_ == 0) {
+    OnUnpinned(frame_id);
+  }
+  return true;
+}
+
+auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
+  ValidatePageId(page_id);
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_id == INVALID_PAGE_ID || !page_table_->Find(page_id, frame_id)) {
+    return false;
+  }
+  io_cv_.wait(lock, [this, frame_id] { return !io_pending_[frame_id]; });
+  Page *page = pages_[frame_id].get();
+  disk_manager_->WritePage(page_id, page->GetData());
+  SetDirty(page, false);
+  return true;
+}
+
+auto BufferPoolManagerInstance::FlushPgsImp(const std::vector<page_id_t> &page_ids) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  bool flushed;
+  std::vector<std::pair<page_id_t, const char *>> writes;
+  std::vector<Page *> pages;
+  // Waiting for a frame's I/O lets go of the latch, after which the frames looked up so far may hold other pages, so
+  // the batch is looked up again from the start.
+  for (bool waited = true; waited;) {
+    waited = false;
+    flushed = true;
+    writes.clear();
+    pages.clear();
+    for (page_id_t page_id : page_ids) {
+      ValidatePageId(page_id);
+      frame_id_t frame_id;
+      if (page_id == INVALID_PAGE_ID || !page_table_->Find(page_id, frame_id)) {
+        flushed = false;
+        continue;
+      }
+      if (io_pending_[frame_id]) {
+        io_cv_.wait(lock, [this, frame_id] { return !io_pending_[frame_id]; });
+        waited = true;
+        break;
+      }
+      pages.push_back(pages_[frame_id].get());
+      writes.emplace_back(page_id, pages.back()->GetData());
+    }
+  }
+  disk_manager_->WritePages(writes);
+  for (Page *page : pages) {
+    SetDirty(page, false);
+  }
+  return flushed;
+}
+
+void BufferPoolManagerInstance::FlushAllPgsImp() {
+  RunFlushHooks();
+  std::unique_lock<std::mutex> lock(latch_);
+  for (size_t i = 0; i < pages_.size(); i++) {
+    io_cv_.wait(lock, [this, i] { return !io_pending_[i]; });
+    Page *page = pages_[i].get();
+    if (page->GetPageId() != INVALID_PAGE_ID) {
+      disk_manager_->WritePage(page->GetPageId(), page->GetData());
+      SetDirty(page, false);
+    }
+  }
+  if (free_page_map_ != nullptr) {
+    free_page_map_->Flush();
+  }
+}
+
+auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+  ValidatePageId(page_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!page_table_->Find(page_id, frame_id)) {
+    if (victim_cache_ != nullptr) {
+      victim_cache_->Erase(page_id);
+    }
+    DeallocatePage(page_id);
+    return true;
+  }
+  Page *page = pages_[frame_id].get();
+  if (page->GetPinCount() > 0) {
+    return false;
+  }
+  // A page fetched back from the victim cache keeps its copy there, see ReleaseFrame().
+  if (victim_cache_ != nullptr) {
+    victim_cache_->Erase(page_id);
+  }
+  page_table_->Remove(page_id);
+  LeaveScanRing(frame_id);
+  replacer_->Remove(frame_id);
+  free_list_.push_back(frame_id);
+
+  page->BeginUpdate();
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->EndUpdate();
+  page->pin_count_ = 0;
+  SetDirty(page, false);
+  DeallocatePage(page_id);
+  return true;
+}
+
+void BufferPoolManagerInstance::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  for (page_id_t page_id : page_ids) {
+    frame_id_t frame_id;
+    if (page_id == INVALID_PAGE_ID || page_table_->Find(page_id, frame_id)) {
+      continue;
+    }
+    bool queued = GetIoPool()->Submit([this, page_id] {
+      if (FetchPgImp(page_id, AccessType::Scan) != nullptr) {
+        UnpinPgImp(page_id, false);
+      }
+    });
+    if (!queued) {
+      return;
+    }
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchChain(page_id_t first_page_id, size_t distance, next_page_fn next_page) {
+  if (first_page_id == INVALID_PAGE_ID || distance == 0) {
+    return;
+  }
+  GetIoPool()->Submit([this, first_page_id, distance, next_page = std::move(next_page)] {
+    ReadChain(first_page_id, distance, next_page);
+  });
+}
+
+auto BufferPoolManagerInstance::GetIoPool() -> IoWorkerPool * {
+  std::call_once(io_pool_once_, [this] { io_pool_ = new IoWorkerPool(BPM_IO_WORKERS, BPM_IO_QUEUE_SIZE); });
+  return io_pool_;
+}
+
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  if (free_page_map_ != nullptr) {
+    const page_id_t page_id = free_page_map_->AllocatePage(instance_index_);
+    ValidatePageId(page_id);
+    return page_id;
+  }
+  const page_id_t next_page_id = next_page_id_;
+  next_page_id_ += num_instances_;
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  if (free_page_map_ != nullptr) {
+    free_page_map_->DeallocatePage(page_id);
+  }
+}
+
+void BufferPoolManagerInstance::SetDirty(Page *page, bool is_dirty) {
+  if (page->is_dirty_ != is_dirty) {
+    page->is_dirty_ = is_dirty;
+    if (is_dirty) {
+      num_dirty_frames_++;
+    } else {
+      num_dirty_frames_--;
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::IsTooDirty() const -> bool {
+  return static_cast<double>(num_dirty_frames_) > bpm_writer_dirty_ratio * static_cast<double>(pool_size_);
+}
+
+void BufferPoolManagerInstance::StartBackgroundWriter() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (writer_thread_ != nullptr) {
+    return;
+  }
+  stop_writer_ = false;
+  writer_thread_ = new std::thread(&BufferPoolManagerInstance::RunBackgroundWriter, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  std::thread *writer_thread;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (writer_thread_ == nullptr) {
+      return;
+    }
+    writer_thread = writer_thread_;
+    stop_writer_ = true;
+  }
+  writer_cv_.notify_one();
+  writer_thread->join();
+  delete writer_thread;
+  std::scoped_lock<std::mutex> lock(latch_);
+  writer_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      writer_cv_.wait_for(lock, bpm_writer_interval, [this] { return stop_writer_ || IsTooDirty(); });
+      if (stop_writer_) {
+        return;
+      }
+    }
+    CleanTailFrames();
+  }
+}
+
+void BufferPoolManagerInstance::CleanTailFrames() {
+  std::vector<std::tuple<page_id_t, frame_id_t, Page *>> batch;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!IsTooDirty()) {
+      return;
+    }
+    // Look a little further than one batch, since some of the frames about to be evicted are already clean.
+    for (frame_id_t frame_id : replacer_->GetEvictionCandidates(2 * bpm_writer_batch_size)) {
+      Page *page = pages_[frame_id].get();
+      if (!page->IsDirty()) {
+        continue;
+      }
+      page->pin_count_++;
+      replacer_->SetEvictable(frame_id, false);
+      SetDirty(page, false);
+      batch.emplace_back(page->GetPageId(), frame_id, page);
+      if (batch.size() == bpm_writer_batch_size) {
+        break;
+      }
+    }
+  }
+
+  // Write in page id order so that the disk sees sequential I/O where it can. Each page is copied under its read
+  // latch, so that the whole batch can be handed to the disk manager at once without holding any latch meanwhile.
+  std::sort(batch.begin(), batch.end());
+  std::vector<char> buffer(batch.size() * BUSTUB_PAGE_SIZE);
+  std::vector<std::pair<page_id_t, const char *>> writes;
+  writes.reserve(batch.size());
+  for (const auto &[page_id, frame_id, page] : batch) {
+    char *copy = buffer.data() + writes.size() * BUSTUB_PAGE_SIZE;
+    page->RLatch();
+    memcpy(copy, page->GetData(), BUSTUB_PAGE_SIZE);
+    page->RUnlatch();
+    writes.emplace_back(page_id, copy);
+  }
+  disk_manager_->WritePages(writes);
+  Count(BufferPoolEvent::BackgroundWrite, batch.size());
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (const auto &[page_id, frame_id, page] : batch) {
+    if (--page->pin_count_ == 0) {
+      OnUnpinned(frame_id);
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::GetStatistics() -> BufferPoolStats {
+  BufferPoolStats stats;
+  stats.fetch_hits_ = CountOf(BufferPoolEvent::FetchHit);
+  stats.fetch_misses_ = CountOf(BufferPoolEvent::FetchMiss);
+  stats.new_pages_ = CountOf(BufferPoolEvent::NewPage);
+  stats.evictions_ = CountOf(BufferPoolEvent::Eviction);
+  stats.foreground_writes_ = CountOf(BufferPoolEvent::ForegroundWrite);
+  stats.background_writes_ = CountOf(BufferPoolEvent::BackgroundWrite);
+  stats.no_free_frame_ = CountOf(BufferPoolEvent::NoFreeFrame);
+  stats.io_waits_ = CountOf(BufferPoolEvent::IoWait);
+  stats.disk_read_ns_ = CountOf(BufferPoolEvent::DiskReadNanos);
+  stats.victim_cache_hits_ = CountOf(BufferPoolEvent::VictimCacheHit);
+  stats.victim_cache_misses_ = CountOf(BufferPoolEvent::VictimCacheMiss);
+  stats.optimistic_reads_ = CountOf(BufferPoolEvent::OptimisticRead);
+  stats.optimistic_read_conflicts_ = CountOf(BufferPoolEvent::OptimisticReadConflict);
+  return stats;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  assert(page_id == INVALID_PAGE_ID || page_id % num_instances_ == instance_index_);
+}
 
 }  // namespace bustub
@@ -12,18 +12,99 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : entries_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (num_evictable_ == 0) {
+    return false;
+  }
+  // The first sweep clears every reference bit it passes, so the second one is guaranteed to find a victim.
+  while (true) {
+    auto &entry = entries_[hand_];
+    size_t current = hand_;
+    hand_ = (hand_ + 1) % entries_.size();
+    if (!entry.is_tracked_ || !entry.is_evictable_) {
+      continue;
+    }
+    if (entry.reference_) {
+      entry.reference_ = false;
+      continue;
+    }
+    entry = FrameEntry{};
+    num_evictable_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+}
+
+auto ClockReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Frames with a clear bit go in the order the hand reaches them, then the others in the order of the second sweep.
+  std::vector<frame_id_t> frames;
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < entries_.size() && frames.size() < max_frames; i++) {
+      size_t current = (hand_ + i) % entries_.size();
+      const auto &entry = entries_[current];
+      if (entry.is_tracked_ && entry.is_evictable_ && entry.reference_ == referenced) {
+        frames.push_back(static_cast<frame_id_t>(current));
+      }
+    }
+  }
+  return frames;
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  entry.is_tracked_ = true;
+  if (access_type != AccessType::Scan) {
+    entry.reference_ = true;
+  }
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (!entry.is_tracked_ || entry.is_evictable_ == set_evictable) {
+    return;
+  }
+  entry.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    num_evictable_++;
+  } else {
+    num_evictable_--;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+auto ClockReplacer::IsEvictable(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  return entries_[frame_id].is_evictable_;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= entries_.size() || !entries_[frame_id].is_tracked_) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  BUSTUB_ENSURE(entry.is_evictable_, "cannot remove a non-evictable frame");
+  entry = FrameEntry{};
+  num_evictable_--;
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_evictable_;
+}
 
 }  // namespace bustub
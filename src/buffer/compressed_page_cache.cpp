@@ -0,0 +1,244 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+/** Shortest back-reference the codec emits. */
+constexpr size_t MIN_MATCH = 4;
+/** Lengths that do not fit in the 4 bits of the token carry on in extra bytes. */
+constexpr size_t TOKEN_LENGTH_MAX = 15;
+constexpr size_t HASH_BITS = 12;
+
+auto Load32(const char *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Write the part of a length that does not fit in its half of the token: 255 until less is left, then the rest. */
+void WriteExtraLength(size_t length, char **out) {
+  length -= TOKEN_LENGTH_MAX;
+  while (length >= 255) {
+    *(*out)++ = static_cast<char>(255);
+    length -= 255;
+  }
+  *(*out)++ = static_cast<char>(length);
+}
+
+/** Write a run of literals followed by a back-reference. The last sequence of a page has no back-reference. */
+void WriteSequence(const char *literals, size_t num_literals, size_t offset, size_t match_length, char **out) {
+  char *token = (*out)++;
+  auto token_value = static_cast<uint8_t>(std::min(num_literals, TOKEN_LENGTH_MAX) << 4);
+  if (num_literals >= TOKEN_LENGTH_MAX) {
+    WriteExtraLength(num_literals, out);
+  }
+  memcpy(*out, literals, num_literals);
+  *out += num_literals;
+  if (match_length > 0) {
+    size_t length = match_length - MIN_MATCH;
+    token_value |= static_cast<uint8_t>(std::min(length, TOKEN_LENGTH_MAX));
+    *(*out)++ = static_cast<char>(offset & 0xff);
+    *(*out)++ = static_cast<char>(offset >> 8);
+    if (length >= TOKEN_LENGTH_MAX) {
+      WriteExtraLength(length, out);
+    }
+  }
+  *token = static_cast<char>(token_value);
+}
+
+}  // namespace
+
+auto CompressPage(const char *page, char *out) -> size_t {
+  // Last position at which each hashed 4-byte sequence was seen.
+  int32_t table[1 << HASH_BITS];
+  std::fill(std::begin(table), std::end(table), -1);
+  char *out_begin = out;
+  size_t anchor = 0;
+  size_t i = 0;
+  while (i + MIN_MATCH <= BUSTUB_PAGE_SIZE) {
+    uint32_t sequence = Load32(page + i);
+    size_t hash = Hash(sequence);
+    int32_t candidate = table[hash];
+    table[hash] = static_cast<int32_t>(i);
+    if (candidate < 0 || Load32(page + candidate) != sequence) {
+      i++;
+      continue;
+    }
+    // The match may overlap the bytes it copies, which is how runs of a repeated byte are encoded.
+    auto ref = static_cast<size_t>(candidate);
+    size_t match_length = MIN_MATCH;
+    while (i + match_length < BUSTUB_PAGE_SIZE && page[ref + match_length] == page[i + match_length]) {
+      match_length++;
+    }
+    WriteSequence(page + anchor, i - anchor, i - ref, match_length, &out);
+    i += match_length;
+    anchor = i;
+  }
+  WriteSequence(page + anchor, BUSTUB_PAGE_SIZE - anchor, 0, 0, &out);
+  return out - out_begin;
+}
+
+auto DecompressPage(const char *in, size_t size, char *page) -> bool {
+  const auto *src = reinterpret_cast<const uint8_t *>(in);
+  size_t ip = 0;
+  size_t op = 0;
+  auto read_extra_length = [src, size, &ip](size_t *length) {
+    if (*length != TOKEN_LENGTH_MAX) {
+      return true;
+    }
+    uint8_t byte;
+    do {
+      if (ip >= size) {
+        return false;
+      }
+      byte = src[ip++];
+      *length += byte;
+    } while (byte == 255);
+    return true;
+  };
+
+  while (ip < size) {
+    uint8_t token = src[ip++];
+    size_t num_literals = token >> 4;
+    if (!read_extra_length(&num_literals) || num_literals > size - ip || num_literals > BUSTUB_PAGE_SIZE - op) {
+      return false;
+    }
+    memcpy(page + op, in + ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == size) {
+      break;
+    }
+
+    if (size - ip < 2) {
+      return false;
+    }
+    size_t offset = src[ip] | (static_cast<size_t>(src[ip + 1]) << 8);
+    ip += 2;
+    size_t match_length = token & 0xf;
+    if (!read_extra_length(&match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || match_length > BUSTUB_PAGE_SIZE - op) {
+      return false;
+    }
+    if (offset >= match_length) {
+      memcpy(page + op, page + op - offset, match_length);
+    } else if (offset == 1) {
+      memset(page + op, page[op - 1], match_length);
+    } else {
+      // Byte by byte, since the source of an overlapping match is written as it is read.
+      for (size_t end = op + match_length; op < end; op++) {
+        page[op] = page[op - offset];
+      }
+      continue;
+    }
+    op += match_length;
+  }
+  return op == BUSTUB_PAGE_SIZE;
+}
+
+CompressedPageCache::CompressedPageCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+void CompressedPageCache::Insert(page_id_t page_id, const char *page_data) {
+  // Compress before taking the latch. Pages that do not compress are kept as they are.
+  char buffer[MAX_COMPRESSED_PAGE_SIZE];
+  size_t size = CompressPage(page_data, buffer);
+  const char *data = buffer;
+  if (size >= static_cast<size_t>(BUSTUB_PAGE_SIZE)) {
+    size = BUSTUB_PAGE_SIZE;
+    data = page_data;
+  }
+  if (size > capacity_bytes_) {
+    Erase(page_id);
+    return;
+  }
+  std::shared_ptr<char[]> copy(new char[size]);
+  memcpy(copy.get(), data, size);
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (auto it = entries_.find(page_id); it != entries_.end()) {
+    EraseEntry(it);
+  }
+  while (used_bytes_ + size > capacity_bytes_) {
+    EraseEntry(entries_.find(order_.front()));
+  }
+  used_bytes_ += size;
+  entries_.emplace(page_id, Entry{std::move(copy), size, order_.insert(order_.end(), page_id)});
+}
+
+auto CompressedPageCache::Lookup(page_id_t page_id, char *page_data) -> bool {
+  // Hold on to the copy, so that it can be decompressed without the latch even if it is dropped meanwhile.
+  std::shared_ptr<char[]> data;
+  size_t size;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto it = entries_.find(page_id);
+    if (it == entries_.end()) {
+      return false;
+    }
+    data = it->second.data_;
+    size = it->second.size_;
+    order_.splice(order_.end(), order_, it->second.order_it_);
+  }
+  if (size == static_cast<size_t>(BUSTUB_PAGE_SIZE)) {
+    memcpy(page_data, data.get(), size);
+    return true;
+  }
+  return DecompressPage(data.get(), size, page_data);
+}
+
+auto CompressedPageCache::Touch(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) {
+    return false;
+  }
+  order_.splice(order_.end(), order_, it->second.order_it_);
+  return true;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (auto it = entries_.find(page_id); it != entries_.end()) {
+    EraseEntry(it);
+  }
+}
+
+auto CompressedPageCache::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return entries_.size();
+}
+
+auto CompressedPageCache::GetUsedBytes() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return used_bytes_;
+}
+
+void CompressedPageCache::EraseEntry(std::unordered_map<page_id_t, Entry>::iterator it) {
+  used_bytes_ -= it->second.size_;
+  order_.erase(it->second.order_it_);
+  entries_.erase(it);
+}
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_worker_pool.cpp
+//
+// Identification: src/buffer/io_worker_pool.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/io_worker_pool.h"
+
+#include <utility>
+
+namespace bustub {
+
+IoWorkerPool::IoWorkerPool(size_t num_threads, size_t max_queued) : max_queued_(max_queued) {
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&IoWorkerPool::Run, this);
+  }
+}
+
+IoWorkerPool::~IoWorkerPool() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+    tasks_.clear();
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+auto IoWorkerPool::Submit(std::function<void()> task) -> bool {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (stop_ || tasks_.size() >= max_queued_) {
+      return false;
+    }
+    tasks_.emplace_back(std::move(task));
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void IoWorkerPool::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (stop_) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace bustub
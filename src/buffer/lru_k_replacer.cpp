@@ -14,16 +14,113 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k), entries_(num_frames) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool { return false; }
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evictable_.empty()) {
+    return false;
+  }
+  *frame_id = std::get<2>(*evictable_.begin());
+  evictable_.erase(evictable_.begin());
+  ResetEntry(&entries_[*frame_id]);
+  return true;
+}
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id) {}
+auto LRUKReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames;
+  for (auto it = evictable_.begin(); it != evictable_.end() && frames.size() < max_frames; ++it) {
+    frames.push_back(std::get<2>(*it));
+  }
+  return frames;
+}
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {}
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < replacer_size_, "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (access_type == AccessType::Scan && entry.count_ > 0) {
+    return;
+  }
+  if (entry.is_evictable_) {
+    evictable_.erase(KeyOf(frame_id));
+  }
+  if (access_type == AccessType::Scan) {
+    entry.is_scan_only_ = true;
+  } else if (entry.is_scan_only_) {
+    entry.is_scan_only_ = false;
+    entry.count_ = 0;
+  }
+  PushTimestamp(&entry, current_timestamp_++);
+  if (entry.is_evictable_) {
+    evictable_.insert(KeyOf(frame_id));
+  }
+}
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {}
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < replacer_size_, "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (entry.count_ == 0 || entry.is_evictable_ == set_evictable) {
+    return;
+  }
+  entry.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    evictable_.insert(KeyOf(frame_id));
+  } else {
+    evictable_.erase(KeyOf(frame_id));
+  }
+}
 
-auto LRUKReplacer::Size() -> size_t { return 0; }
+auto LRUKReplacer::IsEvictable(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < replacer_size_, "frame id is larger than the replacer size");
+  return entries_[frame_id].is_evictable_;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_ || entries_[frame_id].count_ == 0) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  BUSTUB_ENSURE(entry.is_evictable_, "cannot remove a non-evictable frame");
+  evictable_.erase(KeyOf(frame_id));
+  ResetEntry(&entry);
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return evictable_.size();
+}
+
+auto LRUKReplacer::KeyOf(frame_id_t frame_id) const -> EvictionKey {
+  const auto &entry = entries_[frame_id];
+  int frame_class = entry.is_scan_only_ ? 0 : (entry.count_ < k_ ? 1 : 2);
+  return {frame_class, entry.history_[entry.head_], frame_id};
+}
+
+void LRUKReplacer::PushTimestamp(FrameEntry *entry, size_t timestamp) {
+  if (entry->history_.empty()) {
+    entry->history_.resize(k_);
+  }
+  if (entry->count_ < k_) {
+    entry->history_[(entry->head_ + entry->count_) % k_] = timestamp;
+    entry->count_++;
+  } else {
+    entry->history_[entry->head_] = timestamp;
+    entry->head_ = (entry->head_ + 1) % k_;
+  }
+}
+
+void LRUKReplacer::ResetEntry(FrameEntry *entry) {
+  entry->head_ = 0;
+  entry->count_ = 0;
+  entry->is_evictable_ = false;
+  entry->is_scan_only_ = false;
+}
 
 }  // namespace bustub
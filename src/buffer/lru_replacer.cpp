@@ -12,18 +12,75 @@
 
 #include "buffer/lru_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : entries_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (!queue_.Front(frame_id)) {
+    return false;
+  }
+  auto &entry = entries_[*frame_id];
+  queue_.Erase(*frame_id, entry.timestamp_, true);
+  entry = FrameEntry{};
+  return true;
+}
+
+auto LRUReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames;
+  queue_.AppendEvictable(&frames, max_frames);
+  return frames;
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (entry.is_tracked_) {
+    queue_.Erase(frame_id, entry.timestamp_, entry.is_evictable_);
+  }
+  entry.is_tracked_ = true;
+  entry.timestamp_ = current_timestamp_++;
+  queue_.Push(frame_id, entry.timestamp_, entry.is_evictable_);
+}
+
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (!entry.is_tracked_ || entry.is_evictable_ == set_evictable) {
+    return;
+  }
+  entry.is_evictable_ = set_evictable;
+  queue_.SetEvictable(frame_id, entry.timestamp_, set_evictable);
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+auto LRUReplacer::IsEvictable(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  return entries_[frame_id].is_evictable_;
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= entries_.size() || !entries_[frame_id].is_tracked_) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  BUSTUB_ENSURE(entry.is_evictable_, "cannot remove a non-evictable frame");
+  queue_.Erase(frame_id, entry.timestamp_, true);
+  entry = FrameEntry{};
+}
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return queue_.NumEvictable();
+}
 
 }  // namespace bustub
@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  if (bpm_free_page_map) {
+    free_page_map_ = std::make_unique<FreePageMap>(disk_manager, static_cast<uint32_t>(num_instances));
+  }
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_type, free_page_map_.get()));
+  }
+}
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+auto ParallelBufferPoolManager::Resize(size_t pool_size) -> bool {
+  size_t num_instances = instances_.size();
+  if (pool_size < num_instances) {
+    return false;
+  }
+  std::vector<size_t> old_sizes;
+  old_sizes.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    old_sizes.push_back(instances_[i]->GetPoolSize());
+    if (!instances_[i]->Resize(pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0))) {
+      // Put the instances resized so far back, so that the pool is not left half resized.
+      for (size_t j = 0; j < i; j++) {
+        instances_[j]->Resize(old_sizes[j]);
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParallelBufferPoolManager::StartBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StartBackgroundWriter();
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> per_instance(instances_.size());
+  for (page_id_t page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      per_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+    }
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!per_instance[i].empty()) {
+      instances_[i]->PrefetchPages(per_instance[i]);
+    }
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchChain(page_id_t first_page_id, size_t distance, next_page_fn next_page) {
+  if (first_page_id == INVALID_PAGE_ID || distance == 0) {
+    return;
+  }
+  std::call_once(io_pool_once_,
+                 [this] { io_pool_ = std::make_unique<IoWorkerPool>(BPM_IO_WORKERS, BPM_IO_QUEUE_SIZE); });
+  io_pool_->Submit([this, first_page_id, distance, next_page = std::move(next_page)] {
+    ReadChain(first_page_id, distance, next_page);
+  });
+}
+
+auto ParallelBufferPoolManager::GetStatistics() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetStatistics();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::ResetStatistics() {
+  for (auto &instance : instances_) {
+    instance->ResetStatistics();
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::OptimisticReadPgImp(page_id_t page_id, const read_page_fn &read) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->OptimisticReadPage(page_id, read);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  std::vector<std::vector<page_id_t>> per_instance(instances_.size());
+  for (page_id_t page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      per_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+    }
+  }
+  std::vector<std::vector<Page *>> fetched(instances_.size());
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!per_instance[i].empty()) {
+      fetched[i] = instances_[i]->FetchPages(per_instance[i], access_type);
+    }
+  }
+  // Each instance returns its pages in the order it was given them, so walking the batch again lines them back up.
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  std::vector<size_t> next(instances_.size(), 0);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    if (page_ids[i] != INVALID_PAGE_ID) {
+      size_t instance = static_cast<size_t>(page_ids[i]) % instances_.size();
+      pages[i] = fetched[instance][next[instance]++];
+    }
+  }
+  return pages;
+}
+
+auto ParallelBufferPoolManager::UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> bool {
+  std::vector<std::vector<page_id_t>> per_instance(instances_.size());
+  for (page_id_t page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      per_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+    }
+  }
+  bool unpinned = true;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!per_instance[i].empty()) {
+      unpinned = instances_[i]->UnpinPages(per_instance[i], is_dirty) && unpinned;
+    }
+  }
+  return unpinned;
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::FlushPgsImp(const std::vector<page_id_t> &page_ids) -> bool {
+  std::vector<std::vector<page_id_t>> per_instance(instances_.size());
+  bool flushed = true;
+  for (page_id_t page_id : page_ids) {
+    if (page_id == INVALID_PAGE_ID) {
+      flushed = false;
+      continue;
+    }
+    per_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!per_instance[i].empty()) {
+      flushed = instances_[i]->FlushPages(per_instance[i]) && flushed;
+    }
+  }
+  return flushed;
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  size_t num_instances = instances_.size();
+  size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  *page_id = INVALID_PAGE_ID;
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  RunFlushHooks();
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tiny_lfu_replacer.cpp
+//
+// Identification: src/buffer/tiny_lfu_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/tiny_lfu_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+FrequencySketch::FrequencySketch(size_t capacity) {
+  size_t width = 16;
+  while (width < capacity) {
+    width <<= 1;
+  }
+  width_mask_ = width - 1;
+  sample_size_ = 10 * width;
+  counters_.resize(NUM_ROWS * width, 0);
+}
+
+void FrequencySketch::Increment(page_id_t page_id) {
+  for (size_t row = 0; row < NUM_ROWS; row++) {
+    auto &counter = counters_[IndexOf(page_id, row)];
+    if (counter < MAX_COUNT) {
+      counter++;
+    }
+  }
+  if (++additions_ >= sample_size_) {
+    Reset();
+  }
+}
+
+auto FrequencySketch::Estimate(page_id_t page_id) const -> uint32_t {
+  uint32_t estimate = MAX_COUNT;
+  for (size_t row = 0; row < NUM_ROWS; row++) {
+    estimate = std::min<uint32_t>(estimate, counters_[IndexOf(page_id, row)]);
+  }
+  return estimate;
+}
+
+auto FrequencySketch::IndexOf(page_id_t page_id, size_t row) const -> size_t {
+  // The finalizer of MurmurHash3, seeded differently for every row so that the rows collide independently.
+  auto hash = static_cast<uint64_t>(static_cast<uint32_t>(page_id)) + (row + 1) * 0x9e3779b97f4a7c15ULL;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return row * (width_mask_ + 1) + (hash & width_mask_);
+}
+
+void FrequencySketch::Reset() {
+  for (auto &counter : counters_) {
+    counter >>= 1;
+  }
+  additions_ /= 2;
+}
+
+TinyLFUReplacer::TinyLFUReplacer(size_t num_frames)
+    : window_capacity_(std::max<size_t>(1, num_frames / 100)),
+      protected_capacity_(std::max<size_t>(1, (num_frames - std::min(num_frames, window_capacity_)) * 4 / 5)),
+      entries_(num_frames),
+      sketch_(num_frames) {}
+
+auto TinyLFUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t candidate;
+  frame_id_t victim;
+  bool has_candidate = window_.Front(&candidate);
+  bool has_victim = probation_.Front(&victim) || protected_.Front(&victim);
+  if (!has_candidate && !has_victim) {
+    return false;
+  }
+
+  if (has_candidate && has_victim) {
+    if (window_.Size() < window_capacity_) {
+      // The window has room for the page about to be loaded, so the main area gives up a frame.
+      has_candidate = false;
+    } else if (FrequencyOf(candidate) > FrequencyOf(victim)) {
+      // The candidate is admitted into the main area and the victim makes room for the page about to be loaded.
+      MoveTo(candidate, ListId::Probation);
+      has_candidate = false;
+    }
+  }
+
+  *frame_id = has_candidate ? candidate : victim;
+  auto &entry = entries_[*frame_id];
+  QueueOf(entry.list_).Erase(*frame_id, entry.timestamp_, true);
+  entry = FrameEntry{};
+  return true;
+}
+
+auto TinyLFUReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // The duels are not decided in advance, so this lists the frames that are likely to lose them.
+  std::vector<frame_id_t> frames;
+  probation_.AppendEvictable(&frames, max_frames);
+  window_.AppendEvictable(&frames, max_frames);
+  protected_.AppendEvictable(&frames, max_frames);
+  return frames;
+}
+
+void TinyLFUReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  bool is_scan = access_type == AccessType::Scan;
+  if (page_id != INVALID_PAGE_ID) {
+    entry.page_id_ = page_id;
+    if (!is_scan) {
+      sketch_.Increment(page_id);
+    }
+  }
+
+  switch (entry.list_) {
+    case ListId::None: {
+      MoveTo(frame_id, ListId::Window);
+      // While the pool is still filling up nothing is evicted, so pages leave the window for probation without a duel.
+      frame_id_t overflow;
+      while (window_.Size() > window_capacity_ && window_.Front(&overflow)) {
+        MoveTo(overflow, ListId::Probation);
+      }
+      break;
+    }
+    case ListId::Window:
+      if (!is_scan) {
+        MoveTo(frame_id, ListId::Window);
+      }
+      break;
+    case ListId::Probation:
+    case ListId::Protected: {
+      if (is_scan) {
+        break;
+      }
+      MoveTo(frame_id, ListId::Protected);
+      frame_id_t demoted;
+      if (protected_.Size() > protected_capacity_ && protected_.Front(&demoted) && demoted != frame_id) {
+        MoveTo(demoted, ListId::Probation);
+      }
+      break;
+    }
+  }
+}
+
+void TinyLFUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (entry.list_ == ListId::None || entry.is_evictable_ == set_evictable) {
+    return;
+  }
+  entry.is_evictable_ = set_evictable;
+  QueueOf(entry.list_).SetEvictable(frame_id, entry.timestamp_, set_evictable);
+}
+
+auto TinyLFUReplacer::IsEvictable(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  return entries_[frame_id].is_evictable_;
+}
+
+void TinyLFUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= entries_.size() || entries_[frame_id].list_ == ListId::None) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  BUSTUB_ENSURE(entry.is_evictable_, "cannot remove a non-evictable frame");
+  QueueOf(entry.list_).Erase(frame_id, entry.timestamp_, true);
+  entry = FrameEntry{};
+}
+
+auto TinyLFUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return window_.NumEvictable() + probation_.NumEvictable() + protected_.NumEvictable();
+}
+
+auto TinyLFUReplacer::QueueOf(ListId list) -> FrameQueue & {
+  switch (list) {
+    case ListId::Window:
+      return window_;
+    case ListId::Probation:
+      return probation_;
+    default:
+      return protected_;
+  }
+}
+
+void TinyLFUReplacer::MoveTo(frame_id_t frame_id, ListId list) {
+  auto &entry = entries_[frame_id];
+  if (entry.list_ != ListId::None) {
+    QueueOf(entry.list_).Erase(frame_id, entry.timestamp_, entry.is_evictable_);
+  }
+  entry.list_ = list;
+  entry.timestamp_ = current_timestamp_++;
+  QueueOf(list).Push(frame_id, entry.timestamp_, entry.is_evictable_);
+}
+
+auto TinyLFUReplacer::FrequencyOf(frame_id_t frame_id) const -> uint32_t {
+  page_id_t page_id = entries_[frame_id].page_id_;
+  return page_id == INVALID_PAGE_ID ? 0 : sketch_.Estimate(page_id);
+}
+
+}  // namespace bustub
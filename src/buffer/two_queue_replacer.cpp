@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : kin_(std::max<size_t>(1, num_frames / 4)), kout_(std::max<size_t>(1, num_frames / 2)), entries_(num_frames) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  ListId list = VictimList();
+  if (list == ListId::None) {
+    return false;
+  }
+  QueueOf(list).Front(frame_id);
+  auto &entry = entries_[*frame_id];
+  QueueOf(list).Erase(*frame_id, entry.timestamp_, true);
+  if (list == ListId::In && entry.page_id_ != INVALID_PAGE_ID && !entry.is_scan_only_) {
+    a1out_.Push(entry.page_id_);
+    if (a1out_.Size() > kout_) {
+      a1out_.PopFront();
+    }
+  }
+  entry = FrameEntry{};
+  return true;
+}
+
+auto TwoQueueReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames;
+  ListId list = VictimList();
+  if (list == ListId::None) {
+    return frames;
+  }
+  QueueOf(list).AppendEvictable(&frames, max_frames);
+  QueueOf(list == ListId::In ? ListId::Main : ListId::In).AppendEvictable(&frames, max_frames);
+  return frames;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  bool is_scan = access_type == AccessType::Scan;
+  if (page_id != INVALID_PAGE_ID) {
+    entry.page_id_ = page_id;
+  }
+
+  if (entry.list_ == ListId::Main) {
+    if (!is_scan) {
+      MoveTo(frame_id, ListId::Main);
+    }
+    return;
+  }
+  if (entry.list_ == ListId::In) {
+    if (!is_scan) {
+      entry.is_scan_only_ = false;
+    }
+    return;
+  }
+
+  if (!is_scan && page_id != INVALID_PAGE_ID && a1out_.Erase(page_id)) {
+    MoveTo(frame_id, ListId::Main);
+    return;
+  }
+  entry.is_scan_only_ = is_scan;
+  MoveTo(frame_id, ListId::In);
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  auto &entry = entries_[frame_id];
+  if (entry.list_ == ListId::None || entry.is_evictable_ == set_evictable) {
+    return;
+  }
+  entry.is_evictable_ = set_evictable;
+  QueueOf(entry.list_).SetEvictable(frame_id, entry.timestamp_, set_evictable);
+}
+
+auto TwoQueueReplacer::IsEvictable(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < entries_.size(), "frame id is larger than the replacer size");
+  return entries_[frame_id].is_evictable_;
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= entries_.size() || entries_[frame_id].list_ == ListId::None) {
+    return;
+  }
+  auto &entry = entries_[frame_id];
+  BUSTUB_ENSURE(entry.is_evictable_, "cannot remove a non-evictable frame");
+  QueueOf(entry.list_).Erase(frame_id, entry.timestamp_, true);
+  entry = FrameEntry{};
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return a1in_.NumEvictable() + am_.NumEvictable();
+}
+
+void TwoQueueReplacer::MoveTo(frame_id_t frame_id, ListId list) {
+  auto &entry = entries_[frame_id];
+  if (entry.list_ != ListId::None) {
+    QueueOf(entry.list_).Erase(frame_id, entry.timestamp_, entry.is_evictable_);
+  }
+  entry.list_ = list;
+  entry.timestamp_ = current_timestamp_++;
+  QueueOf(list).Push(frame_id, entry.timestamp_, entry.is_evictable_);
+}
+
+auto TwoQueueReplacer::VictimList() const -> ListId {
+  bool in_evictable = a1in_.NumEvictable() > 0;
+  bool main_evictable = am_.NumEvictable() > 0;
+  if (in_evictable && (a1in_.Size() > kin_ || !main_evictable)) {
+    return ListId::In;
+  }
+  if (main_evictable) {
+    return ListId::Main;
+  }
+  return ListId::None;
+}
+
+}  // namespace bustub
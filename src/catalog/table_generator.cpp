@@ -63,24 +63,37 @@ auto TableGenerator::MakeValues(ColumnInsertMeta *col_meta, uint32_t count) -> s
 
 void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
   uint32_t num_inserted = 0;
-  uint32_t batch_size = 128;
+  // Large tables are appended in bulk, a batch of fresh pages at a time.
+  bool bulk_insert = table_meta->num_rows_ >= bulk_insert_threshold;
+  uint32_t batch_size = bulk_insert ? static_cast<uint32_t>(bulk_insert_threshold) : 128;
   while (num_inserted < table_meta->num_rows_) {
     std::vector<std::vector<Value>> values;
     uint32_t num_values = std::min(batch_size, table_meta->num_rows_ - num_inserted);
     for (auto &col_meta : table_meta->col_meta_) {
       values.emplace_back(MakeValues(&col_meta, num_values));
     }
+    std::vector<Tuple> tuples;
+    tuples.reserve(num_values);
     for (uint32_t i = 0; i < num_values; i++) {
       std::vector<Value> entry;
       entry.reserve(values.size());
       for (const auto &col : values) {
         entry.emplace_back(col[i]);
       }
-      RID rid;
-      bool inserted = info->table_->InsertTuple(Tuple(entry, &info->schema_), &rid, exec_ctx_->GetTransaction());
+      tuples.emplace_back(entry, &info->schema_);
+    }
+    if (bulk_insert) {
+      std::vector<RID> rids;
+      bool inserted = info->table_->BulkInsertTuples(tuples, &rids, exec_ctx_->GetTransaction());
       BUSTUB_ENSURE(inserted, "Sequential insertion cannot fail");
-      num_inserted++;
+    } else {
+      for (const auto &tuple : tuples) {
+        RID rid;
+        bool inserted = info->table_->InsertTuple(tuple, &rid, exec_ctx_->GetTransaction());
+        BUSTUB_ENSURE(inserted, "Sequential insertion cannot fail");
+      }
     }
+    num_inserted += num_values;
   }
 }
 
@@ -1,3 +1,4 @@
+#include <charconv>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -12,6 +13,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -33,6 +35,7 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_vacuum.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -41,7 +44,33 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<Ex
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+void BustubInstance::MakeBufferPoolManager(size_t num_bpm_instances, bool background_writer) {
+  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
+  // buffer pool size specified in `config.h`. With several instances the frames are split evenly among them.
+  const size_t total_frames = 128;
+  try {
+    if (num_bpm_instances > 1) {
+      size_t frames_per_instance = (total_frames + num_bpm_instances - 1) / num_bpm_instances;
+      auto *bpm = new ParallelBufferPoolManager(num_bpm_instances, frames_per_instance, disk_manager_,
+                                                LRUK_REPLACER_K, log_manager_);
+      if (background_writer) {
+        bpm->StartBackgroundWriter();
+      }
+      buffer_pool_manager_ = bpm;
+    } else {
+      auto *bpm = new BufferPoolManagerInstance(total_frames, disk_manager_, LRUK_REPLACER_K, log_manager_);
+      if (background_writer) {
+        bpm->StartBackgroundWriter();
+      }
+      buffer_pool_manager_ = bpm;
+    }
+  } catch (NotImplementedException &e) {
+    std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
+    buffer_pool_manager_ = nullptr;
+  }
+}
+
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t num_bpm_instances) {
   enable_logging = false;
 
   // Storage related.
@@ -50,14 +79,8 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
-  try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
-  } catch (NotImplementedException &e) {
-    std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
-    buffer_pool_manager_ = nullptr;
-  }
+  // Writes go to a real file, so let a background writer keep clean frames ready for eviction.
+  MakeBufferPoolManager(num_bpm_instances, true);
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -73,7 +96,18 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+auto BustubInstance::StartTableVacuum() -> bool {
+  if (buffer_pool_manager_ == nullptr) {
+    return false;
+  }
+  if (table_vacuum_ == nullptr) {
+    table_vacuum_ = new TableVacuum(catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, &catalog_lock_);
+  }
+  table_vacuum_->Start();
+  return true;
+}
+
+BustubInstance::BustubInstance(size_t num_bpm_instances) {
   enable_logging = false;
 
   // Storage related.
@@ -82,14 +116,7 @@ BustubInstance::BustubInstance() {
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
-  try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
-  } catch (NotImplementedException &e) {
-    std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
-    buffer_pool_manager_ = nullptr;
-  }
+  MakeBufferPoolManager(num_bpm_instances, false);
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -154,11 +181,69 @@ void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer)
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayBufferPool(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    WriteOneCell("The buffer pool is not available.", writer);
+    return;
+  }
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto *column : {"instance", "frames", "hits", "misses", "hit_ratio", "new_pages", "evictions",
+                             "foreground_writes", "background_writes", "no_free_frame", "io_waits", "disk_read_ms",
+                             "victim_hits", "victim_misses", "optimistic_reads", "optimistic_conflicts"}) {
+    writer.WriteHeaderCell(column);
+  }
+  writer.EndHeader();
+  auto write_row = [&writer](const std::string &instance, size_t frames, const BufferPoolStats &stats) {
+    writer.BeginRow();
+    writer.WriteCell(instance);
+    writer.WriteCell(fmt::format("{}", frames));
+    writer.WriteCell(fmt::format("{}", stats.fetch_hits_));
+    writer.WriteCell(fmt::format("{}", stats.fetch_misses_));
+    writer.WriteCell(fmt::format("{:.4f}", stats.HitRatio()));
+    writer.WriteCell(fmt::format("{}", stats.new_pages_));
+    writer.WriteCell(fmt::format("{}", stats.evictions_));
+    writer.WriteCell(fmt::format("{}", stats.foreground_writes_));
+    writer.WriteCell(fmt::format("{}", stats.background_writes_));
+    writer.WriteCell(fmt::format("{}", stats.no_free_frame_));
+    writer.WriteCell(fmt::format("{}", stats.io_waits_));
+    writer.WriteCell(fmt::format("{:.3f}", static_cast<double>(stats.disk_read_ns_) / 1e6));
+    writer.WriteCell(fmt::format("{}", stats.victim_cache_hits_));
+    writer.WriteCell(fmt::format("{}", stats.victim_cache_misses_));
+    writer.WriteCell(fmt::format("{}", stats.optimistic_reads_));
+    writer.WriteCell(fmt::format("{}", stats.optimistic_read_conflicts_));
+    writer.EndRow();
+  };
+  if (auto *parallel_bpm = dynamic_cast<ParallelBufferPoolManager *>(buffer_pool_manager_); parallel_bpm != nullptr) {
+    for (size_t i = 0; i < parallel_bpm->GetNumInstances(); i++) {
+      write_row(fmt::format("{}", i), parallel_bpm->GetInstancePoolSize(i), parallel_bpm->GetInstanceStatistics(i));
+    }
+  }
+  write_row("total", buffer_pool_manager_->GetPoolSize(), buffer_pool_manager_->GetStatistics());
+  writer.EndTable();
+}
+
+void BustubInstance::SetBufferPoolSize(const std::string &value) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("The buffer pool is not available.");
+  }
+  size_t pool_size = 0;
+  auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), pool_size);
+  if (ec != std::errc() || end != value.data() + value.size()) {
+    throw Exception(fmt::format("invalid buffer_pool_size: {}", value));
+  }
+  if (!buffer_pool_manager_->Resize(pool_size)) {
+    throw Exception(fmt::format("cannot resize the buffer pool to {} frames, it is too small or its pages are in use",
+                                pool_size));
+  }
+}
+
 void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
   std::string help = R"(Welcome to the BusTub shell!
 
 \dt: show all tables
 \di: show all indices
+\dbp: show buffer pool statistics
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -191,6 +276,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayIndices(writer);
       return true;
     }
+    if (sql == "\\dbp") {
+      CmdDisplayBufferPool(writer);
+      return true;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return true;
@@ -212,7 +301,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        auto info =
+            catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_), true, create_stmt.format_);
         l.unlock();
 
         if (info == nullptr) {
@@ -257,6 +347,9 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       }
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+        if (set_stmt.variable_ == "buffer_pool_size") {
+          SetBufferPoolSize(set_stmt.value_);
+        }
         session_variables_[set_stmt.variable_] = set_stmt.value_;
         continue;
       }
@@ -360,7 +453,7 @@ void BustubInstance::GenerateTestTable() {
   auto exec_ctx = MakeExecutorContext(txn);
   TableGenerator gen{exec_ctx.get()};
 
-  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  std::unique_lock<std::shared_mutex> l(catalog_lock_);
   gen.GenerateTestTables();
   l.unlock();
 
@@ -377,7 +470,7 @@ void BustubInstance::GenerateMockTable() {
   // The actual content generated by mock scan executors are described in `mock_scan_executor.cpp`.
   auto txn = txn_manager_->Begin();
 
-  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  std::unique_lock<std::shared_mutex> l(catalog_lock_);
   for (auto table_name = &mock_table_list[0]; *table_name != nullptr; table_name++) {
     catalog_->CreateTable(txn, *table_name, GetMockTableSchemaOf(*table_name), false);
   }
@@ -391,6 +484,7 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  delete table_vacuum_;
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
@@ -20,4 +20,28 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds bpm_writer_interval = std::chrono::milliseconds(10);
+
+double bpm_writer_dirty_ratio = 0.1;
+
+size_t bpm_writer_batch_size = 32;
+
+size_t bpm_victim_cache_bytes = 0;
+
+std::chrono::milliseconds bpm_resize_timeout = std::chrono::milliseconds(1000);
+
+bool bpm_free_page_map = false;
+
+size_t disk_extent_pages = 64;
+
+size_t scan_read_ahead_distance = 4;
+
+size_t bulk_insert_threshold = 1000;
+
+std::chrono::milliseconds vacuum_interval = std::chrono::milliseconds(100);
+
+size_t vacuum_batch_pages = 64;
+
+double vacuum_merge_fill_ratio = 0.5;
+
 }  // namespace bustub
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.cpp
+//
+// Identification: src/container/hash/concurrent_page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/concurrent_page_table.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+auto NextPowerOfTwo(size_t n) -> size_t {
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+}  // namespace
+
+ConcurrentPageTable::SlotArray::SlotArray(size_t num_slots)
+    : mask_(num_slots - 1), slots_(new std::atomic<uint64_t>[num_slots]) {
+  for (size_t i = 0; i < num_slots; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+ConcurrentPageTable::ConcurrentPageTable(size_t capacity) {
+  // Aim for at least 64 entries per segment, so that small pools do not pay for many nearly empty segments.
+  num_segments_ = 1;
+  while (num_segments_ < MAX_SEGMENTS && 64 * 2 * num_segments_ <= capacity) {
+    num_segments_ <<= 1;
+  }
+  // Keep the load factor at or below one half.
+  size_t slots_per_segment = std::max(MIN_SEGMENT_SLOTS, NextPowerOfTwo(2 * (capacity / num_segments_ + 1)));
+  segments_ = std::make_unique<Segment[]>(num_segments_);
+  for (size_t i = 0; i < num_segments_; i++) {
+    segments_[i].arrays_.emplace_back(std::make_unique<SlotArray>(slots_per_segment));
+    segments_[i].array_.store(segments_[i].arrays_.back().get(), std::memory_order_release);
+  }
+}
+
+auto ConcurrentPageTable::Hash(page_id_t page_id) -> uint64_t {
+  // The finalizer of MurmurHash3. Page ids are dense and strided, so they need mixing before they are split into a
+  // segment number and a slot number.
+  auto hash = static_cast<uint64_t>(static_cast<uint32_t>(page_id));
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+auto ConcurrentPageTable::Find(page_id_t page_id, frame_id_t &frame_id) const -> bool {
+  uint64_t hash = Hash(page_id);
+  const Segment &segment = SegmentOf(hash);
+  while (true) {
+    uint64_t version = segment.version_.load(std::memory_order_acquire);
+    if ((version & 1) != 0) {
+      continue;
+    }
+    const SlotArray *array = segment.array_.load(std::memory_order_acquire);
+    bool found = false;
+    frame_id_t value = 0;
+    for (size_t probe = 0, i = hash & array->mask_; probe <= array->mask_; probe++, i = (i + 1) & array->mask_) {
+      uint64_t slot = array->slots_[i].load(std::memory_order_relaxed);
+      if (slot == EMPTY_SLOT) {
+        break;
+      }
+      if (KeyOf(slot) == page_id) {
+        found = true;
+        value = ValueOf(slot);
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (segment.version_.load(std::memory_order_relaxed) == version) {
+      if (found) {
+        frame_id = value;
+      }
+      return found;
+    }
+  }
+}
+
+void ConcurrentPageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot insert an invalid page id");
+  uint64_t hash = Hash(page_id);
+  Segment &segment = SegmentOf(hash);
+  std::scoped_lock<std::mutex> lock(segment.latch_);
+  if (2 * (segment.size_.load(std::memory_order_relaxed) + 1) > segment.arrays_.back()->mask_ + 1) {
+    Grow(&segment);
+  }
+
+  SlotArray *array = segment.arrays_.back().get();
+  size_t i = hash & array->mask_;
+  while (true) {
+    uint64_t slot = array->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT || KeyOf(slot) == page_id) {
+      // A single store is atomic for readers, so the segment version does not have to change.
+      array->slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+      if (slot == EMPTY_SLOT) {
+        segment.size_.fetch_add(1, std::memory_order_relaxed);
+      }
+      return;
+    }
+    i = (i + 1) & array->mask_;
+  }
+}
+
+auto ConcurrentPageTable::Remove(page_id_t page_id) -> bool {
+  uint64_t hash = Hash(page_id);
+  Segment &segment = SegmentOf(hash);
+  std::scoped_lock<std::mutex> lock(segment.latch_);
+  SlotArray *array = segment.arrays_.back().get();
+  size_t mask = array->mask_;
+  size_t hole = hash & mask;
+  while (true) {
+    uint64_t slot = array->slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (KeyOf(slot) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & mask;
+  }
+
+  // Backward-shift deletion moves entries across slots, so readers must not observe it halfway.
+  uint64_t version = segment.version_.load(std::memory_order_relaxed);
+  segment.version_.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (size_t i = (hole + 1) & mask;; i = (i + 1) & mask) {
+    uint64_t slot = array->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    // An entry may move back into the hole only if the hole lies on its probe path, i.e. between its home slot
+    // and its current slot.
+    size_t home = Hash(KeyOf(slot)) & mask;
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      array->slots_[hole].store(slot, std::memory_order_relaxed);
+      hole = i;
+    }
+  }
+  array->slots_[hole].store(EMPTY_SLOT, std::memory_order_relaxed);
+  segment.size_.fetch_sub(1, std::memory_order_relaxed);
+
+  segment.version_.store(version + 2, std::memory_order_release);
+  return true;
+}
+
+auto ConcurrentPageTable::Size() const -> size_t {
+  size_t size = 0;
+  for (size_t i = 0; i < num_segments_; i++) {
+    size += segments_[i].size_.load(std::memory_order_relaxed);
+  }
+  return size;
+}
+
+void ConcurrentPageTable::Grow(Segment *segment) {
+  SlotArray *old_array = segment->arrays_.back().get();
+  auto new_array = std::make_unique<SlotArray>(2 * (old_array->mask_ + 1));
+  for (size_t i = 0; i <= old_array->mask_; i++) {
+    uint64_t slot = old_array->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      continue;
+    }
+    size_t j = Hash(KeyOf(slot)) & new_array->mask_;
+    while (new_array->slots_[j].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+      j = (j + 1) & new_array->mask_;
+    }
+    new_array->slots_[j].store(slot, std::memory_order_relaxed);
+  }
+  // The new array is fully built before it is published, so readers never need to retry because of a resize.
+  segment->array_.store(new_array.get(), std::memory_order_release);
+  segment->arrays_.emplace_back(std::move(new_array));
+}
+
+}  // namespace bustub
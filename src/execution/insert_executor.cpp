@@ -1,27 +1,103 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// insert_executor.cpp
-//
-// Identification: src/execution/insert_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include <memory>
-
-#include "execution/executors/insert_executor.h"
-
-namespace bustub {
-
-InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
-                               std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
-
-void InsertExecutor::Init() { throw NotImplementedException("InsertExecutor is not implemented"); }
-
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// insert_executor.cpp
+//
+// Identification: src/execution/insert_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "execution/executors/insert_executor.h"
+
+namespace bustub {
+
+InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
+                               std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  indexes_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  is_done_ = false;
+  auto lock_manager = exec_ctx_->GetLockManager();
+  if (lock_manager != nullptr &&
+      !lock_manager->LockTable(exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_EXCLUSIVE,
+                               table_info_->oid_)) {
+    throw ExecutionException("InsertExecutor could not lock the table");
+  }
+}
+
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (is_done_) {
+    return false;
+  }
+  is_done_ = true;
+
+  int32_t num_inserted = 0;
+  bool bulk_insert = false;
+  std::vector<Tuple> batch;
+  Tuple child_tuple;
+  RID child_rid;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    batch.push_back(child_tuple);
+    if (batch.size() < bulk_insert_threshold) {
+      continue;
+    }
+    if (!bulk_insert) {
+      // One table lock covers every tuple from here on.
+      auto lock_manager = exec_ctx_->GetLockManager();
+      if (lock_manager != nullptr &&
+          !lock_manager->LockTable(exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE, table_info_->oid_)) {
+        throw ExecutionException("InsertExecutor could not lock the table");
+      }
+      bulk_insert = true;
+    }
+    InsertTuples(batch, true);
+    num_inserted += static_cast<int32_t>(batch.size());
+    batch.clear();
+  }
+  InsertTuples(batch, bulk_insert);
+  num_inserted += static_cast<int32_t>(batch.size());
+
+  *tuple = Tuple{std::vector<Value>{Value(TypeId::INTEGER, num_inserted)}, &GetOutputSchema()};
+  return true;
+}
+
+void InsertExecutor::InsertTuples(const std::vector<Tuple> &tuples, bool bulk_insert) {
+  auto txn = exec_ctx_->GetTransaction();
+  std::vector<RID> rids;
+  if (bulk_insert) {
+    if (!tuples.empty() && !table_info_->table_->BulkInsertTuples(tuples, &rids, txn)) {
+      throw ExecutionException("InsertExecutor could not insert the tuples");
+    }
+  } else {
+    auto lock_manager = exec_ctx_->GetLockManager();
+    rids.resize(tuples.size());
+    for (size_t i = 0; i < tuples.size(); i++) {
+      if (!table_info_->table_->InsertTuple(tuples[i], &rids[i], txn)) {
+        throw ExecutionException("InsertExecutor could not insert a tuple");
+      }
+      if (lock_manager != nullptr &&
+          !lock_manager->LockRow(txn, LockManager::LockMode::EXCLUSIVE, table_info_->oid_, rids[i])) {
+        throw ExecutionException("InsertExecutor could not lock a row");
+      }
+    }
+  }
+
+  for (auto index : indexes_) {
+    for (size_t i = 0; i < tuples.size(); i++) {
+      auto key = tuples[i].KeyFromTuple(table_info_->schema_, index->key_schema_, index->index_->GetKeyAttrs());
+      index->index_->InsertEntry(key, rids[i], txn);
+      txn->GetIndexWriteSet()->emplace_back(rids[i], table_info_->oid_, WType::INSERT, tuples[i], index->index_oid_,
+                                            exec_ctx_->GetCatalog());
+    }
+  }
+}
+
+}  // namespace bustub
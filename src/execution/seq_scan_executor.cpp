@@ -1,23 +1,223 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+
+namespace bustub {
+
+/** @return the result of comparing two native values of a column type */
+template <typename T>
+static auto CompareNative(T lhs, T rhs, ComparisonType comp_type) -> bool {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return lhs == rhs;
+    case ComparisonType::NotEqual:
+      return lhs != rhs;
+    case ComparisonType::LessThan:
+      return lhs < rhs;
+    case ComparisonType::LessThanOrEqual:
+      return lhs <= rhs;
+    case ComparisonType::GreaterThan:
+      return lhs > rhs;
+    case ComparisonType::GreaterThanOrEqual:
+      return lhs >= rhs;
+  }
+  return false;
+}
+
+/** Add the columns an expression reads to read_columns. */
+static void MarkColumns(const AbstractExpression &expr, std::vector<bool> *read_columns) {
+  if (const auto *column_value = dynamic_cast<const ColumnValueExpression *>(&expr); column_value != nullptr) {
+    (*read_columns)[column_value->GetColIdx()] = true;
+  }
+  for (const auto &child : expr.GetChildren()) {
+    MarkColumns(*child, read_columns);
+  }
+}
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  num_tuples_ = 0;
+  cursor_ = 0;
+  next_page_id_ = table_info_->table_->GetFirstPageId();
+  if (table_info_->table_->GetFormat() == TableFormat::PAX) {
+    column_filters_.clear();
+    row_filters_.clear();
+    if (plan_->filter_predicate_ != nullptr) {
+      SplitFilter(plan_->filter_predicate_.get());
+    }
+    read_columns_.assign(GetOutputSchema().GetColumnCount(), !plan_->column_ids_.has_value());
+    if (plan_->column_ids_) {
+      for (auto column_idx : *plan_->column_ids_) {
+        read_columns_[column_idx] = true;
+      }
+    }
+    for (const auto *filter : row_filters_) {
+      MarkColumns(*filter, &read_columns_);
+    }
+  }
+  // The scan reads a page at a time, so it locks the whole table rather than the rows one by one. A transaction that
+  // writes to the table already holds IX on it, which S would not upgrade, so it asks for SIX instead.
+  auto txn = exec_ctx_->GetTransaction();
+  auto lock_manager = exec_ctx_->GetLockManager();
+  auto oid = table_info_->oid_;
+  unlock_table_ = false;
+  if (lock_manager == nullptr || txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED ||
+      txn->IsTableSharedLocked(oid) || txn->IsTableSharedIntentionExclusiveLocked(oid) ||
+      txn->IsTableExclusiveLocked(oid)) {
+    return;
+  }
+  auto mode = txn->IsTableIntentionExclusiveLocked(oid) ? LockManager::LockMode::SHARED_INTENTION_EXCLUSIVE
+                                                        : LockManager::LockMode::SHARED;
+  if (!lock_manager->LockTable(txn, mode, oid)) {
+    throw ExecutionException("SeqScanExecutor could not lock the table");
+  }
+  unlock_table_ = mode == LockManager::LockMode::SHARED && txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED;
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (cursor_ == num_tuples_) {
+    if (next_page_id_ == INVALID_PAGE_ID) {
+      if (unlock_table_) {
+        exec_ctx_->GetLockManager()->UnlockTable(exec_ctx_->GetTransaction(), table_info_->oid_);
+        unlock_table_ = false;
+      }
+      return false;
+    }
+    ReadPage();
+  }
+  // The tuple is not needed in here any more, so hand over its bytes rather than copying them. The caller's old bytes
+  // take its place, for a later page to be copied into.
+  std::swap(*tuple, tuples_[cursor_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+void SeqScanExecutor::ReadPage() {
+  if (table_info_->table_->GetFormat() == TableFormat::PAX) {
+    ReadPaxPage();
+    return;
+  }
+  PageGuard guard;
+  next_page_id_ = table_info_->table_->GetPageTupleViews(next_page_id_, &guard, &views_);
+  num_tuples_ = 0;
+  cursor_ = 0;
+  for (const auto &view : views_) {
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(view.AsTuple(), GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    view.Materialize(NextTuple());
+  }
+}
+
+void SeqScanExecutor::ReadPaxPage() {
+  PageGuard guard;
+  next_page_id_ = table_info_->table_->ScanPage(next_page_id_, &guard);
+  auto page = reinterpret_cast<PaxPage *>(guard.GetPage());
+  num_tuples_ = 0;
+  cursor_ = 0;
+
+  slots_.clear();
+  for (uint32_t i = 0; i < page->GetTupleCount(); i++) {
+    if (page->IsVisible(i)) {
+      slots_.push_back(i);
+    }
+  }
+  for (const auto &filter : column_filters_) {
+    FilterColumn(page, filter);
+  }
+  const auto &schema = GetOutputSchema();
+  for (auto slot : slots_) {
+    Tuple *tuple = NextTuple();
+    bool passed = page->GetColumns(slot, read_columns_, tuple) &&
+                  std::all_of(row_filters_.begin(), row_filters_.end(), [&](const AbstractExpression *filter) {
+                    auto value = filter->Evaluate(tuple, schema);
+                    return !value.IsNull() && value.GetAs<bool>();
+                  });
+    if (!passed) {
+      num_tuples_--;
+    }
+  }
+}
+
+auto SeqScanExecutor::NextTuple() -> Tuple * {
+  if (num_tuples_ == tuples_.size()) {
+    tuples_.emplace_back();
+  }
+  return &tuples_[num_tuples_++];
+}
+
+void SeqScanExecutor::SplitFilter(const AbstractExpression *predicate) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(predicate);
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    SplitFilter(logic->GetChildAt(0).get());
+    SplitFilter(logic->GetChildAt(1).get());
+    return;
+  }
+  if (const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate); comparison != nullptr) {
+    for (uint32_t i = 0; i < 2; i++) {
+      const auto *column_value = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(i).get());
+      const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1 - i).get());
+      if (column_value != nullptr && constant != nullptr) {
+        column_filters_.push_back({comparison, column_value->GetColIdx(), constant->val_, i == 0});
+        return;
+      }
+    }
+  }
+  row_filters_.push_back(predicate);
+}
+
+void SeqScanExecutor::FilterColumn(PaxPage *page, const ColumnFilter &filter) {
+  const char *data = page->GetColumnData(filter.column_idx_);
+  uint32_t width = page->GetColumnWidth(filter.column_idx_);
+  TypeId type = page->GetColumnType(filter.column_idx_);
+  size_t num_passed = 0;
+  if (type == TypeId::INTEGER && filter.constant_.GetTypeId() == TypeId::INTEGER && !filter.constant_.IsNull()) {
+    // Compare the integers of the minipage as they are, without making a Value of each.
+    auto constant = filter.constant_.GetAs<int32_t>();
+    for (auto slot : slots_) {
+      int32_t value;
+      memcpy(&value, data + width * slot, sizeof(int32_t));
+      if (value != BUSTUB_INT32_NULL &&
+          (filter.column_on_left_ ? CompareNative(value, constant, filter.comparison_->comp_type_)
+                                  : CompareNative(constant, value, filter.comparison_->comp_type_))) {
+        slots_[num_passed++] = slot;
+      }
+    }
+  } else {
+    for (auto slot : slots_) {
+      auto value = Value::DeserializeFrom(data + width * slot, type);
+      auto result = filter.column_on_left_ ? filter.comparison_->PerformComparison(value, filter.constant_)
+                                           : filter.comparison_->PerformComparison(filter.constant_, value);
+      if (result == CmpBool::CmpTrue) {
+        slots_[num_passed++] = slot;
+      }
+    }
+  }
+  slots_.resize(num_passed);
+}
+
+}  // namespace bustub
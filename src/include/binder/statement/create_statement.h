@@ -12,6 +12,7 @@
 
 #include "binder/bound_statement.h"
 #include "catalog/column.h"
+#include "common/enums/table_format.h"
 
 namespace duckdb_libpgquery {
 struct PGCreateStmt;
@@ -21,10 +22,12 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, TableFormat format = TableFormat::ROW);
 
   std::string table_;
   std::vector<Column> columns_;
+  /** The format of the pages of the table, from `WITH (format = row | pax)` */
+  TableFormat format_;
 
   auto ToString() const -> std::string override;
 };
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_queue.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST 2003).
+ *
+ * Resident pages are split into T1, the pages that have been accessed once since they were loaded, and T2, the pages
+ * that have been accessed again. Each list has a ghost list, B1 and B2, holding the ids of pages recently evicted
+ * from it. A page that misses but is found in B1 means T1 was too small, so the target size p of T1 grows; a hit in
+ * B2 shrinks it. Eviction takes the least recently used evictable frame of T1 while T1 is larger than p, and of T2
+ * otherwise, falling back to the other list when every frame of the chosen one is pinned.
+ *
+ * Scan accesses never promote a page into T2, and a page that has only been scanned is not remembered in B1 once it
+ * is evicted, so scans cannot steer the adaptation.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the ARCReplacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  ~ARCReplacer() override = default;
+
+  using Replacer::RecordAccess;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsEvictable(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  /** @return the current target size of T1 */
+  auto GetRecentTarget() -> size_t;
+
+ private:
+  enum class ListId { None = 0, Recent, Frequent };
+
+  struct FrameEntry {
+    ListId list_{ListId::None};
+    bool is_evictable_{false};
+    bool is_scan_only_{false};
+    size_t timestamp_{0};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  auto QueueOf(ListId list) -> FrameQueue & { return list == ListId::Recent ? t1_ : t2_; }
+
+  /** Move a frame to the back of the given list. */
+  void MoveTo(frame_id_t frame_id, ListId list);
+
+  /** @return the list the next victim is taken from, ListId::None if no frame is evictable */
+  auto VictimList() const -> ListId;
+
+  /** Drop the oldest ghosts until |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+
+  size_t capacity_;
+  /** Target size of T1, between 0 and capacity_. */
+  size_t p_{0};
+  size_t current_timestamp_{0};
+  std::vector<FrameEntry> entries_;
+  FrameQueue t1_;
+  FrameQueue t2_;
+  GhostList b1_;
+  GhostList b2_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,12 +12,18 @@
 
 #pragma once
 
+#include <functional>
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_pool_stats.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/replacer.h"
 #include "recovery/log_manager.h"
+#include "storage/disk/free_page_map.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 
@@ -45,6 +51,62 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Fetch a page and tell the buffer pool why it is being accessed.
+   * @param page_id id of page to be fetched
+   * @param access_type type of access, sequential scans should pass AccessType::Scan
+   * @param callback grading callback
+   * @return the requested page, nullptr if it cannot be fetched
+   */
+  auto FetchPage(page_id_t page_id, AccessType access_type, bufferpool_callback_fn callback = nullptr) -> Page * {
+    GradingCallback(callback, CallbackType::BEFORE, page_id);
+    auto *result = FetchPgImp(page_id, access_type);
+    GradingCallback(callback, CallbackType::AFTER, page_id);
+    return result;
+  }
+
+  /**
+   * Fetch a batch of pages, e.g. the pages an index range scan or a join probe is about to visit. The buffer pool
+   * looks the pages up together and reads the missing ones from disk with a single request, instead of paying for a
+   * latch round trip and a serial read per page. Each page that is returned is pinned once per occurrence.
+   * @param page_ids ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return one entry per page id, nullptr where the page could not be fetched because every frame is pinned
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *> {
+    return FetchPgsImp(page_ids, access_type);
+  }
+
+  /**
+   * Unpin a batch of pages, e.g. the pages returned by FetchPages().
+   * @param page_ids ids of the pages to unpin, INVALID_PAGE_ID entries are skipped
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return false if any of the pages was not pinned, true otherwise
+   */
+  auto UnpinPages(const std::vector<page_id_t> &page_ids, bool is_dirty) -> bool {
+    return UnpinPgsImp(page_ids, is_dirty);
+  }
+
+  /** Reads what a caller needs from a page. See OptimisticReadPage(). */
+  using read_page_fn = std::function<void(Page *page)>;
+
+  /**
+   * Read a page for a point lookup without pinning or latching it. If the page is resident, read runs on it directly
+   * and the page version is checked afterwards; a writer that got in the way makes the read start over. After a few
+   * failed attempts, or if the page is not resident, the page is fetched, read under its read latch and unpinned.
+   *
+   * read may therefore run several times, and until the last run returns, it may see a torn page. It must be prepared
+   * for nonsense, e.g. check offsets against the page size before following them, and only keep what the last run
+   * found. It must not write to the page.
+   * @param page_id id of the page to read
+   * @param read reads the page
+   * @return false if the page could not be fetched, in which case read did not complete
+   */
+  auto OptimisticReadPage(page_id_t page_id, const read_page_fn &read) -> bool {
+    return OptimisticReadPgImp(page_id, read);
+  }
+
   /** Grading function. Do not modify! */
   auto UnpinPage(page_id_t page_id, bool is_dirty, bufferpool_callback_fn callback = nullptr) -> bool {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -61,6 +123,14 @@ class BufferPoolManager {
     return result;
   }
 
+  /**
+   * Flush a batch of pages, e.g. freshly filled pages that a bulk load wants on disk. The buffer pool writes them with
+   * a single request, so that runs of consecutive pages reach the disk as one write.
+   * @param page_ids ids of the pages to flush
+   * @return false if any of the pages could not be found in the page table, true otherwise
+   */
+  auto FlushPages(const std::vector<page_id_t> &page_ids) -> bool { return FlushPgsImp(page_ids); }
+
   /** Grading function. Do not modify! */
   auto NewPage(page_id_t *page_id, bufferpool_callback_fn callback = nullptr) -> Page * {
     GradingCallback(callback, CallbackType::BEFORE, INVALID_PAGE_ID);
@@ -87,6 +157,64 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /** Returns the page that follows the given page in a chain, or INVALID_PAGE_ID at the end of the chain. */
+  using next_page_fn = std::function<page_id_t(Page *page)>;
+
+  /**
+   * Ask the buffer pool to read pages in the background, so that a later FetchPage finds them in memory. This is only
+   * a hint: pages may be skipped when the I/O workers are busy or when every frame is pinned. The pages are loaded as
+   * AccessType::Scan, so they do not push hot pages out of the pool.
+   * @param page_ids pages to read ahead
+   */
+  virtual void PrefetchPages(const std::vector<page_id_t> &page_ids) {}
+
+  /**
+   * Ask the buffer pool to read a chain of pages, such as a table heap or a list of B+ tree leaves, in the background.
+   * Each page is read before the page after it is known, so a single worker walks the whole chain.
+   * @param first_page_id first page of the chain to read
+   * @param distance maximum number of pages to read
+   * @param next_page returns the page that follows a page, called with the page read latched
+   */
+  virtual void PrefetchChain(page_id_t first_page_id, size_t distance, next_page_fn next_page) {}
+
+  /** @return the statistics counters of the buffer pool, summed over all of its instances */
+  virtual auto GetStatistics() -> BufferPoolStats { return {}; }
+
+  /** Set the statistics counters of the buffer pool back to zero. */
+  virtual void ResetStatistics() {}
+
+  /** @return the free page map that new pages come from, nullptr if deleted pages are not reused */
+  virtual auto GetFreePageMap() -> FreePageMap * { return nullptr; }
+
+  /** Writes back state that a user of the buffer pool keeps in memory on top of its pages. */
+  using flush_fn = std::function<void()>;
+
+  /**
+   * Have FlushAllPages() call a function before it writes the pages, e.g. to write back a FreeSpaceMap first.
+   * @param flush the function to call
+   * @return the id to remove the function with, see RemoveFlushHook()
+   */
+  auto AddFlushHook(flush_fn flush) -> size_t {
+    std::scoped_lock<std::mutex> lock(flush_hooks_latch_);
+    flush_hooks_.emplace(next_flush_hook_id_, std::move(flush));
+    return next_flush_hook_id_++;
+  }
+
+  /** Stop calling a function added by AddFlushHook(); it is not called any more once this returns. */
+  void RemoveFlushHook(size_t hook_id) {
+    std::scoped_lock<std::mutex> lock(flush_hooks_latch_);
+    flush_hooks_.erase(hook_id);
+  }
+
+  /**
+   * Grow or shrink the buffer pool while it is in use. Shrinking writes back and drops the pages held by the frames
+   * that go away, and waits up to bpm_resize_timeout for the pinned ones to be unpinned; the caller must not hold any
+   * pins itself.
+   * @param pool_size the new number of frames
+   * @return false if the buffer pool cannot be resized to pool_size frames, in which case it keeps its old size
+   */
+  virtual auto Resize(size_t pool_size) -> bool { return false; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -102,11 +230,19 @@ class BufferPoolManager {
   }
 
   /**
-   * Fetch the requested page from the buffer pool.
+   * Fetch the requested page from the buffer pool. Virtual so that a wrapper can still intercept FetchPage().
+   * @param page_id id of page to be fetched
+   * @return the requested page
+   */
+  virtual auto FetchPgImp(page_id_t page_id) -> Page * { return FetchPgImp(page_id, AccessType::Unknown); }
+
+  /**
+   * Fetch the requested page from the buffer pool, with a hint of why it is being accessed.
    * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
    * @return the requested page
    */
-  virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
+  virtual auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -116,6 +252,55 @@ class BufferPoolManager {
    */
   virtual auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool = 0;
 
+  /**
+   * Fetch a batch of pages. By default, the pages are fetched one at a time.
+   * @param page_ids ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return one entry per page id, nullptr where the page could not be fetched
+   */
+  virtual auto FetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) -> std::vector<Page *> {
+    std::vector<Page *> pages;
+    pages.reserve(page_ids.size());
+    for (page_id_t page_id : page_ids) {
+      pages.push_back(FetchPgImp(page_id, access_type));
+    }
+    return pages;
+  }
+
+  /**
+   * Unpin a batch of pages. By default, the pages are unpinned one at a time.
+   * @param page_ids ids of the pages to unpin
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return false if any of the pages was not pinned, true otherwise
+   */
+  virtual auto UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> bool {
+    bool unpinned = true;
+    for (page_id_t page_id : page_ids) {
+      if (page_id != INVALID_PAGE_ID) {
+        unpinned = UnpinPgImp(page_id, is_dirty) && unpinned;
+      }
+    }
+    return unpinned;
+  }
+
+  /**
+   * Read a page without pinning it. By default, the page is fetched and read under its read latch.
+   * @param page_id id of the page to read
+   * @param read reads the page
+   * @return false if the page could not be fetched
+   */
+  virtual auto OptimisticReadPgImp(page_id_t page_id, const read_page_fn &read) -> bool {
+    Page *page = FetchPgImp(page_id, AccessType::Lookup);
+    if (page == nullptr) {
+      return false;
+    }
+    page->RLatch();
+    read(page);
+    page->RUnlatch();
+    UnpinPgImp(page_id, false);
+    return true;
+  }
+
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
@@ -123,6 +308,19 @@ class BufferPoolManager {
    */
   virtual auto FlushPgImp(page_id_t page_id) -> bool = 0;
 
+  /**
+   * Flushes a batch of pages to disk. By default, the pages are flushed one at a time.
+   * @param page_ids ids of the pages to flush
+   * @return false if any of the pages could not be found in the page table, true otherwise
+   */
+  virtual auto FlushPgsImp(const std::vector<page_id_t> &page_ids) -> bool {
+    bool flushed = true;
+    for (page_id_t page_id : page_ids) {
+      flushed = FlushPgImp(page_id) && flushed;
+    }
+    return flushed;
+  }
+
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
@@ -141,5 +339,41 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /** Call the functions added by AddFlushHook(). FlushAllPgsImp() does so before it writes any page. */
+  void RunFlushHooks() {
+    std::scoped_lock<std::mutex> lock(flush_hooks_latch_);
+    for (auto &[hook_id, flush] : flush_hooks_) {
+      flush();
+    }
+  }
+
+  /**
+   * Load a chain of pages into the buffer pool, blocking until each of them is read. This is the body of the tasks
+   * that PrefetchChain() queues.
+   * @param first_page_id first page of the chain to read
+   * @param distance maximum number of pages to read
+   * @param next_page returns the page that follows a page
+   */
+  void ReadChain(page_id_t first_page_id, size_t distance, const next_page_fn &next_page) {
+    page_id_t page_id = first_page_id;
+    for (size_t i = 0; i < distance && page_id != INVALID_PAGE_ID; i++) {
+      Page *page = FetchPgImp(page_id, AccessType::Scan);
+      if (page == nullptr) {
+        return;
+      }
+      page->RLatch();
+      page_id_t next_page_id = next_page(page);
+      page->RUnlatch();
+      UnpinPgImp(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+
+ private:
+  /** Protects the fields below. */
+  std::mutex flush_hooks_latch_;
+  std::unordered_map<size_t, flush_fn> flush_hooks_;
+  size_t next_flush_hook_id_{0};
 };
 }  // namespace bustub
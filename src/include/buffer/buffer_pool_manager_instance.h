@@ -12,16 +12,28 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/io_worker_pool.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
+#include "common/striped_counter.h"
+#include "container/hash/concurrent_page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/free_page_map.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -37,9 +49,27 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
+   * @param free_page_map the free page map shared by the instances of the parallel BPM, nullptr to create one of the
+   * instance's own if bpm_free_page_map is set
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK,
+                            FreePageMap *free_page_map = nullptr);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,13 +79,70 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
-  /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> Page * { return pages_; }
+  /**
+   * @brief Return the page in the given frame. Not synchronized with Resize(), so only call this while the pool is
+   * not being resized.
+   */
+  auto GetFrame(frame_id_t frame_id) -> Page * { return pages_[frame_id].get(); }
 
- protected:
   /**
-   * TODO(P1): Add implementation
+   * @brief Grow or shrink the buffer pool to pool_size frames while it is in use.
+   *
+   * New frames go onto the free list. When shrinking, the frames at the end of the pool are taken out of use: their
+   * pages are written back if dirty and dropped from the pool, right away if they are unpinned, otherwise as soon as
+   * their last pin is released. Resize() waits for that without holding the latch, so other threads keep fetching
+   * pages meanwhile, but the calling thread must not hold any pins itself. If some of the frames are still pinned after
+   * bpm_resize_timeout, the pool keeps its old size; the pages already dropped are simply read again when needed.
+   * Either way the replacer is rebuilt for the new number of frames and keeps the eviction order of the unpinned
+   * frames, but not their access history.
    *
+   * @param pool_size the new number of frames, at least 1
+   * @return false if pool_size is 0, or if shrinking timed out
+   */
+  auto Resize(size_t pool_size) -> bool override;
+
+  /**
+   * @brief Start the background writer. While more than bpm_writer_dirty_ratio of the pool is dirty, it writes back
+   * up to bpm_writer_batch_size dirty frames from the tail of the replacer every bpm_writer_interval, in page id order,
+   * so that eviction rarely has to write a dirty victim itself.
+   */
+  void StartBackgroundWriter();
+
+  /** @brief Stop and join the background writer. Does nothing if it is not running. */
+  void StopBackgroundWriter();
+
+  /** @brief Return the number of dirty pages written back by the background writer. */
+  auto GetNumBackgroundFlushes() const -> size_t { return CountOf(BufferPoolEvent::BackgroundWrite); }
+
+  /** @brief Return the number of dirty victims written back by the threads that evicted them. */
+  auto GetNumForegroundFlushes() const -> size_t { return CountOf(BufferPoolEvent::ForegroundWrite); }
+
+  /** @brief Return the counters of this instance. */
+  auto GetStatistics() -> BufferPoolStats override;
+
+  /** @brief Set the counters of this instance back to zero. */
+  void ResetStatistics() override { counters_.Reset(); }
+
+  /** @brief Return the free page map new pages come from, nullptr if deleted pages are not reused. */
+  auto GetFreePageMap() -> FreePageMap * override { return free_page_map_; }
+
+  /**
+   * @brief Read the given pages in the background on the I/O workers of this instance. Pages that are already in the
+   * pool are skipped without queueing anything.
+   * @param page_ids pages to read ahead
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) override;
+
+  /**
+   * @brief Read a chain of pages in the background on one I/O worker of this instance.
+   * @param first_page_id first page of the chain to read
+   * @param distance maximum number of pages to read
+   * @param next_page returns the page that follows a page
+   */
+  void PrefetchChain(page_id_t first_page_id, size_t distance, next_page_fn next_page) override;
+
+ protected:
+  /**
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
    * are currently in use and not evictable (in another word, pinned).
    *
@@ -73,8 +160,6 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto NewPgImp(page_id_t *page_id) -> Page * override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
    * but all frames are currently in use and not evictable (in another word, pinned).
    *
@@ -85,14 +170,42 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
    *
+   * Pages read from disk for a sequential scan are placed in the scan ring, a small set of frames that scans recycle
+   * among themselves, so a large scan does not flush the rest of the pool. A non-scan access to a page in the ring
+   * promotes it to a regular frame.
+   *
    * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPgImp(page_id_t page_id) -> Page * override;
+  using BufferPoolManager::FetchPgImp;
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
+
+  /**
+   * @brief Fetch a batch of pages under a single latch acquisition. Resident pages are pinned and misses get a frame
+   * right away, evicting victims as needed; the misses are then read with one DiskManager::ReadPages() call without
+   * holding the latch.
+   * @param page_ids ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return one entry per page id, nullptr where the page could not be fetched because every frame is pinned
+   */
+  auto FetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) -> std::vector<Page *> override;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Read a resident page without taking latch_, pinning the page or latching it.
    *
+   * The frame is found in the lock-free page table and the page is read between two loads of its version, like a
+   * reader of a sequence lock. The version changes whenever the page is write latched or the frame is given another
+   * page, so a read that overlapped either starts over. Pages that are not resident, or that keep changing, are
+   * fetched and read under their read latch instead.
+   *
+   * @param page_id id of the page to read
+   * @param read reads the page, possibly several times
+   * @return false if the page could not be fetched
+   */
+  auto OptimisticReadPgImp(page_id_t page_id, const read_page_fn &read) -> bool override;
+
+  /**
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
    * 0, return false.
    *
@@ -106,8 +219,14 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
+   * @brief Unpin a batch of pages under a single latch acquisition.
+   * @param page_ids ids of the pages to unpin
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return false if any of the pages was not in the page table or not pinned, true otherwise
+   */
+  auto UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> bool override;
+
+  /**
    * @brief Flush the target page to disk.
    *
    * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
@@ -119,49 +238,117 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto FlushPgImp(page_id_t page_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
+   * @brief Flush a batch of pages to disk with a single DiskManager::WritePages() call, regardless of their dirty
+   * flags.
+   * @param page_ids ids of the pages to flush
+   * @return false if any of the pages could not be found in the page table, true otherwise
+   */
+  auto FlushPgsImp(const std::vector<page_id_t> &page_ids) -> bool override;
+
+  /**
    * @brief Flush all the pages in the buffer pool to disk.
    */
   void FlushAllPgsImp() override;
 
   /**
-   * TODO(P1): Add implementation
-   *
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, only deallocate it and return
+   * true. If the page is pinned and cannot be deleted, return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-   * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * back to the free list. Also, reset the page's memory and metadata. Finally, call DeallocatePage() to hand the
+   * page back to the free page map, if there is one.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Number of pages in the buffer pool. While the pool shrinks, frames at or past pool_size_ are being retired. */
+  std::atomic<size_t> pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /** The replacement policy and its lookback constant, kept to rebuild the replacer on Resize(). */
+  const ReplacerType replacer_type_;
+  const size_t replacer_k_;
+
+  /**
+   * Buffer pool pages, indexed by frame id. Every page is allocated on its own, so that a page does not move when the
+   * pool is resized. The vector itself is protected by latch_, and optimistic readers are kept away while Resize()
+   * reallocates it, see BlockOptimisticReads().
+   */
+  std::vector<std::unique_ptr<Page>> pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  /** Page table for keeping track of buffer pool pages. Lookups never block, see ConcurrentPageTable. */
+  ConcurrentPageTable *page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  std::unique_ptr<Replacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Maximum number of frames in the scan ring. */
+  size_t scan_ring_size_;
+  /** Frames holding pages brought in by sequential scans, oldest first. They are not evictable in the replacer. */
+  std::list<frame_id_t> scan_ring_;
+  /** Whether each frame is currently in scan_ring_. */
+  std::vector<bool> in_scan_ring_;
+  /** Number of frames whose page is dirty. */
+  size_t num_dirty_frames_{0};
+
+  /** The background writer, nullptr if it is not running. */
+  std::thread *writer_thread_{nullptr};
+  /** Protected by latch_. Tells the background writer to exit. */
+  bool stop_writer_{false};
+  /** Wakes the background writer up early when the pool gets too dirty or when it has to stop. */
+  std::condition_variable writer_cv_;
+  /** Statistics counters, indexed by BufferPoolEvent. Striped, so that counting adds no contention to the hot path. */
+  StripedCounters<NUM_BUFFER_POOL_EVENTS> counters_;
+
+  /** Whether each frame is waiting for its page to be read from disk. The frame is pinned while this is set. */
+  std::vector<bool> io_pending_;
+  /** Signalled whenever a read finishes and clears its io_pending_ flag. */
+  std::condition_variable io_cv_;
+  /**
+   * Compressed copies of evicted pages, consulted on a miss before the disk. nullptr unless bpm_victim_cache_bytes was
+   * set when the instance was created.
+   */
+  std::unique_ptr<CompressedPageCache> victim_cache_;
+  /**
+   * Where pages are allocated from and deallocated to, shared with the other instances of a parallel BPM. nullptr
+   * unless bpm_free_page_map was set when the instance was created; new pages then just come from next_page_id_.
+   */
+  FreePageMap *free_page_map_{nullptr};
+  /** The free page map of a stand-alone instance. */
+  std::unique_ptr<FreePageMap> owned_free_page_map_;
+  /** Runs prefetches. Created on first use, so that pools that never prefetch do not start any threads. */
+  IoWorkerPool *io_pool_{nullptr};
+  std::once_flag io_pool_once_;
+  /** Number of pinned frames that a shrinking Resize() still waits to retire. */
+  size_t num_retiring_{0};
+  /** Signalled whenever a frame is retired. */
+  std::condition_variable resize_cv_;
+  /** Serializes Resize() calls. Taken before latch_. */
+  std::mutex resize_latch_;
+  /** Protects the page table, the free list, the replacer and the metadata of every frame. */
   std::mutex latch_;
 
+  /** Number of stripes optimistic readers are counted in. */
+  static constexpr size_t NUM_READER_STRIPES = 16;
+  /** A count of optimistic readers on a cache line of its own. */
+  struct alignas(64) ReaderCount {
+    std::atomic<int64_t> count_{0};
+  };
+  /** Optimistic readers currently looking into pages_, counted per stripe so that they rarely share a cache line. */
+  std::array<ReaderCount, NUM_READER_STRIPES> optimistic_readers_;
+  /** Set while Resize() changes pages_. New optimistic readers fall back to fetching the page meanwhile. */
+  std::atomic<bool> resizing_{false};
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
@@ -172,10 +359,141 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
+   * validate input data and ensure that a parallel BPM is routing requests to the correct BPI
+   * @param page_id
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /** @brief Count an event, or add to a counted quantity such as time. */
+  void Count(BufferPoolEvent event, uint64_t delta = 1) { counters_.Add(static_cast<size_t>(event), delta); }
+
+  /** @brief Return the current value of an event counter. */
+  auto CountOf(BufferPoolEvent event) const -> uint64_t { return counters_.Sum(static_cast<size_t>(event)); }
+
+  /**
+   * @brief Find a frame to hold a new page: a free frame, else a victim of the replacer, else an unpinned frame of the
+   * scan ring. If the victim frame holds a dirty page it is written back and the old mapping is removed from the page
+   * table. Caller must hold latch_.
+   * @param[out] frame_id the frame that can be reused
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Find a frame to hold a page read by a sequential scan. Once the scan ring is full, the oldest unpinned frame
+   * in the ring is reused; otherwise this falls back to AcquireFrame() and adds the frame to the ring. Caller must hold
+   * latch_.
+   * @param[out] frame_id the frame that can be reused
+   * @return false if every frame is pinned
+   */
+  auto AcquireScanFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Reuse the oldest unpinned frame of the scan ring. Caller must hold latch_.
+   * @param[out] frame_id the frame that can be reused
+   * @param keep_in_ring whether the frame stays in the ring, as the newest one, or leaves it
+   * @return false if every frame in the ring is pinned
+   */
+  auto ReuseScanRingFrame(frame_id_t *frame_id, bool keep_in_ring) -> bool;
+
+  /**
+   * @brief Remove a frame from the scan ring if it is in it. Caller must hold latch_.
+   * @param frame_id the frame to remove
+   */
+  void LeaveScanRing(frame_id_t frame_id);
+
+  /**
+   * @brief Write back the page in a frame that is being reused if it is dirty, make sure the victim cache has a copy
+   * if there is one, and drop its page table entry. Caller must hold latch_.
+   * @param frame_id the frame being reused
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Pin a frame that already holds the requested page and record the access. Caller must hold latch_.
+   * @return the page in the frame, which may still be waiting for its read to finish
+   */
+  auto PinResidentPage(frame_id_t frame_id, page_id_t page_id, AccessType access_type) -> Page *;
+
+  /**
+   * @brief Map a page to a frame that was just acquired, pin it and mark it as waiting for its read. The caller reads
+   * the page and then clears io_pending_. Caller must hold latch_.
+   * @return the page in the frame
+   */
+  auto InstallPage(frame_id_t frame_id, page_id_t page_id, AccessType access_type) -> Page *;
+
+  /**
+   * @brief Read a page that missed the pool from the victim cache, or else from disk. Called without the latch.
+   * @param page_id id of the page
+   * @param[out] page_data the contents of the page
+   */
+  void ReadPage(page_id_t page_id, char *page_data);
+
+  /** @brief Body of UnpinPgImp(). Caller must hold latch_. */
+  auto UnpinResidentPage(page_id_t page_id, bool is_dirty) -> bool;
+
+  /**
+   * @brief Called when the pin count of a frame drops to zero: the frame becomes evictable, unless it is in the scan
+   * ring or is being retired by Resize(), in which case it is retired now. Caller must hold latch_.
+   * @param frame_id the frame that was unpinned
+   */
+  void OnUnpinned(frame_id_t frame_id);
+
+  /**
+   * @brief Take an unpinned frame out of use: write back its page if dirty, drop the page from the page table and stop
+   * tracking the frame in the replacer. Caller must hold latch_.
+   * @param frame_id the frame to retire
+   */
+  void RetireFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Replace the replacer by one sized for the current number of frames. Resident frames are recorded again,
+   * the unpinned ones in their current eviction order. Caller must hold latch_.
+   */
+  void RebuildReplacer();
+
+  /**
+   * @brief Announce an optimistic reader, who may then look into pages_ until LeaveOptimisticRead().
+   * @param stripe the stripe of the calling thread
+   * @return false if Resize() is changing pages_, in which case the reader must not look
+   */
+  auto EnterOptimisticRead(size_t stripe) -> bool;
+
+  /** @brief Undo a successful EnterOptimisticRead(). */
+  void LeaveOptimisticRead(size_t stripe);
+
+  /** @brief Wait for the optimistic readers to leave pages_ and keep new ones out until UnblockOptimisticReads(). */
+  void BlockOptimisticReads();
+
+  /** @brief Let optimistic readers into pages_ again. */
+  void UnblockOptimisticReads();
+
+  /** @brief Return the size of the scan ring of a pool with the given number of frames. */
+  static auto ScanRingSize(size_t pool_size) -> size_t {
+    return std::min<size_t>(SCAN_RING_SIZE, std::max<size_t>(2, pool_size / 8));
   }
 
-  // TODO(student): You may add additional private members and helper functions
+  /** @brief Set the dirty flag of a page, keeping num_dirty_frames_ in sync. Caller must hold latch_. */
+  void SetDirty(Page *page, bool is_dirty);
+
+  /** @brief Whether the pool has more dirty frames than the background writer tolerates. Caller must hold latch_. */
+  auto IsTooDirty() const -> bool;
+
+  /** @brief Return the I/O workers of this instance, starting them if needed. */
+  auto GetIoPool() -> IoWorkerPool *;
+
+  /** @brief Body of the background writer thread. */
+  void RunBackgroundWriter();
+
+  /**
+   * @brief Write back one batch of dirty frames from the tail of the replacer. The frames are pinned while they are
+   * written so that they cannot be evicted, and their dirty flags are cleared before the write so that changes made
+   * during the write mark them dirty again.
+   */
+  void CleanTailFrames();
 };
 }  // namespace bustub
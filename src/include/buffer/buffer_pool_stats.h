@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/** The events a buffer pool counts. */
+enum class BufferPoolEvent {
+  FetchHit = 0,
+  FetchMiss,
+  NewPage,
+  Eviction,
+  ForegroundWrite,
+  BackgroundWrite,
+  NoFreeFrame,
+  IoWait,
+  DiskReadNanos,
+  VictimCacheHit,
+  VictimCacheMiss,
+  OptimisticRead,
+  OptimisticReadConflict,
+};
+
+/** Number of BufferPoolEvent values. */
+static constexpr size_t NUM_BUFFER_POOL_EVENTS = 13;
+
+/**
+ * BufferPoolStats is a snapshot of the counters of a buffer pool, or the sum of the snapshots of several instances.
+ */
+struct BufferPoolStats {
+  /** FetchPage calls that found the page in the pool. */
+  uint64_t fetch_hits_{0};
+  /** FetchPage calls that had to read the page from disk. */
+  uint64_t fetch_misses_{0};
+  /** Pages created by NewPage. */
+  uint64_t new_pages_{0};
+  /** Frames whose page was evicted to make room for another page. */
+  uint64_t evictions_{0};
+  /** Dirty pages written back by the thread that evicted them. */
+  uint64_t foreground_writes_{0};
+  /** Dirty pages written back by the background writer. */
+  uint64_t background_writes_{0};
+  /** FetchPage and NewPage calls that failed because every frame was pinned. */
+  uint64_t no_free_frame_{0};
+  /** FetchPage hits that had to wait for another thread to finish reading the page. */
+  uint64_t io_waits_{0};
+  /** Time spent reading pages from disk on FetchPage misses, in nanoseconds. */
+  uint64_t disk_read_ns_{0};
+  /** FetchPage misses served by the compressed victim cache instead of the disk. */
+  uint64_t victim_cache_hits_{0};
+  /** FetchPage misses that were not in the compressed victim cache either. Only counted while the cache is enabled. */
+  uint64_t victim_cache_misses_{0};
+  /** OptimisticReadPage calls served without pinning or latching the page. */
+  uint64_t optimistic_reads_{0};
+  /** Optimistic page reads that a concurrent writer or eviction invalidated. */
+  uint64_t optimistic_read_conflicts_{0};
+
+  /** @return the fraction of FetchPage calls that hit, 0 if there were none */
+  auto HitRatio() const -> double {
+    uint64_t fetches = fetch_hits_ + fetch_misses_;
+    return fetches == 0 ? 0 : static_cast<double>(fetch_hits_) / static_cast<double>(fetches);
+  }
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+    fetch_hits_ += other.fetch_hits_;
+    fetch_misses_ += other.fetch_misses_;
+    new_pages_ += other.new_pages_;
+    evictions_ += other.evictions_;
+    foreground_writes_ += other.foreground_writes_;
+    background_writes_ += other.background_writes_;
+    no_free_frame_ += other.no_free_frame_;
+    io_waits_ += other.io_waits_;
+    disk_read_ns_ += other.disk_read_ns_;
+    victim_cache_hits_ += other.victim_cache_hits_;
+    victim_cache_misses_ += other.victim_cache_misses_;
+    optimistic_reads_ += other.optimistic_reads_;
+    optimistic_read_conflicts_ += other.optimistic_read_conflicts_;
+    return *this;
+  }
+};
+
+}  // namespace bustub
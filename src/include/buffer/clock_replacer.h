@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,6 +22,10 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every tracked frame has a reference bit that an access sets. The clock hand sweeps over the frames, clearing the
+ * bits it passes, and evicts the first evictable frame whose bit is already clear. A frame first brought in by a scan
+ * starts with a clear bit, so it is evicted on the first pass unless it is accessed again.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -37,16 +40,35 @@ class ClockReplacer : public Replacer {
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  using Replacer::RecordAccess;
 
-  void Pin(frame_id_t frame_id) override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Unpin(frame_id_t frame_id) override;
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsEvictable(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
  private:
-  // TODO(student): implement me!
+  struct FrameEntry {
+    bool is_tracked_{false};
+    bool is_evictable_{false};
+    bool reference_{false};
+  };
+
+  std::vector<FrameEntry> entries_;
+  /** The frame the clock hand points at. */
+  size_t hand_{0};
+  /** Number of evictable frames. */
+  size_t num_evictable_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
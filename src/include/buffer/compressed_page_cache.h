@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Largest size a page can take after CompressPage(), for pages that do not compress at all. */
+static constexpr size_t MAX_COMPRESSED_PAGE_SIZE = BUSTUB_PAGE_SIZE + BUSTUB_PAGE_SIZE / 255 + 16;
+
+/**
+ * Compress a page with a small LZ77 codec in the style of LZ4: the output is a sequence of literal runs, each
+ * followed by a back-reference to earlier data of the page. Pages are mostly free space and fixed-layout tuples, so the
+ * codec only needs to be fast, not to compress well.
+ * @param page the BUSTUB_PAGE_SIZE bytes to compress
+ * @param[out] out the compressed page, at least MAX_COMPRESSED_PAGE_SIZE bytes
+ * @return the size of the compressed page
+ */
+auto CompressPage(const char *page, char *out) -> size_t;
+
+/**
+ * Decompress a page produced by CompressPage().
+ * @param in the compressed page
+ * @param size the size of the compressed page
+ * @param[out] page the BUSTUB_PAGE_SIZE bytes of the page
+ * @return false if the input is not a valid compressed page
+ */
+auto DecompressPage(const char *in, size_t size, char *page) -> bool;
+
+/**
+ * CompressedPageCache is a second tier behind a buffer pool: it keeps compressed copies of the pages the buffer pool
+ * evicts, within a fixed memory budget, so that a page that is fetched again soon can be decompressed instead of read
+ * from disk.
+ *
+ * A page stays in the cache after it is looked up, so that when the buffer pool evicts it again, still clean, it only
+ * has to Touch() the copy instead of compressing the page a second time. The buffer pool Erase()s the copy when it
+ * dirties the page, and inserts a fresh one after writing the page back. When the budget is exceeded, the least
+ * recently used pages are dropped.
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * @brief Create a new CompressedPageCache.
+   * @param capacity_bytes the memory budget for compressed pages
+   */
+  explicit CompressedPageCache(size_t capacity_bytes);
+
+  /**
+   * @brief Compress a page and add it to the cache, replacing any older copy. Pages that do not fit the budget even in
+   * an empty cache are dropped.
+   * @param page_id id of the page
+   * @param page_data the contents of the page
+   */
+  void Insert(page_id_t page_id, const char *page_data);
+
+  /**
+   * @brief Decompress a page from the cache.
+   * @param page_id id of the page
+   * @param[out] page_data the contents of the page
+   * @return false if the page is not in the cache
+   */
+  auto Lookup(page_id_t page_id, char *page_data) -> bool;
+
+  /**
+   * @brief Mark the copy of a page as recently used.
+   * @return false if the page is not in the cache
+   */
+  auto Touch(page_id_t page_id) -> bool;
+
+  /** @brief Forget a page, e.g. because it was deleted. */
+  void Erase(page_id_t page_id);
+
+  /** @return the number of pages in the cache */
+  auto Size() -> size_t;
+
+  /** @return the memory taken by the compressed pages in the cache */
+  auto GetUsedBytes() -> size_t;
+
+ private:
+  struct Entry {
+    std::shared_ptr<char[]> data_;
+    size_t size_;
+    std::list<page_id_t>::iterator order_it_;
+  };
+
+  /** Drop an entry. Caller must hold latch_. */
+  void EraseEntry(std::unordered_map<page_id_t, Entry>::iterator it);
+
+  const size_t capacity_bytes_;
+  size_t used_bytes_{0};
+  /** Cached pages, least recently used first. */
+  std::list<page_id_t> order_;
+  std::unordered_map<page_id_t, Entry> entries_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
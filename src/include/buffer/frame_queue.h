@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_queue.h
+//
+// Identification: src/include/buffer/frame_queue.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FrameQueue is one recency-ordered list of frames of a replacer, such as the T1 list of ARC or the window of
+ * TinyLFU. The replacer stamps a frame with a logical timestamp whenever it moves the frame to the back of a queue.
+ *
+ * Pinned frames stay in their queue but cannot be evicted, so the queue keeps its evictable frames in a separate
+ * ordered set. Finding the oldest evictable frame is then O(1) no matter how many pinned frames sit in front of it.
+ * The caller owns the per-frame timestamp and evictable flag and passes them in, so the queue only holds keys.
+ */
+class FrameQueue {
+ public:
+  /** Add a frame to the back of the queue. */
+  void Push(frame_id_t frame_id, size_t timestamp, bool evictable) {
+    size_++;
+    if (evictable) {
+      evictable_.emplace(timestamp, frame_id);
+    }
+  }
+
+  /** Take a frame out of the queue. */
+  void Erase(frame_id_t frame_id, size_t timestamp, bool evictable) {
+    size_--;
+    if (evictable) {
+      evictable_.erase({timestamp, frame_id});
+    }
+  }
+
+  /** Change whether a frame of the queue is evictable. */
+  void SetEvictable(frame_id_t frame_id, size_t timestamp, bool evictable) {
+    if (evictable) {
+      evictable_.emplace(timestamp, frame_id);
+    } else {
+      evictable_.erase({timestamp, frame_id});
+    }
+  }
+
+  /**
+   * @param[out] frame_id the evictable frame closest to the front of the queue
+   * @return false if no frame of the queue is evictable
+   */
+  auto Front(frame_id_t *frame_id) const -> bool {
+    if (evictable_.empty()) {
+      return false;
+    }
+    *frame_id = evictable_.begin()->second;
+    return true;
+  }
+
+  /** Append up to max_frames evictable frames to frames, front first. */
+  void AppendEvictable(std::vector<frame_id_t> *frames, size_t max_frames) const {
+    for (auto it = evictable_.begin(); it != evictable_.end() && frames->size() < max_frames; ++it) {
+      frames->push_back(it->second);
+    }
+  }
+
+  /** @return the number of frames in the queue, evictable or not */
+  auto Size() const -> size_t { return size_; }
+
+  /** @return the number of evictable frames in the queue */
+  auto NumEvictable() const -> size_t { return evictable_.size(); }
+
+ private:
+  size_t size_{0};
+  std::set<std::pair<size_t, frame_id_t>> evictable_;
+};
+
+/**
+ * GhostList remembers the ids of pages a replacer has recently evicted, oldest first, so that the replacer can
+ * recognize a page that comes back soon after it left the pool. It holds no frames.
+ */
+class GhostList {
+ public:
+  /** Add a page to the back of the list. */
+  void Push(page_id_t page_id) {
+    Erase(page_id);
+    index_[page_id] = order_.insert(order_.end(), page_id);
+  }
+
+  /** @return true if the page was in the list and has been taken out of it */
+  auto Erase(page_id_t page_id) -> bool {
+    auto it = index_.find(page_id);
+    if (it == index_.end()) {
+      return false;
+    }
+    order_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+  /** Forget the oldest page. The list must not be empty. */
+  void PopFront() {
+    index_.erase(order_.front());
+    order_.pop_front();
+  }
+
+  auto Size() const -> size_t { return order_.size(); }
+
+ private:
+  std::list<page_id_t> order_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
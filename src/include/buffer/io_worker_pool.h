@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_worker_pool.h
+//
+// Identification: src/include/buffer/io_worker_pool.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace bustub {
+
+/**
+ * IoWorkerPool runs background I/O tasks, such as read-ahead, for a buffer pool on a small fixed set of threads.
+ *
+ * The queue is bounded. Tasks are hints that the caller can live without, so Submit() drops a task rather than
+ * block when the workers fall behind, and tasks that have not started when the pool is destroyed are discarded.
+ */
+class IoWorkerPool {
+ public:
+  /**
+   * @brief Start the worker threads.
+   * @param num_threads number of worker threads
+   * @param max_queued maximum number of tasks waiting for a worker
+   */
+  IoWorkerPool(size_t num_threads, size_t max_queued);
+
+  /** @brief Discard the queued tasks, wait for the running ones and join the worker threads. */
+  ~IoWorkerPool();
+
+  /**
+   * @brief Queue a task to run on a worker thread.
+   * @param task the task
+   * @return false if the queue is full and the task was dropped
+   */
+  auto Submit(std::function<void()> task) -> bool;
+
+ private:
+  void Run();
+
+  size_t max_queued_;
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_{false};
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
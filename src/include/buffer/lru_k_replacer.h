@@ -13,11 +13,12 @@
 #pragma once
 
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <set>
+#include <tuple>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
@@ -33,13 +34,16 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Frames that have only ever been touched by sequential scans are not given any access history. They are
+ * evicted before every other frame, oldest first.
+ *
+ * Evictable frames are kept in an ordered set keyed by their eviction order, so Evict(), RecordAccess() and
+ * SetEvictable() take O(log n) time instead of scanning every frame.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief a new LRUKReplacer.
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
    */
@@ -48,15 +52,13 @@ class LRUKReplacer {
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
+
+  using Replacer::RecordAccess;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Find the frame with largest backward k-distance and evict that frame. Only frames
    * that are marked as 'evictable' are candidates for eviction.
    *
@@ -70,24 +72,32 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  /**
+   * @brief List the evictable frames that would be evicted next, in eviction order, without evicting them.
+   * @param max_frames maximum number of frames to return
+   * @return up to max_frames frames, the next victim first
+   */
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Record the event that the given frame id is accessed at current timestamp.
    * Create a new entry for access history if frame id has not been seen before.
    *
    * If frame id is invalid (ie. larger than replacer_size_), throw an exception. You can
    * also use BUSTUB_ASSERT to abort the process if frame id is invalid.
    *
+   * A scan access only registers a frame that has no history yet, and marks it as scan-only. It never adds to the
+   * history of a frame that was reached through lookups, so a scan cannot make a page look hot.
+   *
    * @param frame_id id of frame that received a new access.
+   * @param page_id id of the page the frame holds, unused by this policy.
+   * @param access_type type of access that was received.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Toggle whether a frame is evictable or non-evictable. This function also
    * controls replacer's size. Note that size is equal to number of evictable entries.
    *
@@ -102,11 +112,11 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsEvictable(frame_id_t frame_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Remove an evictable frame from replacer, along with its access history.
    * This function should also decrement replacer's size if removal is successful.
    *
@@ -121,24 +131,51 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Return replacer's size, which tracks the number of evictable frames.
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
+  /**
+   * Per-frame bookkeeping. The last (at most) k access timestamps are kept in a ring buffer of k slots, so the
+   * history of a frame never takes more than k timestamps no matter how often it is accessed.
+   */
+  struct FrameEntry {
+    std::vector<size_t> history_;
+    /** Slot of the oldest retained timestamp. */
+    size_t head_{0};
+    /** Number of retained timestamps, 0 if the replacer does not track the frame. */
+    size_t count_{0};
+    bool is_evictable_{false};
+    bool is_scan_only_{false};
+  };
+
+  /**
+   * Eviction order key of a frame: (class, timestamp, frame id), smallest first. Scan-only frames form the first
+   * class, then frames with +inf backward k-distance, then everything else. The timestamp is the oldest retained
+   * one: the k-th most recent access for frames with a full history, and the earliest access for the others.
+   */
+  using EvictionKey = std::tuple<int, size_t, frame_id_t>;
+
+  auto KeyOf(frame_id_t frame_id) const -> EvictionKey;
+
+  /** Append a timestamp to the history of a frame, dropping the oldest one if the history is full. */
+  void PushTimestamp(FrameEntry *entry, size_t timestamp);
+
+  /** Stop tracking a frame. Its history buffer is kept for reuse. */
+  void ResetEntry(FrameEntry *entry);
+
+  size_t current_timestamp_{0};
+  size_t replacer_size_;
+  size_t k_;
+  std::vector<FrameEntry> entries_;
+  /** Evictable frames in eviction order. Its size is the size of the replacer. */
+  std::set<EvictionKey> evictable_;
   std::mutex latch_;
 };
 
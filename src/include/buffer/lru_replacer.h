@@ -12,17 +12,17 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
+#include "buffer/frame_queue.h"
 #include "buffer/replacer.h"
 #include "common/config.h"
 
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy. It ignores access type hints.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -37,16 +37,35 @@ class LRUReplacer : public Replacer {
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  using Replacer::RecordAccess;
 
-  void Pin(frame_id_t frame_id) override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Unpin(frame_id_t frame_id) override;
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsEvictable(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
  private:
-  // TODO(student): implement me!
+  struct FrameEntry {
+    bool is_tracked_{false};
+    bool is_evictable_{false};
+    /** Time of the last access. */
+    size_t timestamp_{0};
+  };
+
+  size_t current_timestamp_{0};
+  std::vector<FrameEntry> entries_;
+  /** Tracked frames, least recently used first. */
+  FrameQueue queue_;
+  std::mutex latch_;
 };
 
 }  // namespace bustub
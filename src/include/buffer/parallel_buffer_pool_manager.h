@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/io_worker_pool.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool across several BufferPoolManagerInstances so that threads working
+ * on different pages do not serialize on a single instance latch. A page always lives in the instance given by
+ * page_id % num_instances; new pages are handed out round-robin across the instances.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of every instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRUK);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override = default;
+
+  /** @return size of the buffer pool, summed over all instances */
+  auto GetPoolSize() -> size_t override;
+
+  /** @return the number of BufferPoolManagerInstances */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /** @return the number of frames of one instance */
+  auto GetInstancePoolSize(size_t instance_index) -> size_t { return instances_[instance_index]->GetPoolSize(); }
+
+  /**
+   * Split pool_size frames evenly among the instances and resize them one after the other. If an instance cannot be
+   * resized, i.e. it timed out shrinking, the instances resized before it are resized back to their old sizes.
+   * @param pool_size the new number of frames, summed over all instances
+   * @return false if there are fewer frames than instances, or an instance could not be resized
+   */
+  auto Resize(size_t pool_size) -> bool override;
+
+  /** Start the background writer of every instance. */
+  void StartBackgroundWriter();
+
+  /** Stop the background writer of every instance. */
+  void StopBackgroundWriter();
+
+  /**
+   * Forward each page to the instance that owns it.
+   * @param page_ids pages to read ahead
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) override;
+
+  /**
+   * Read a chain of pages in the background. The pages of a chain are spread over all instances, so the chain is
+   * walked by the I/O workers of the parallel buffer pool itself.
+   * @param first_page_id first page of the chain to read
+   * @param distance maximum number of pages to read
+   * @param next_page returns the page that follows a page
+   */
+  void PrefetchChain(page_id_t first_page_id, size_t distance, next_page_fn next_page) override;
+
+  /** @return the statistics counters summed over every instance */
+  auto GetStatistics() -> BufferPoolStats override;
+
+  /** @return the statistics counters of one instance */
+  auto GetInstanceStatistics(size_t instance_index) -> BufferPoolStats {
+    return instances_[instance_index]->GetStatistics();
+  }
+
+  /** Set the statistics counters of every instance back to zero. */
+  void ResetStatistics() override;
+
+  /** @return the free page map shared by all instances, nullptr if deleted pages are not reused */
+  auto GetFreePageMap() -> FreePageMap * override { return free_page_map_.get(); }
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
+   * @return the requested page
+   */
+  using BufferPoolManager::FetchPgImp;
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
+
+  /**
+   * Split a batch of pages by instance and fetch each part as one batch.
+   * @param page_ids ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return one entry per page id, nullptr where the page could not be fetched
+   */
+  auto FetchPgsImp(const std::vector<page_id_t> &page_ids, AccessType access_type) -> std::vector<Page *> override;
+
+  /**
+   * Read a page without pinning it, in the instance responsible for the page.
+   * @param page_id id of the page to read
+   * @param read reads the page
+   * @return false if the page could not be fetched
+   */
+  auto OptimisticReadPgImp(page_id_t page_id, const read_page_fn &read) -> bool override;
+
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * Split a batch of pages by instance and unpin each part as one batch.
+   * @param page_ids ids of the pages to unpin
+   * @param is_dirty true if the pages should be marked as dirty, false otherwise
+   * @return false if any of the pages was not pinned, true otherwise
+   */
+  auto UnpinPgsImp(const std::vector<page_id_t> &page_ids, bool is_dirty) -> bool override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes a batch of pages, handing each instance its share of the batch.
+   * @param page_ids ids of the pages to flush
+   * @return false if any of the pages could not be found in the page table, true otherwise
+   */
+  auto FlushPgsImp(const std::vector<page_id_t> &page_ids) -> bool override;
+
+  /**
+   * Creates a new page in the buffer pool. Instances are tried round-robin, starting one past the instance that was
+   * tried first on the previous call, until one of them has an evictable frame.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * Deletes a page from the buffer pool.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes all the pages in the buffer pool to disk.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /** Shared by the instances if bpm_free_page_map is set. Declared before instances_ so that it outlives them. */
+  std::unique_ptr<FreePageMap> free_page_map_;
+  /** The shards, instance i owns every page id with page_id % num_instances == i. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** The instance that NewPgImp tries first on its next call. */
+  std::atomic<size_t> next_instance_{0};
+  /** Walks page chains for PrefetchChain. Declared after instances_ so that it is stopped before they are destroyed. */
+  std::unique_ptr<IoWorkerPool> io_pool_;
+  std::once_flag io_pool_once_;
+};
+
+}  // namespace bustub
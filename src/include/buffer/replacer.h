@@ -6,45 +6,124 @@
 //
 // Identification: src/include/buffer/replacer.h
 //
-// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/**
+ * Why a page is being accessed. Sequential scans touch each page once, so the replacer and the buffer pool use this
+ * hint to keep scans from pushing hot pages out of the pool.
+ */
+enum class AccessType { Unknown = 0, Lookup, Scan, Index };
+
+/** The replacement policies a buffer pool can be built with. */
+enum class ReplacerType { LRUK = 0, LRU, Clock, ARC, TwoQueue, TinyLFU };
+
 /**
  * Replacer is an abstract class that tracks page usage.
+ *
+ * The buffer pool tells the replacer about every access to a frame, and whether the frame may currently be evicted
+ * (i.e. whether it is unpinned). The replacer starts tracking a frame on its first access and forgets it once the
+ * frame is evicted or removed; frames that are not tracked are never chosen as victims.
  */
 class Replacer {
  public:
   Replacer() = default;
   virtual ~Replacer() = default;
 
+  /**
+   * Evict a frame as defined by the replacement policy. Only frames that are marked as evictable are candidates.
+   * The evicted frame is no longer tracked.
+   * @param[out] frame_id id of frame that was evicted
+   * @return true if a frame was evicted, false if no frame can be evicted
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * List the evictable frames that are likely to be evicted next, in eviction order, without evicting them.
+   * @param max_frames maximum number of frames to return
+   * @return up to max_frames frames, the next victim first
+   */
+  virtual auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> = 0;
+
+  /**
+   * Record an access to a frame, and start tracking the frame if it is not tracked yet.
+   *
+   * Policies that remember pages after they have been evicted (ghost entries, frequency sketches) need to know which
+   * page the frame holds. They treat an access with INVALID_PAGE_ID as an access to a page they have never seen.
+   *
+   * @param frame_id id of frame that received a new access
+   * @param page_id id of the page the frame holds
+   * @param access_type type of access that was received
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) = 0;
+
+  /** Record an access to a frame without telling the replacer which page it holds. */
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) {
+    RecordAccess(frame_id, INVALID_PAGE_ID, access_type);
+  }
+
+  /**
+   * Toggle whether a frame is evictable. Does nothing if the frame is not tracked.
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
+   */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /** @return true if the frame is tracked and evictable */
+  virtual auto IsEvictable(frame_id_t frame_id) -> bool = 0;
+
+  /**
+   * Stop tracking an evictable frame, e.g. because its page was deleted. Unlike eviction, this does not leave any
+   * memory of the page behind. Does nothing if the frame is not tracked; aborts if the frame is not evictable.
+   * @param frame_id id of frame to be removed
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of elements in the replacer that can be victimized */
+  virtual auto Size() -> size_t = 0;
+
   /**
    * Remove the victim frame as defined by the replacement policy.
    * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  auto Victim(frame_id_t *frame_id) -> bool { return Evict(frame_id); }
 
   /**
    * Pins a frame, indicating that it should not be victimized until it is unpinned.
    * @param frame_id the id of the frame to pin
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  void Pin(frame_id_t frame_id) { SetEvictable(frame_id, false); }
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
+   * Unpins a frame, indicating that it can now be victimized. Unpinning counts as an access, unless the frame is
+   * already unpinned.
    * @param frame_id the id of the frame to unpin
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
-
-  /** @return the number of elements in the replacer that can be victimized */
-  virtual auto Size() -> size_t = 0;
+  void Unpin(frame_id_t frame_id) {
+    if (!IsEvictable(frame_id)) {
+      RecordAccess(frame_id);
+      SetEvictable(frame_id, true);
+    }
+  }
 };
 
+/**
+ * Create a replacer.
+ * @param replacer_type the replacement policy
+ * @param num_frames the number of frames the replacer will be required to track
+ * @param k the lookback constant k, only used by the LRU-K replacer
+ */
+auto MakeReplacer(ReplacerType replacer_type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
 }  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tiny_lfu_replacer.h
+//
+// Identification: src/include/buffer/tiny_lfu_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_queue.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FrequencySketch estimates how often each page has been accessed recently, in constant space.
+ *
+ * It is a count-min sketch with four rows of 4-bit saturating counters. Once the number of recorded accesses reaches
+ * ten times the width of a row, every counter is halved, so the estimates follow the recent popularity of a page
+ * rather than its popularity since startup.
+ */
+class FrequencySketch {
+ public:
+  /** @param capacity the number of pages whose frequency should be told apart, e.g. the number of frames */
+  explicit FrequencySketch(size_t capacity);
+
+  /** Record an access to a page. */
+  void Increment(page_id_t page_id);
+
+  /** @return the estimated number of recent accesses to a page, at most 15 */
+  auto Estimate(page_id_t page_id) const -> uint32_t;
+
+ private:
+  static constexpr size_t NUM_ROWS = 4;
+  static constexpr uint8_t MAX_COUNT = 15;
+
+  auto IndexOf(page_id_t page_id, size_t row) const -> size_t;
+
+  /** Halve every counter. */
+  void Reset();
+
+  size_t width_mask_;
+  size_t sample_size_;
+  size_t additions_{0};
+  /** NUM_ROWS rows of width_mask_ + 1 counters each. */
+  std::vector<uint8_t> counters_;
+};
+
+/**
+ * TinyLFUReplacer implements the W-TinyLFU policy (Einziger et al., ACM TOS 2017).
+ *
+ * A newly loaded page enters a small LRU window, about 1% of the frames. The rest of the pool is a segmented LRU:
+ * a page that is accessed again while in probation moves to the protected segment, which holds at most 80% of the
+ * main area and demotes its least recently used page back to probation when it overflows.
+ *
+ * TinyLFU is an admission policy: when the window is full, its oldest page only joins the main area if the frequency
+ * sketch says it is more popular than the page probation would evict next. The buffer pool must always load the page
+ * it was asked for, so here the duel decides which of the two frames is evicted. Scan accesses are not counted in the
+ * sketch and never promote a page, so a large scan loses every duel against the working set.
+ */
+class TinyLFUReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TinyLFUReplacer.
+   * @param num_frames the maximum number of frames the TinyLFUReplacer will be required to store
+   */
+  explicit TinyLFUReplacer(size_t num_frames);
+
+  ~TinyLFUReplacer() override = default;
+
+  using Replacer::RecordAccess;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsEvictable(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+ private:
+  enum class ListId { None = 0, Window, Probation, Protected };
+
+  struct FrameEntry {
+    ListId list_{ListId::None};
+    bool is_evictable_{false};
+    size_t timestamp_{0};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  auto QueueOf(ListId list) -> FrameQueue &;
+
+  /** Move a frame to the back of the given list. */
+  void MoveTo(frame_id_t frame_id, ListId list);
+
+  /** @return the estimated frequency of the page a frame holds */
+  auto FrequencyOf(frame_id_t frame_id) const -> uint32_t;
+
+  /** Maximum size of the window. */
+  size_t window_capacity_;
+  /** Maximum size of the protected segment. */
+  size_t protected_capacity_;
+  size_t current_timestamp_{0};
+  std::vector<FrameEntry> entries_;
+  FrameQueue window_;
+  FrameQueue probation_;
+  FrameQueue protected_;
+  FrequencySketch sketch_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_queue.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full version of the 2Q replacement policy (Johnson and Shasha, VLDB 1994).
+ *
+ * A page that is loaded for the first time goes into A1in, a FIFO queue. Accesses to a page while it is in A1in are
+ * treated as correlated and do not change its position. When A1in holds more than a quarter of the frames, its oldest
+ * evictable page is evicted and remembered in A1out, a FIFO ghost queue sized for half the frames. A page that is
+ * loaded again while it is remembered in A1out has proven it is re-referenced over a longer period, so it goes into
+ * Am, an LRU list holding the rest of the pool.
+ *
+ * Scan accesses never refresh a page in Am, and a page that has only been scanned is not remembered in A1out.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_frames the maximum number of frames the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  ~TwoQueueReplacer() override = default;
+
+  using Replacer::RecordAccess;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, AccessType access_type) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsEvictable(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+ private:
+  enum class ListId { None = 0, In, Main };
+
+  struct FrameEntry {
+    ListId list_{ListId::None};
+    bool is_evictable_{false};
+    bool is_scan_only_{false};
+    size_t timestamp_{0};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  auto QueueOf(ListId list) -> FrameQueue & { return list == ListId::In ? a1in_ : am_; }
+
+  /** Move a frame to the back of the given list. */
+  void MoveTo(frame_id_t frame_id, ListId list);
+
+  /** @return the list the next victim is taken from, ListId::None if no frame is evictable */
+  auto VictimList() const -> ListId;
+
+  /** Target size of A1in. */
+  size_t kin_;
+  /** Maximum size of A1out. */
+  size_t kout_;
+  size_t current_timestamp_{0};
+  std::vector<FrameEntry> entries_;
+  FrameQueue a1in_;
+  FrameQueue am_;
+  GhostList a1out_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -40,6 +40,7 @@ class LogManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class TableVacuum;
 
 class ResultWriter {
  public:
@@ -210,13 +211,38 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /**
+   * Create the buffer pool on top of disk_manager_, or leave it as nullptr if the buffer pool manager is not
+   * implemented yet.
+   * @param num_bpm_instances number of shards of the buffer pool
+   * @param background_writer whether to start the background writer of the buffer pool
+   */
+  void MakeBufferPoolManager(size_t num_bpm_instances, bool background_writer);
+
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by a database file.
+   * @param db_file_name the database file
+   * @param num_bpm_instances number of shards of the buffer pool; more than one uses a ParallelBufferPoolManager
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t num_bpm_instances = 1);
 
-  BustubInstance();
+  /**
+   * Create an in-memory BusTub instance.
+   * @param num_bpm_instances number of shards of the buffer pool; more than one uses a ParallelBufferPoolManager
+   */
+  explicit BustubInstance(size_t num_bpm_instances = 1);
 
   ~BustubInstance();
 
+  /**
+   * Start the background vacuum of the tables, see TableVacuum. The vacuum is off by default: it moves tuples to new
+   * RIDs and relies on the table locks of the lock manager to keep running transactions away from them, so only start
+   * it once LockManager::LockTable and LockManager::LockRow really lock.
+   * @return false if there is no buffer pool to vacuum
+   */
+  auto StartTableVacuum() -> bool;
+
   /**
    * Execute a SQL query in the BusTub instance.
    */
@@ -252,6 +278,8 @@ class BustubInstance {
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
   ExecutionEngine *execution_engine_;
+  /** The background vacuum of the tables, nullptr until StartTableVacuum() is called. */
+  TableVacuum *table_vacuum_{nullptr};
   std::shared_mutex catalog_lock_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
@@ -269,7 +297,10 @@ class BustubInstance {
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
+  void CmdDisplayBufferPool(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  /** Resize the buffer pool for `SET buffer_pool_size = n`. Throws if n is not a valid size. */
+  void SetBufferPoolSize(const std::string &value);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
   std::unordered_map<std::string, std::string> session_variables_;
 };
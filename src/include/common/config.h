@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -27,6 +28,42 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The background writer of a buffer pool wakes up every BPM_WRITER_INTERVAL to clean dirty frames. */
+extern std::chrono::milliseconds bpm_writer_interval;
+
+/** The background writer only cleans frames while more than this fraction of the buffer pool is dirty. */
+extern double bpm_writer_dirty_ratio;
+
+/** Maximum number of dirty frames the background writer writes back in one round. */
+extern size_t bpm_writer_batch_size;
+
+/** Memory budget of the compressed victim cache of each buffer pool instance, in bytes. 0 disables the cache. */
+extern size_t bpm_victim_cache_bytes;
+
+/** A buffer pool gives up shrinking if the frames it takes away are still pinned after this long. */
+extern std::chrono::milliseconds bpm_resize_timeout;
+
+/** If true, buffer pools reuse deleted pages through a free page map stored in the database file. */
+extern bool bpm_free_page_map;
+
+/** DiskManagerPosix reserves space for the database file this many pages at a time. 0 grows it page by page. */
+extern size_t disk_extent_pages;
+
+/** Sequential scans ask the buffer pool to read this many pages ahead of the page they are on. 0 disables it. */
+extern size_t scan_read_ahead_distance;
+
+/** Inserts of at least this many tuples append them to fresh table pages in bulk, see TableHeap::BulkInsertTuples(). */
+extern size_t bulk_insert_threshold;
+
+/** The table vacuum wakes up every VACUUM_INTERVAL to compact the next stretch of table pages. */
+extern std::chrono::milliseconds vacuum_interval;
+
+/** Maximum number of table pages the vacuum looks at in one round. */
+extern size_t vacuum_batch_pages;
+
+/** The vacuum merges two adjacent table pages when their tuples take up at most this fraction of a page together. */
+extern double vacuum_merge_fill_ratio;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -35,7 +72,11 @@ static constexpr int BUSTUB_PAGE_SIZE = 4096;
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
-static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int LRUK_REPLACER_K = 10;          // lookback window for lru-k replacer
+static constexpr int SCAN_RING_SIZE = 32;           // max number of frames a buffer pool lends to sequential scans
+static constexpr int BPM_IO_WORKERS = 2;            // number of read-ahead threads of a buffer pool instance
+static constexpr int BPM_IO_QUEUE_SIZE = 64;        // max number of read-ahead requests queued per buffer pool instance
+static constexpr int OPTIMISTIC_READ_ATTEMPTS = 4;  // optimistic page reads tried before latching the page instead
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_format.h
+//
+// Identification: src/include/common/enums/table_format.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+//===--------------------------------------------------------------------===//
+// Table Formats
+//===--------------------------------------------------------------------===//
+enum class TableFormat : uint8_t {
+  ROW,  // slotted pages that store every tuple in one piece, see TablePage
+  PAX,  // pages that store every column in a minipage of its own, see PaxPage
+};
+
+}  // namespace bustub
+
+template <>
+struct fmt::formatter<bustub::TableFormat> : formatter<string_view> {
+  template <typename FormatContext>
+  auto format(bustub::TableFormat c, FormatContext &ctx) const {
+    string_view name;
+    switch (c) {
+      case bustub::TableFormat::ROW:
+        name = "row";
+        break;
+      case bustub::TableFormat::PAX:
+        name = "pax";
+        break;
+    }
+    return formatter<string_view>::format(name, ctx);
+  }
+};
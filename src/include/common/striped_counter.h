@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_counter.h
+//
+// Identification: src/include/common/striped_counter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+/**
+ * StripedCounters is a fixed set of statistics counters that many threads bump concurrently.
+ *
+ * A single atomic per counter would bounce its cache line between every core that updates it. Instead each counter
+ * is split into NUM_STRIPES copies, one cache line of copies per stripe, and a thread always adds to the stripe its
+ * id hashes to. Adding is a relaxed fetch_add on a line that is rarely shared; reading sums every stripe, which is
+ * slower but only done when someone asks for statistics. A sum taken while other threads are adding is not a
+ * consistent snapshot across counters.
+ */
+template <size_t NumCounters>
+class StripedCounters {
+ public:
+  /** Add delta to a counter. */
+  void Add(size_t counter, uint64_t delta = 1) {
+    stripes_[StripeOfThisThread()].values_[counter].fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  /** @return the current value of a counter */
+  auto Sum(size_t counter) const -> uint64_t {
+    uint64_t sum = 0;
+    for (const auto &stripe : stripes_) {
+      sum += stripe.values_[counter].load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  /** Set every counter back to zero. */
+  void Reset() {
+    for (auto &stripe : stripes_) {
+      for (auto &value : stripe.values_) {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t NUM_STRIPES = 16;
+
+  struct alignas(64) Stripe {
+    std::array<std::atomic<uint64_t>, NumCounters> values_{};
+  };
+
+  static auto StripeOfThisThread() -> size_t {
+    static thread_local size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % NUM_STRIPES;
+    return stripe;
+  }
+
+  std::array<Stripe, NUM_STRIPES> stripes_{};
+};
+
+}  // namespace bustub
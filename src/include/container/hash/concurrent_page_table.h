@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.h
+//
+// Identification: src/include/container/hash/concurrent_page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ConcurrentPageTable maps page ids to frame ids for the buffer pool.
+ *
+ * The table is split into a fixed number of segments, each of which is a linear-probing open-addressing array sized
+ * from the expected number of entries. Writers take the mutex of the segment the key hashes to, so writers of
+ * different segments never block each other. Readers take no lock at all: every segment carries a sequence counter
+ * that writers bump before and after a change, and a reader retries if the counter moved while it was probing.
+ *
+ * A key and its value are packed into a single 64-bit word so that readers always see a consistent entry. Deletion
+ * uses backward shifting, so the table never accumulates tombstones. A segment that fills up is copied into an array
+ * twice as large; old arrays are kept until the table is destroyed because lock-free readers may still be probing them.
+ */
+class ConcurrentPageTable {
+ public:
+  /**
+   * @brief Create a new ConcurrentPageTable.
+   * @param capacity the number of entries the table is expected to hold, e.g. the size of the buffer pool
+   */
+  explicit ConcurrentPageTable(size_t capacity);
+
+  /**
+   * @brief Find the frame that holds the given page. Never blocks.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page is in the table, false otherwise
+   */
+  auto Find(page_id_t page_id, frame_id_t &frame_id) const -> bool;
+
+  /**
+   * @brief Map the given page to the given frame, replacing any existing mapping of the page.
+   * @param page_id the page, must not be INVALID_PAGE_ID
+   * @param frame_id the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of the given page.
+   * @param page_id the page to remove
+   * @return true if the page was in the table, false otherwise
+   */
+  auto Remove(page_id_t page_id) -> bool;
+
+  /** @return the number of entries in the table */
+  auto Size() const -> size_t;
+
+ private:
+  /** A slot that does not hold an entry. Its key half is INVALID_PAGE_ID, which is never inserted. */
+  static constexpr uint64_t EMPTY_SLOT = UINT64_MAX;
+  /** Minimum number of slots in a segment. */
+  static constexpr size_t MIN_SEGMENT_SLOTS = 8;
+  /** Maximum number of segments in a table. */
+  static constexpr size_t MAX_SEGMENTS = 64;
+
+  struct SlotArray {
+    explicit SlotArray(size_t num_slots);
+
+    size_t mask_;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  };
+
+  struct Segment {
+    /** Odd while a writer is modifying the segment. */
+    std::atomic<uint64_t> version_{0};
+    /** The array readers probe. */
+    std::atomic<SlotArray *> array_{nullptr};
+    /** Every array this segment has used, the last one is current. */
+    std::vector<std::unique_ptr<SlotArray>> arrays_;
+    /** Number of entries in the segment. */
+    std::atomic<size_t> size_{0};
+    /** Serializes writers of this segment. */
+    std::mutex latch_;
+  };
+
+  static auto Pack(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto KeyOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto ValueOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & UINT32_MAX); }
+  static auto Hash(page_id_t page_id) -> uint64_t;
+
+  /** @return the segment a hash falls into. The low half of the hash picks the slot, the high half the segment. */
+  auto SegmentOf(uint64_t hash) const -> Segment & { return segments_[(hash >> 32) & (num_segments_ - 1)]; }
+
+  /** Copy every entry of the segment into an array twice as large. Caller must hold the segment latch. */
+  void Grow(Segment *segment);
+
+  /** Number of segments, always a power of two. */
+  size_t num_segments_;
+  std::unique_ptr<Segment[]> segments_;
+};
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -25,6 +26,10 @@ namespace bustub {
 /**
  * InsertExecutor executes an insert on a table.
  * Inserted values are always pulled from a child executor.
+ *
+ * Once the child has produced bulk_insert_threshold tuples, e.g. for a long VALUES list, the insert switches to bulk
+ * mode: it locks the whole table exclusively instead of every row, and appends the tuples a batch at a time with
+ * TableHeap::BulkInsertTuples().
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -55,8 +60,18 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Insert a batch of tuples, in bulk or one at a time, and add them to the table's indexes. */
+  void InsertTuples(const std::vector<Tuple> &tuples, bool bulk_insert);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+  /** The executor that produces the tuples to insert */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The table to insert into and its indexes */
+  TableInfo *table_info_{nullptr};
+  std::vector<IndexInfo *> indexes_;
+  /** Whether Next() has produced the count already */
+  bool is_done_{false};
 };
 
 }  // namespace bustub
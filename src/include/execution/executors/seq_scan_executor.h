@@ -16,13 +16,29 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/comparison_expression.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/page/pax_page.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * The table is read a page at a time. While the page is pinned and latched, the filter predicate, if the optimizer
+ * merged one into the scan, is evaluated on views of its tuples, and only the tuples that pass are copied out of the
+ * page, see TableHeap::GetPageTupleViews(). Next() hands those copies over until they run out, without copying them
+ * again. No latch is held between calls to Next(), so a parent may write to the page.
+ *
+ * Unless the transaction reads uncommitted data, Init() locks the table in S mode, or SIX if the transaction already
+ * writes to it, so that no row needs a lock of its own. Under READ_COMMITTED the S lock goes once the last page is read.
+ *
+ * A PAX table is read by column instead. The conjuncts of the predicate that compare a column with a constant run
+ * over the column's minipage, narrowing down the slots that pass; the other conjuncts run on the tuples that are left.
+ * Only the columns the plan above reads, see SeqScanPlanNode::column_ids_, and the ones the predicate needs are read;
+ * the others come out NULL.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -48,7 +64,50 @@ class SeqScanExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A conjunct of the filter predicate that compares a column with a constant. */
+  struct ColumnFilter {
+    const ComparisonExpression *comparison_;
+    uint32_t column_idx_;
+    Value constant_;
+    bool column_on_left_;
+  };
+
+  /** Read the next page, keeping the tuples that pass the filter predicate. */
+  void ReadPage();
+
+  /** Read the next page of a PAX table, see ReadPage(). */
+  void ReadPaxPage();
+
+  /** @return the slot in tuples_ to copy the next tuple of the page into */
+  auto NextTuple() -> Tuple *;
+
+  /** Sort the conjuncts of a predicate into column_filters_ and row_filters_. */
+  void SplitFilter(const AbstractExpression *predicate);
+
+  /** Keep the slots_ whose value in the filter's column passes it. */
+  void FilterColumn(PaxPage *page, const ColumnFilter &filter);
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table to scan */
+  TableInfo *table_info_{nullptr};
+  /** Views of the tuples of the page being read, kept to reuse their memory */
+  std::vector<TupleView> views_;
+  /** For a PAX table: the conjuncts of the predicate, whether to read each column, and the slots that pass so far */
+  std::vector<ColumnFilter> column_filters_;
+  std::vector<const AbstractExpression *> row_filters_;
+  std::vector<bool> read_columns_;
+  std::vector<uint32_t> slots_;
+  /** Whether Init() took an S lock that the end of the scan gives back */
+  bool unlock_table_{false};
+  /**
+   * The tuples of the page being scanned, the number of them, and the next one of them to produce. The slots past
+   * num_tuples_ keep their bytes, so that copying a page out allocates nothing once the slots are big enough.
+   */
+  std::vector<Tuple> tuples_;
+  size_t num_tuples_{0};
+  size_t cursor_{0};
+  /** The page to read once the tuples run out, INVALID_PAGE_ID after the last page */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
 };
 }  // namespace bustub
@@ -58,7 +58,7 @@ class ComparisonExpression : public AbstractExpression {
 
   ComparisonType comp_type_;
 
- private:
+  /** @return the result of comparing two values the way this expression does */
   auto PerformComparison(const Value &lhs, const Value &rhs) const -> CmpBool {
     switch (comp_type_) {
       case ComparisonType::Equal:
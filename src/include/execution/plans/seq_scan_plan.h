@@ -13,14 +13,17 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "fmt/ranges.h"
 
 namespace bustub {
 
@@ -33,13 +36,18 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * Construct a new SeqScanPlanNode instance.
    * @param output The output schema of this sequential scan plan node
    * @param table_oid The identifier of table to be scanned
+   * @param table_name The name of the table to be scanned
+   * @param filter_predicate The predicate the produced tuples must satisfy, nullptr for all tuples
+   * @param column_ids The columns the plan above reads, std::nullopt for all of them
    */
   SeqScanPlanNode(SchemaRef output, table_oid_t table_oid, std::string table_name,
-                  AbstractExpressionRef filter_predicate = nullptr)
+                  AbstractExpressionRef filter_predicate = nullptr,
+                  std::optional<std::vector<uint32_t>> column_ids = std::nullopt)
       : AbstractPlanNode(std::move(output), {}),
         table_oid_{table_oid},
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        column_ids_(std::move(column_ids)) {}
 
   /** @return The type of the plan node */
   auto GetType() const -> PlanType override { return PlanType::SeqScan; }
@@ -57,17 +65,22 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** The table name */
   std::string table_name_;
 
-  /** The predicate to filter in seqscan. It will ALWAYS be nullptr until you enable the MergeFilterScan rule.
-      You don't need to handle it to get a perfect score as of in Fall 2022.
-  */
+  /** The predicate to filter in seqscan, merged in by the MergeFilterScan rule. */
   AbstractExpressionRef filter_predicate_;
 
+  /**
+   * The columns the plan above reads, if the PruneScanColumns rule worked them out. The scan may leave the other
+   * columns of its output NULL, which lets it skip reading them from a PAX table.
+   */
+  std::optional<std::vector<uint32_t>> column_ids_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string columns = column_ids_ ? fmt::format(", columns={}", *column_ids_) : "";
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      return fmt::format("SeqScan {{ table={}, filter={}{} }}", table_name_, filter_predicate_, columns);
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{} }}", table_name_, columns);
   }
 };
 
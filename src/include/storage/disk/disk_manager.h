@@ -14,9 +14,12 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 
@@ -42,7 +45,7 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -58,6 +61,60 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read several pages with one request. Runs of consecutive pages are read with a single call, in page id order.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  virtual void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads);
+
+  /**
+   * Write several pages with one request.
+   * @param writes the pages to write, each with the data to write
+   */
+  virtual void WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes);
+
+  /** @return the number of pages in the database file, counting a partial page at the end as a page */
+  virtual auto GetNumPages() -> page_id_t;
+
+  /**
+   * Cut the database file down to its first num_pages pages. Pages past the end read as zeros afterwards, and writing
+   * one extends the file again.
+   * @param num_pages number of pages to keep
+   */
+  virtual void TruncatePages(page_id_t num_pages);
+
+  /** Called when an asynchronous page read or write completes, with false if it failed. */
+  using io_callback_fn = std::function<void(bool success)>;
+
+  /** A page read or write for SubmitIo(). */
+  struct AsyncIoRequest {
+    bool is_write_;
+    page_id_t page_id_;
+    /** The buffer to read into or write from. It must stay valid until the callback has run. */
+    char *data_;
+    io_callback_fn callback_;
+  };
+
+  /**
+   * Start a batch of page reads and writes. The callback of each request runs once its I/O is done, possibly on
+   * another thread and possibly before SubmitIo() returns. Requests of a batch may complete in any order.
+   * By default, the requests are carried out synchronously, one after the other.
+   * @param requests the reads and writes to start
+   */
+  virtual void SubmitIo(std::vector<AsyncIoRequest> requests);
+
+  /** Start reading a page, see SubmitIo(). */
+  void ReadPageAsync(page_id_t page_id, char *page_data, io_callback_fn callback);
+
+  /** Start writing a page, see SubmitIo(). */
+  void WritePageAsync(page_id_t page_id, const char *page_data, io_callback_fn callback);
+
+  /** Start reading a page. @return a future that tells whether the read succeeded */
+  auto ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /** Start writing a page. @return a future that tells whether the write succeeded */
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool>;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -94,6 +151,8 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
+  /** Open the log file that goes with file_name_. Returns false if file_name_ has no extension. */
+  auto OpenLog() -> bool;
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -101,7 +160,7 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
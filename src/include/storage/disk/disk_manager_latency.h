@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency.h
+//
+// Identification: src/include/storage/disk/disk_manager_latency.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** How fast a simulated storage device is. */
+struct DiskProfile {
+  /** Time from issuing a read until its data starts to arrive. */
+  std::chrono::microseconds read_latency_;
+  /** Time from issuing a write until it starts to be transferred. */
+  std::chrono::microseconds write_latency_;
+  /** Bytes per second the device transfers, shared by all I/Os in flight. 0 for no limit. */
+  uint64_t bandwidth_;
+  /** Maximum number of I/Os the device serves at once; more have to wait. 0 for no limit. */
+  size_t queue_depth_;
+  /** Whether an I/O that starts right where the previous one ended skips the latency, as on a spinning disk. */
+  bool sequential_skips_latency_;
+
+  /** A datacenter NVMe SSD. */
+  static auto Nvme() -> DiskProfile {
+    return {std::chrono::microseconds(80), std::chrono::microseconds(20), 3000ULL << 20, 64, false};
+  }
+
+  /** A SATA SSD. */
+  static auto SataSsd() -> DiskProfile {
+    return {std::chrono::microseconds(150), std::chrono::microseconds(60), 500ULL << 20, 32, false};
+  }
+
+  /** A 7200 rpm hard disk: an average seek and half a rotation per random I/O, one I/O at a time. */
+  static auto Hdd() -> DiskProfile {
+    return {std::chrono::microseconds(8000), std::chrono::microseconds(8000), 150ULL << 20, 1, true};
+  }
+};
+
+/**
+ * DiskManagerLatency wraps another disk manager, typically DiskManagerMemory or DiskManagerUnlimitedMemory, and makes
+ * every page read and write take as long as it would on the device described by a DiskProfile. Benchmarks then show
+ * what caching, prefetching and batching save, on any machine and without a real device.
+ *
+ * The device is simulated as a timeline: every I/O takes the queue slot that frees up first, waits for its latency,
+ * then for its turn on the shared transfer channel, and the caller sleeps until the I/O would be done. A run of
+ * consecutive pages in ReadPages() or WritePages() is one I/O. The I/Os of a batch, whether from ReadPages(),
+ * WritePages() or SubmitIo(), are all issued at once and overlap as far as the queue depth allows.
+ *
+ * The log is not simulated; give the log manager the wrapped disk manager.
+ */
+class DiskManagerLatency : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that delays the I/O of another one.
+   * @param disk_manager the disk manager that does the I/O, which must outlive this one
+   * @param profile the device to simulate
+   */
+  DiskManagerLatency(DiskManager *disk_manager, const DiskProfile &profile);
+
+  /** Shut down the wrapped disk manager. */
+  void ShutDown() override;
+
+  /**
+   * Write a page, taking as long as the device would.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page, taking as long as the device would.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Read several pages, all in flight at once.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override;
+
+  /**
+   * Write several pages, all in flight at once.
+   * @param writes the pages to write, each with the data to write
+   */
+  void WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) override;
+
+  /**
+   * Carry out a batch of reads and writes, all in flight at once. The callbacks run on the calling thread, each once
+   * its I/O would be done.
+   * @param requests the reads and writes to carry out
+   */
+  void SubmitIo(std::vector<AsyncIoRequest> requests) override;
+
+  /** @return the number of pages in the wrapped database file */
+  auto GetNumPages() -> page_id_t override { return disk_manager_->GetNumPages(); }
+
+  /** Cut the wrapped database file down to its first num_pages pages. */
+  void TruncatePages(page_id_t num_pages) override { disk_manager_->TruncatePages(num_pages); }
+
+  /** @return the number of page reads, counting every page of a batch */
+  auto GetNumReads() const -> int { return num_reads_; }
+
+  /** @return the total time the device was simulated to be busy transferring data */
+  auto GetTransferTime() -> std::chrono::microseconds;
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  /** A run of consecutive pages read or written with one I/O. */
+  struct Run {
+    page_id_t first_page_id_;
+    size_t num_pages_;
+    bool is_write_;
+  };
+
+  /** Place an I/O issued now on the device's timeline. Caller must hold latch_. @return when it will be done */
+  auto Schedule(const Run &run, clock::time_point now) -> clock::time_point;
+
+  /** Place the runs of consecutive pages among page_ids on the timeline. @return when all of them will be done */
+  auto ScheduleBatch(std::vector<page_id_t> page_ids, bool is_write) -> clock::time_point;
+
+  DiskManager *disk_manager_;
+  const DiskProfile profile_;
+  std::atomic<int> num_reads_{0};
+
+  /** Protects the timeline. */
+  std::mutex latch_;
+  /** When each queue slot is free again. Empty if the queue depth is not limited. */
+  std::vector<clock::time_point> slot_free_;
+  /** When the transfer channel is free again. */
+  clock::time_point channel_free_;
+  /** The page after the last one transferred, to recognize sequential I/O. */
+  page_id_t next_sequential_page_id_{INVALID_PAGE_ID};
+  clock::duration transfer_time_{0};
+};
+
+}  // namespace bustub
@@ -52,6 +52,16 @@ class DiskManagerMemory : public DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data) override;
 
+  /**
+   * Read several pages from the database file.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override {
+    for (const auto &[page_id, page_data] : reads) {
+      ReadPage(page_id, page_data);
+    }
+  }
+
  private:
   char *memory_;
 };
@@ -106,6 +116,16 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
   }
 
+  /**
+   * Read several pages from the database file.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override {
+    for (const auto &[page_id, page_data] : reads) {
+      ReadPage(page_id, page_data);
+    }
+  }
+
  private:
   std::mutex mutex_;
   using Page = std::array<char, BUSTUB_PAGE_SIZE>;
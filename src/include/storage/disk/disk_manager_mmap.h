@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.h
+//
+// Identification: src/include/storage/disk/disk_manager_mmap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerMmap serves reads of the database file from a shared read-only memory mapping of the file, for
+ * read-mostly deployments: a read of a page the kernel has cached is a memcpy instead of a system call.
+ *
+ * The disk manager reserves address space for max_mapped_bytes up front and maps the file into it as the file grows,
+ * one extent at a time, so the mapping never moves. Writes still go through pwrite(); the
+ * mapping shares the kernel's page cache, so it sees them right away. Pages beyond the reservation are read with
+ * pread() as by DiskManagerPosix. A read holds a shared latch while it copies out of the mapping, which TruncatePages()
+ * takes exclusively: touching a page that was truncated away would raise SIGBUS.
+ *
+ * Read-only consumers can also look at a page in place through GetMappedPage(), without copying it at all.
+ */
+class DiskManagerMmap : public DiskManagerPosix {
+ public:
+  /** The mapping grows by at least this many bytes at a time. */
+  static constexpr size_t MAP_EXTENT_SIZE = 1 << 20;
+
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param max_mapped_bytes address space to reserve for the mapping
+   * @param fsync_policy when written pages are forced to stable storage
+   */
+  explicit DiskManagerMmap(const std::string &db_file, size_t max_mapped_bytes = size_t{1} << 32,
+                           FsyncPolicy fsync_policy = FsyncPolicy::Never);
+
+  ~DiskManagerMmap() override;
+
+  /** Unmap the file and close all the file resources. */
+  void ShutDown() override;
+
+  /**
+   * Read a page from the mapping. Whatever lies past the end of the file reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Read several pages from the mapping. Pages that are not mapped are read with preadv() as by DiskManagerPosix.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override;
+
+  /**
+   * Shrink the database file, once the reads from the mapping in progress are done.
+   * @param num_pages the number of pages to keep
+   */
+  void TruncatePages(page_id_t num_pages) override;
+
+  /**
+   * Look at a page in the mapping without copying it. The memory stays valid until the disk manager shuts down or the
+   * page is truncated away, and reflects later writes of the page. It must not be written to, and the caller must keep
+   * TruncatePages() from running while it looks.
+   * @param page_id id of the page
+   * @return the page, nullptr if it is past the end of the file or beyond the reservation
+   */
+  auto GetMappedPage(page_id_t page_id) -> const char *;
+
+  /** @return the number of bytes of the file that are mapped */
+  auto GetMappedBytes() const -> size_t { return mapped_bytes_; }
+
+ private:
+  /** Extend the mapping to cover at least the first size bytes of the file, as far as the reservation allows. */
+  void GrowMapping(size_t size);
+
+  /** Start of the reserved address space, nullptr if it could not be reserved. */
+  char *base_{nullptr};
+  size_t max_mapped_bytes_;
+  /** Number of bytes of the file mapped at base_. Only grows. */
+  std::atomic<size_t> mapped_bytes_{0};
+  /** Serializes growing the mapping. */
+  std::mutex map_latch_;
+  /** Held shared while copying out of the mapping, and exclusively while truncating the file. */
+  std::shared_mutex truncate_latch_;
+};
+
+}  // namespace bustub
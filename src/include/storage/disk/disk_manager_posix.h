@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** When DiskManagerPosix forces written pages to stable storage. */
+enum class FsyncPolicy {
+  /** Never; write-back is left to the operating system, as with DiskManager. */
+  Never,
+  /** After every page write. */
+  EveryWrite,
+  /** After every sync_interval page writes, and on Sync() and ShutDown(). */
+  Periodic,
+};
+
+/**
+ * DiskManagerPosix reads and writes pages of the database file through a plain file descriptor with pread() and
+ * pwrite(). Both take the file offset as an argument, so there is no shared cursor to protect, and page I/O takes no
+ * lock at all: any number of buffer pool threads can have reads and writes in flight at once, and the kernel orders
+ * them per page. The size of the file is tracked in memory instead of asking the file system on every read.
+ *
+ * Rather than let every page written past the end extend the file on its own, the disk manager reserves disk space
+ * disk_extent_pages pages at a time with fallocate(), so that the file stays contiguous and the file system allocates
+ * blocks once per extent. The reservation does not change the size of the file, which therefore still tells how many
+ * pages are in use when the file is opened again; the end of the reserved space is tracked separately.
+ *
+ * The log is handled by DiskManager as before.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param fsync_policy when written pages are forced to stable storage
+   * @param sync_interval number of page writes between two syncs under FsyncPolicy::Periodic
+   * @param with_log whether there is a log file next to the database file; a data file of a tablespace has none
+   */
+  explicit DiskManagerPosix(const std::string &db_file, FsyncPolicy fsync_policy = FsyncPolicy::Never,
+                            size_t sync_interval = 64, bool with_log = true);
+
+  ~DiskManagerPosix() override;
+
+  /** Sync the database file if the policy asks for it, then close all the file resources. */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file. Whatever lies past the end of the file reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Read several pages, each run of consecutive pages with a single preadv() straight into the buffers.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override;
+
+  /** @return the number of pages in the database file */
+  auto GetNumPages() -> page_id_t override;
+
+  /**
+   * Cut the database file down to its first num_pages pages.
+   * @param num_pages number of pages to keep
+   */
+  void TruncatePages(page_id_t num_pages) override;
+
+  /** Force every page written so far to stable storage. */
+  void Sync();
+
+  /** @return the number of times the database file was synced */
+  auto GetNumSyncs() const -> size_t { return num_syncs_; }
+
+  /** @return the size of the database file in bytes, up to the end of the last page written */
+  auto GetDbFileSize() const -> int64_t { return file_size_; }
+
+  /** @return the number of bytes of disk space reserved for the database file, at least its size */
+  auto GetAllocatedSize() const -> int64_t { return std::max<int64_t>(allocated_size_, file_size_); }
+
+ protected:
+  /** Called before a page write at the given offset: reserves the extent the page falls in if it is not yet. */
+  void ReserveExtent(int64_t offset);
+
+  /** Called once a page write at the given offset is complete: grows the file size and syncs as the policy says. */
+  void OnPageWritten(int64_t offset);
+
+  int fd_{-1};
+
+ private:
+  const FsyncPolicy fsync_policy_;
+  const size_t sync_interval_;
+  /** A page written past the end extends the file; only TruncatePages() shrinks it. */
+  std::atomic<int64_t> file_size_{0};
+  /** Page writes since the last sync, for FsyncPolicy::Periodic. */
+  std::atomic<size_t> writes_since_sync_{0};
+  std::atomic<size_t> num_syncs_{0};
+  /** Size of an extent in bytes, 0 if space is not reserved ahead or the file system cannot reserve it. */
+  std::atomic<int64_t> extent_size_;
+  /** End of the space reserved for the file. Only grows, except in TruncatePages(). */
+  std::atomic<int64_t> allocated_size_{0};
+  /** Serializes reserving extents. */
+  std::mutex extent_latch_;
+};
+
+}  // namespace bustub
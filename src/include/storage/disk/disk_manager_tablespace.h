@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_tablespace.h
+//
+// Identification: src/include/storage/disk/disk_manager_tablespace.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerTablespace spreads the pages of a database over several data files, e.g. on different devices, behind
+ * the plain DiskManager interface: the buffer pool keeps addressing pages by page_id_t.
+ *
+ * Pages are striped over the files stripe_pages at a time: stripe s of the page id space goes to file s % num_files,
+ * where it sits right after the stripes that file already holds, so every file stays dense.
+ *
+ * Every file has its own I/O queue, served by a thread of its own. A batch of reads or writes that spans several files
+ * is split up and the parts run on the files' queues at the same time, so the bandwidth of the devices adds up. A
+ * single page I/O, or a batch that only touches one file, is carried out by the calling thread.
+ *
+ * The log lives next to the first data file.
+ */
+class DiskManagerTablespace : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager over the given data files, each read and written by a DiskManagerPosix.
+   * @param db_files the data files; the log file is named after the first one
+   * @param stripe_pages number of consecutive pages that go to the same file
+   * @param fsync_policy when written pages are forced to stable storage
+   */
+  explicit DiskManagerTablespace(const std::vector<std::string> &db_files, size_t stripe_pages = 16,
+                                 FsyncPolicy fsync_policy = FsyncPolicy::Never);
+
+  /**
+   * Creates a new disk manager over data files served by the given disk managers. There is no log.
+   * @param files the disk managers of the data files, which must outlive this one
+   * @param stripe_pages number of consecutive pages that go to the same file
+   */
+  explicit DiskManagerTablespace(const std::vector<DiskManager *> &files, size_t stripe_pages = 16);
+
+  ~DiskManagerTablespace() override;
+
+  /** Stop the I/O queues and shut down every data file. */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the data file it belongs to.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the data file it belongs to.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Read several pages, from all the data files they belong to at once.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override;
+
+  /**
+   * Write several pages, to all the data files they belong to at once.
+   * @param writes the pages to write, each with the data to write
+   */
+  void WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) override;
+
+  /**
+   * Queue a batch of reads and writes on the I/O queues of their data files. The callbacks run on the queues'
+   * threads, so they should be short, and must neither submit nor wait for other I/O of this disk manager.
+   * @param requests the reads and writes to start
+   */
+  void SubmitIo(std::vector<AsyncIoRequest> requests) override;
+
+  /** @return one past the highest page id any of the data files holds */
+  auto GetNumPages() -> page_id_t override;
+
+  /**
+   * Cut every data file down to the pages with an id below num_pages.
+   * @param num_pages number of pages to keep
+   */
+  void TruncatePages(page_id_t num_pages) override;
+
+  /** @return the number of data files */
+  auto GetNumFiles() const -> size_t { return files_.size(); }
+
+  /** @return the data file a page belongs to */
+  auto FileOf(page_id_t page_id) const -> size_t { return (page_id / stripe_pages_) % files_.size(); }
+
+  /** @return where a page sits within its data file */
+  auto LocalPageId(page_id_t page_id) const -> page_id_t {
+    return page_id / stripe_pages_ / static_cast<page_id_t>(files_.size()) * stripe_pages_ + page_id % stripe_pages_;
+  }
+
+ private:
+  /** The I/O queue of a data file. */
+  struct FileQueue {
+    std::deque<AsyncIoRequest> requests_;
+    bool stop_{false};
+    std::mutex latch_;
+    std::condition_variable cv_;
+    std::thread thread_;
+  };
+
+  /** Start the I/O queue of every data file. */
+  void StartQueues();
+
+  /** Body of the thread of a file's I/O queue: carries out whatever is queued, a batch at a time. */
+  void ServeQueue(size_t file_index);
+
+  /** @return the page id of the local_page_id-th page of a data file */
+  auto GlobalPageId(size_t file_index, page_id_t local_page_id) const -> page_id_t {
+    auto num_files = static_cast<page_id_t>(files_.size());
+    return (local_page_id / stripe_pages_ * num_files + static_cast<page_id_t>(file_index)) * stripe_pages_ +
+           local_page_id % stripe_pages_;
+  }
+
+  /** Queue a batch of requests and wait until all of them are done. */
+  void SubmitAndWait(std::vector<AsyncIoRequest> requests);
+
+  const page_id_t stripe_pages_;
+  /** The data files, and the ones this disk manager created itself. */
+  std::vector<DiskManager *> files_;
+  std::vector<std::unique_ptr<DiskManager>> owned_files_;
+  std::vector<std::unique_ptr<FileQueue>> queues_;
+};
+
+}  // namespace bustub
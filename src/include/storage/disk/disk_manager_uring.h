@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerUring submits page reads and writes to the kernel through a Linux io_uring, so that a single thread can
+ * keep many I/Os in flight. The ring is set up with raw system calls; no library is needed.
+ *
+ * SubmitIo() puts a whole batch into the submission queue with one system call and returns; a completion thread reaps
+ * the completion queue and runs the callbacks. ReadPages() and WritePages() submit their pages together and wait, so
+ * the buffer pool's batch fetch and background writer get all their pages in flight at once. ReadPage() is a
+ * ReadPages() of one page; WritePage() stays a synchronous pwrite() call.
+ *
+ * If the kernel does not offer io_uring, e.g. because it is too old or a sandbox forbids it, the disk manager behaves
+ * exactly like DiskManagerPosix: requests are carried out synchronously by the submitting thread.
+ */
+class DiskManagerUring : public DiskManagerPosix {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param queue_depth number of entries of the submission queue, 0 to not use io_uring at all
+   * @param fsync_policy when written pages are forced to stable storage
+   * @param sync_interval number of page writes between two syncs under FsyncPolicy::Periodic
+   */
+  explicit DiskManagerUring(const std::string &db_file, uint32_t queue_depth = 64,
+                            FsyncPolicy fsync_policy = FsyncPolicy::Never, size_t sync_interval = 64);
+
+  ~DiskManagerUring() override;
+
+  /** Wait for the I/Os in flight, tear the ring down and close all the file resources. */
+  void ShutDown() override;
+
+  /**
+   * Start a batch of page reads and writes through the ring. Callbacks run on the completion thread, so they should
+   * be short, and must neither submit nor wait for other asynchronous I/O of this disk manager.
+   * @param requests the reads and writes to start
+   */
+  void SubmitIo(std::vector<AsyncIoRequest> requests) override;
+
+  /**
+   * Read several pages, all in flight at once.
+   * @param reads the pages to read, each with the buffer to read it into
+   */
+  void ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) override;
+
+  /**
+   * Write several pages, all in flight at once.
+   * @param writes the pages to write, each with the data to write
+   */
+  void WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) override;
+
+  /** @return true if I/O goes through io_uring, false if the disk manager fell back to synchronous I/O */
+  auto IsAsync() const -> bool { return ring_fd_ >= 0; }
+
+ private:
+  /** A request in flight. The kernel hands its address back in the completion. */
+  struct InFlight;
+
+  /** Set up the ring. Leaves ring_fd_ at -1 if the kernel does not cooperate. */
+  void SetUpRing(uint32_t queue_depth);
+
+  /** Unmap and close the ring. */
+  void TearDownRing();
+
+  /** Put a request into the submission queue, or a no-op if request is nullptr. Caller must hold submit_latch_. */
+  void PushRequest(InFlight *request);
+
+  /** Hand the last to_submit queued entries to the kernel. Caller must hold submit_latch_. */
+  void Enter(uint32_t to_submit);
+
+  /** Submit a batch and wait until all of it is done. */
+  void SubmitAndWait(std::vector<AsyncIoRequest> requests);
+
+  /** Body of the completion thread. */
+  void ReapCompletions();
+
+  /** Finish a request whose completion carried result res. Runs on the completion thread. */
+  void Complete(InFlight *request, int res);
+
+  int ring_fd_{-1};
+  /** The rings shared with the kernel, and where their fields are. */
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+  uint32_t *sq_tail_{nullptr};
+  uint32_t *sq_mask_{nullptr};
+  uint32_t *sq_array_{nullptr};
+  uint32_t *cq_head_{nullptr};
+  uint32_t *cq_tail_{nullptr};
+  uint32_t *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+  uint32_t sq_entries_{0};
+  uint32_t cq_entries_{0};
+
+  /** Serializes submitters; the submission queue has a single producer. */
+  std::mutex submit_latch_;
+  /** Number of requests submitted and not yet completed. Protected by submit_latch_. */
+  uint32_t num_in_flight_{0};
+  /** Signalled when requests complete, for submitters waiting for room in the completion queue. */
+  std::condition_variable in_flight_cv_;
+  std::thread *reaper_thread_{nullptr};
+};
+
+}  // namespace bustub
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.h
+//
+// Identification: src/include/storage/disk/free_page_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <set>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * FreePageMap keeps track of the pages of the database file that were deleted, so that new pages reuse them before
+ * the file grows, and so that free pages at the end of the file can be cut off.
+ *
+ * The map is a bitmap with one bit per page, set if the page is free. It is stored in the database file itself: the
+ * file is divided into ranges of PAGES_PER_MAP_PAGE pages, and the second page of each range holds the bitmap of the
+ * range. The first page of the file stays the header page. Map pages are read and written directly through the disk
+ * manager, never through a buffer pool, and the map recovers its state from them when it is created.
+ *
+ * The map is written back so that a crash can leak free pages but never hand out a page twice: taking a page off the
+ * map writes its map page right away, while freeing a page only marks the map page dirty until Flush().
+ *
+ * The buffer pool instances of a ParallelBufferPoolManager share one map; each instance only gets pages with
+ * page_id % num_instances == instance_index, as without the map.
+ */
+class FreePageMap {
+ public:
+  /** Bytes at the start of a map page that identify it. */
+  static constexpr size_t MAP_PAGE_HEADER_SIZE = 8;
+  /** Number of pages a map page keeps track of. */
+  static constexpr page_id_t PAGES_PER_MAP_PAGE = (BUSTUB_PAGE_SIZE - MAP_PAGE_HEADER_SIZE) * 8;
+  /** Marks a page as a map page. */
+  static constexpr uint32_t MAP_PAGE_MAGIC = 0x50414d46;
+
+  /**
+   * Create the free page map of a database file, loading whatever map the file already has.
+   * @param disk_manager the disk manager of the database file
+   * @param num_instances number of buffer pool instances that allocate pages from the map
+   * @throws Exception if a page where a map page belongs holds something else
+   */
+  explicit FreePageMap(DiskManager *disk_manager, uint32_t num_instances = 1);
+
+  /** Write the map back. */
+  ~FreePageMap();
+
+  /** @return true if the page holds part of the map, so that it must never be handed out */
+  static auto IsMapPage(page_id_t page_id) -> bool { return page_id % PAGES_PER_MAP_PAGE == 1; }
+
+  /**
+   * Hand out a page: the free page with the lowest id, or else a page past the end of the file.
+   * @param instance_index the buffer pool instance asking, which only gets pages with a matching id
+   * @return the id of the page
+   */
+  auto AllocatePage(uint32_t instance_index = 0) -> page_id_t;
+
+  /**
+   * Mark a page as free. Freeing a page twice, a map page or a page that was never handed out does nothing.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if the page is free */
+  auto IsFree(page_id_t page_id) -> bool;
+
+  /** @return the number of free pages */
+  auto GetNumFreePages() -> size_t;
+
+  /** @return one past the highest page id handed out so far, map pages included */
+  auto GetNumPages() -> page_id_t;
+
+  /**
+   * Cut the free pages at the end of the database file off, together with map pages that no longer cover any page.
+   * @return the number of pages the file lost
+   */
+  auto TruncateFreePages() -> page_id_t;
+
+  /** Write every map page that changed back to the database file. */
+  void Flush();
+
+ private:
+  using MapPage = std::array<char, BUSTUB_PAGE_SIZE>;
+
+  /** @return the number of ranges that hold pages below num_pages */
+  static auto NumRanges(page_id_t num_pages) -> size_t {
+    return static_cast<size_t>((num_pages + PAGES_PER_MAP_PAGE - 1) / PAGES_PER_MAP_PAGE);
+  }
+
+  /** @return true if the bit of the page is set. Caller must hold latch_. */
+  auto TestBit(page_id_t page_id) const -> bool;
+
+  /** Set or clear the bit of the page and mark its map page dirty. Caller must hold latch_. */
+  void SetBit(page_id_t page_id, bool is_free);
+
+  /** Add or drop map pages: one for every range that holds pages below num_pages. Caller must hold latch_. */
+  void ResizeMap(page_id_t num_pages);
+
+  /** Write a map page back if it is dirty. Caller must hold latch_. */
+  void WriteMapPage(size_t range);
+
+  DiskManager *disk_manager_;
+  const uint32_t num_instances_;
+  /** One past the highest page id handed out. */
+  page_id_t num_pages_{0};
+  /** The map pages, one per range, and whether they changed since they were last written. */
+  std::vector<MapPage> map_pages_;
+  std::vector<bool> dirty_;
+  /** The free pages of every instance, by page_id % num_instances_, lowest first. */
+  std::vector<std::set<page_id_t>> free_pages_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
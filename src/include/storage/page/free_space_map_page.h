@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * A page of the free space map of a table heap, see FreeSpaceMap. The pages of a map form a singly-linked list.
+ *
+ * Format (size in bytes):
+ *  ----------------------------------------------------------------------------------------------------
+ *  | PageHeader (8) | Magic (4) | NextPageId (4) | EntryCount (4) | PageId_1 (4) | ... | PageId_n (4) |
+ *  ----------------------------------------------------------------------------------------------------
+ *  -----------------------------------------
+ *  | Category_1 (1) | ... | Category_n (1) |
+ *  -----------------------------------------
+ *
+ * The page header is left to the Page, e.g. for its LSN, as in a TablePage. Entry i says that the heap page PageId_i
+ * has at least Category_i * FreeSpaceMap::BYTES_PER_CATEGORY free bytes.
+ */
+class FreeSpaceMapPage : public Page {
+ public:
+  /** Marks a page as a free space map page. */
+  static constexpr uint32_t MAGIC = 0x4d505346;
+  /** Number of entries that fit in a page. */
+  static constexpr uint32_t MAX_ENTRIES = (BUSTUB_PAGE_SIZE - SIZE_PAGE_HEADER - 12) / (sizeof(page_id_t) + 1);
+
+  /** Initialize an empty map page. */
+  void Init() {
+    uint32_t magic = MAGIC;
+    memcpy(GetData() + OFFSET_MAGIC, &magic, sizeof(uint32_t));
+    SetNextPageId(INVALID_PAGE_ID);
+    SetEntryCount(0);
+  }
+
+  /** @return true if the page was initialized as a map page */
+  auto IsMapPage() -> bool { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_MAGIC) == MAGIC; }
+
+  /** @return the page ID of the next map page */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page ID of the next map page. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of entries in this page */
+  auto GetEntryCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ENTRY_COUNT); }
+
+  /** Set the number of entries in this page. */
+  void SetEntryCount(uint32_t entry_count) {
+    memcpy(GetData() + OFFSET_ENTRY_COUNT, &entry_count, sizeof(uint32_t));
+  }
+
+  /** @return the heap page of entry i */
+  auto GetPageId(uint32_t i) -> page_id_t {
+    return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_ENTRIES + sizeof(page_id_t) * i);
+  }
+
+  /** @return the free space category of entry i */
+  auto GetCategory(uint32_t i) -> uint8_t {
+    return static_cast<uint8_t>(GetData()[OFFSET_ENTRIES + sizeof(page_id_t) * MAX_ENTRIES + i]);
+  }
+
+  /** Set entry i, growing the entry count to cover it. */
+  void SetEntry(uint32_t i, page_id_t page_id, uint8_t category) {
+    memcpy(GetData() + OFFSET_ENTRIES + sizeof(page_id_t) * i, &page_id, sizeof(page_id_t));
+    GetData()[OFFSET_ENTRIES + sizeof(page_id_t) * MAX_ENTRIES + i] = static_cast<char>(category);
+    if (i >= GetEntryCount()) {
+      SetEntryCount(i + 1);
+    }
+  }
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_MAGIC = SIZE_PAGE_HEADER;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = SIZE_PAGE_HEADER + 4;
+  static constexpr size_t OFFSET_ENTRY_COUNT = SIZE_PAGE_HEADER + 8;
+  static constexpr size_t OFFSET_ENTRIES = SIZE_PAGE_HEADER + 12;
+};
+
+}  // namespace bustub
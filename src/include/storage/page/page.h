@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -49,10 +50,16 @@ class Page {
   inline auto IsDirty() -> bool { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    BeginUpdate();
+  }
 
-  /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  /** Release the page write latch. Bumps the page version, so optimistic reads that overlapped the writer fail. */
+  inline void WUnlatch() {
+    EndUpdate();
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -66,6 +73,19 @@ class Page {
   /** Sets the page LSN. */
   inline void SetLSN(lsn_t lsn) { memcpy(GetData() + OFFSET_LSN, &lsn, sizeof(lsn_t)); }
 
+  /**
+   * Start an optimistic read of the page, which takes neither a pin nor the latch. Everything read from the page
+   * before ValidateVersion() succeeds may be torn by a concurrent writer and must be treated as garbage.
+   * @return the version to pass to ValidateVersion(); odd while a writer holds the write latch
+   */
+  inline auto GetVersion() const -> uint64_t { return version_.load(std::memory_order_acquire); }
+
+  /** @return true if no writer has touched the page since GetVersion() returned version */
+  inline auto ValidateVersion(uint64_t version) const -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) == 0 && version_.load(std::memory_order_relaxed) == version;
+  }
+
  protected:
   static_assert(sizeof(page_id_t) == 4);
   static_assert(sizeof(lsn_t) == 4);
@@ -78,6 +98,15 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
+  /** Make the version odd before changing the page, the way a sequence lock does. */
+  inline void BeginUpdate() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /** Make the version even again once the change is complete. */
+  inline void EndUpdate() { version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
   /** The actual data that is stored within a page. */
   char data_[BUSTUB_PAGE_SIZE]{};
   /** The ID of this page. */
@@ -88,6 +117,11 @@ class Page {
   bool is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /**
+   * Bumped when the page is write latched and again when it is released, and likewise when the buffer pool puts
+   * another page into the frame. Odd while the page is being changed.
+   */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
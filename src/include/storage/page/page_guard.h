@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/storage/page/page_guard.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * PageGuard holds a page that is pinned and read-latched, and unlatches and unpins it when the guard is released or
+ * destroyed. Whatever points into the page, e.g. a TupleView, stays valid exactly as long as the guard holds the page.
+ *
+ * Since the latch is held, a guard must be released before its thread writes to the same page.
+ */
+class PageGuard {
+ public:
+  /** Create a guard that holds no page. */
+  PageGuard() = default;
+
+  /**
+   * Take over a page.
+   * @param buffer_pool_manager the buffer pool manager the page was fetched from
+   * @param page the page, which the caller has pinned and read-latched
+   */
+  PageGuard(BufferPoolManager *buffer_pool_manager, Page *page)
+      : buffer_pool_manager_(buffer_pool_manager), page_(page) {}
+
+  PageGuard(const PageGuard &) = delete;
+  auto operator=(const PageGuard &) -> PageGuard & = delete;
+
+  PageGuard(PageGuard &&other) noexcept : buffer_pool_manager_(other.buffer_pool_manager_), page_(other.page_) {
+    other.page_ = nullptr;
+  }
+
+  auto operator=(PageGuard &&other) noexcept -> PageGuard & {
+    if (this != &other) {
+      Release();
+      buffer_pool_manager_ = other.buffer_pool_manager_;
+      page_ = other.page_;
+      other.page_ = nullptr;
+    }
+    return *this;
+  }
+
+  ~PageGuard() { Release(); }
+
+  /** Unlatch and unpin the page, if the guard holds one. */
+  void Release() {
+    if (page_ != nullptr) {
+      page_->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+      page_ = nullptr;
+    }
+  }
+
+  /** @return the page, nullptr if the guard holds none */
+  auto GetPage() const -> Page * { return page_; }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  Page *page_{nullptr};
+};
+
+}  // namespace bustub
@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+#include "recovery/log_manager.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * PAX page format: the tuples of the page are split up by column, and every column has a minipage of its own where its
+ * values sit next to each other, one fixed-width entry per slot. A scan that needs a few columns only reads their
+ * minipages.
+ *
+ *  Header format (size in bytes):
+ *  --------------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| Magic (4)| TupleCount (4)| UsedCount (4) |
+ *  --------------------------------------------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------
+ *  | Capacity (4)| ColumnCount (4)| Column_1 type (4)| Column_1 width (4)| Column_1 offset (4)| ... |
+ *  ---------------------------------------------------------------------------------------------
+ *
+ *  Body format:
+ *  ---------------------------------------------------------------------------------
+ *  | Slot_1 state (1)| ... | Slot_capacity state (1)| MINIPAGE_1 | ... | MINIPAGE_n |
+ *  ---------------------------------------------------------------------------------
+ *
+ * The first 16 bytes are laid out as in a TablePage, so a table heap links and walks PAX pages the same way. The
+ * magic sits where a TablePage keeps its free space pointer, which never exceeds the page size; a TablePage forwards
+ * its tuple operations to the PaxPage it turns out to be.
+ *
+ * An inlined column stores its values the way a tuple does. A VARCHAR column stores the length and the bytes of a
+ * value, with room for the longest value the column is declared to hold; a longer value does not fit the page.
+ * The layout is fixed by the schema the page is initialized with, so every page of a table has the same capacity.
+ */
+class PaxPage : public Page {
+ public:
+  /** Marks a page as a PAX page. */
+  static constexpr uint32_t MAGIC = 0x50415850;
+  static_assert(MAGIC > BUSTUB_PAGE_SIZE);
+
+  /** @return the width of the entries of a column in its minipage */
+  static auto GetColumnWidth(const Column &column) -> uint32_t {
+    // A VARCHAR value carries its terminating '\0'.
+    return column.IsInlined() ? column.GetFixedLength() : sizeof(uint32_t) + column.GetVariableLength() + 1;
+  }
+
+  /** @return the number of bytes a tuple of the schema takes up in a page, counting its slot state */
+  static auto GetSpaceNeeded(const Schema &schema) -> uint32_t;
+
+  /** @return the number of tuples of the schema a page holds, 0 if a tuple does not fit a page at all */
+  static auto GetCapacity(const Schema &schema) -> uint32_t;
+
+  /** @return true if the values of the tuple, laid out by the schema, fit their entries */
+  static auto IsStorable(const Tuple &tuple, const Schema &schema) -> bool;
+
+  /**
+   * Initialize the PaxPage header and lay out the minipages.
+   * @param page_id the page ID of this page
+   * @param prev_page_id the previous table page ID
+   * @param schema the schema of the tuples the page holds, which must fit at least one of them
+   * @param log_manager the log manager in use
+   * @param txn the transaction that this page is created in
+   */
+  void Init(page_id_t page_id, page_id_t prev_page_id, const Schema &schema, LogManager *log_manager,
+            Transaction *txn);
+
+  /** @return the page ID of this page */
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return true if the page was initialized as a PaxPage */
+  auto IsPaxPage() -> bool { return GetField(OFFSET_MAGIC) == MAGIC; }
+
+  /**
+   * Insert a tuple into the page.
+   * @param tuple tuple to insert
+   * @param[out] rid rid of the inserted tuple
+   * @return true if the insert is successful, false if the page is full or the tuple does not fit the layout
+   */
+  auto InsertTuple(const Tuple &tuple, RID *rid) -> bool;
+
+  /** Mark the tuple as deleted, see TablePage::MarkDelete(). @return true if the tuple was there to delete */
+  auto MarkDelete(const RID &rid) -> bool;
+
+  /**
+   * Update a tuple in place.
+   * @param new_tuple new value of the tuple
+   * @param[out] old_tuple old value of the tuple
+   * @param rid rid of the tuple
+   * @return true if updated, false if the tuple is not there or the new value does not fit the layout
+   */
+  auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid) -> bool;
+
+  /** Free the slot of a deleted tuple, or of an insert that is rolled back. */
+  void ApplyDelete(const RID &rid);
+
+  /** Roll back a delete, unmarking the tuple as deleted. */
+  void RollbackDelete(const RID &rid);
+
+  /**
+   * Read a tuple from the page, putting its columns back together.
+   * @param rid rid of the tuple
+   * @param[out] tuple the tuple
+   * @return true if the read is successful, i.e. the tuple exists
+   */
+  auto GetTuple(const RID &rid, Tuple *tuple) -> bool;
+
+  /** Like GetTuple(), but safe to call on a page that is not latched, see TablePage::GetTupleOptimistic(). */
+  auto GetTupleOptimistic(const RID &rid, Tuple *tuple) -> bool;
+
+  /**
+   * Read some columns of the tuple in a slot that IsVisible(), for a scan that does not need the others.
+   * @param slot_num the slot of the tuple
+   * @param read_columns the columns to read; the others come out NULL
+   * @param[out] tuple the tuple, whose bytes are reused if they are enough
+   * @return true if the read is successful
+   */
+  auto GetColumns(uint32_t slot_num, const std::vector<bool> &read_columns, Tuple *tuple) -> bool;
+
+  /** Append every tuple of the page that is not deleted to the batch, in slot order. */
+  void GetTuples(TupleBatch *batch);
+
+  /** Drop the empty slots at the end, see TablePage::TrimSlots(). @return the number of slots dropped */
+  auto TrimSlots() -> uint32_t;
+
+  /** @return true if a tuple in this page is marked deleted */
+  auto HasMarkedTuples() -> bool;
+
+  /** @return true if there is a tuple in this page, and set first_rid to it */
+  auto GetFirstTupleRid(RID *first_rid) -> bool;
+
+  /** @return true if there is a tuple after cur_rid in this page, and set next_rid to it */
+  auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
+
+  /** @return the room left for tuples, in the unit of GetSpaceNeeded() */
+  auto GetFreeSpaceRemaining() -> uint32_t;
+
+  /** @return one past the highest slot in use; a scan looks at the slots below it */
+  auto GetTupleCount() -> uint32_t { return GetField(OFFSET_TUPLE_COUNT); }
+
+  /** @return true if the slot holds a tuple that is not deleted */
+  auto IsVisible(uint32_t slot_num) -> bool { return GetSlotState(slot_num) == SLOT_LIVE; }
+
+  /** @return the type of the values of a column */
+  auto GetColumnType(uint32_t column_idx) -> TypeId {
+    return static_cast<TypeId>(GetField(OFFSET_COLUMNS + SIZE_COLUMN * column_idx));
+  }
+
+  /** @return the width of the entries of a column */
+  auto GetColumnWidth(uint32_t column_idx) -> uint32_t {
+    return GetField(OFFSET_COLUMNS + SIZE_COLUMN * column_idx + 4);
+  }
+
+  /** @return the minipage of a column: the entry of slot i starts i * GetColumnWidth() bytes in */
+  auto GetColumnData(uint32_t column_idx) -> const char * {
+    return GetData() + GetField(OFFSET_COLUMNS + SIZE_COLUMN * column_idx + 8);
+  }
+
+  /** @return the value of a column of the tuple in a slot */
+  auto GetValue(uint32_t slot_num, uint32_t column_idx) -> Value {
+    return Value::DeserializeFrom(GetColumnData(column_idx) + GetColumnWidth(column_idx) * slot_num,
+                                  GetColumnType(column_idx));
+  }
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_MAGIC = 16;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 20;
+  static constexpr size_t OFFSET_USED_COUNT = 24;
+  static constexpr size_t OFFSET_CAPACITY = 28;
+  static constexpr size_t OFFSET_COLUMN_COUNT = 32;
+  static constexpr size_t OFFSET_COLUMNS = 36;
+  static constexpr size_t SIZE_COLUMN = 12;
+  /** The room a VARCHAR takes in the fixed-size part of a tuple, see Column::TypeSize(). */
+  static constexpr uint32_t VARCHAR_FIXED_LENGTH = 12;
+
+  /** The states of a slot. */
+  static constexpr uint8_t SLOT_EMPTY = 0;
+  static constexpr uint8_t SLOT_LIVE = 1;
+  static constexpr uint8_t SLOT_DELETED = 2;
+
+  auto GetField(size_t offset) -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + offset); }
+
+  void SetField(size_t offset, uint32_t value) { memcpy(GetData() + offset, &value, sizeof(uint32_t)); }
+
+  auto GetColumnCount() -> uint32_t { return GetField(OFFSET_COLUMN_COUNT); }
+
+  auto GetSlotState(uint32_t slot_num) -> uint8_t {
+    return static_cast<uint8_t>(GetData()[OFFSET_COLUMNS + SIZE_COLUMN * GetColumnCount() + slot_num]);
+  }
+
+  void SetSlotState(uint32_t slot_num, uint8_t state) {
+    GetData()[OFFSET_COLUMNS + SIZE_COLUMN * GetColumnCount() + slot_num] = static_cast<char>(state);
+  }
+
+  /** @return true if the header describes minipages that lie within the page */
+  auto IsLayoutValid() -> bool;
+
+  /** @return true if the values of the tuple fit their entries */
+  auto Fits(const Tuple &tuple) -> bool;
+
+  /** Split a tuple that Fits() up into the entries of a slot. */
+  void WriteTuple(uint32_t slot_num, const Tuple &tuple);
+
+  /**
+   * Put the tuple in a slot back together, from the columns in read_columns, or all of them if it is nullptr.
+   * @return false if an entry is out of bounds
+   */
+  auto ReadTuple(uint32_t slot_num, Tuple *tuple, const std::vector<bool> *read_columns) -> bool;
+};
+
+}  // namespace bustub
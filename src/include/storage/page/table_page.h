@@ -18,7 +18,10 @@
 #include "concurrency/lock_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/page.h"
+#include "storage/page/pax_page.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+#include "storage/table/tuple_view.h"
 
 static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
 
@@ -40,6 +43,8 @@ namespace bustub {
  *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
  *  ----------------------------------------------------------------
  *
+ * A table heap may lay its pages out as PaxPages instead, see IsPaxPage(). They share the page chain header, and the
+ * tuple operations below forward to the PaxPage.
  */
 class TablePage : public Page {
  public:
@@ -56,6 +61,12 @@ class TablePage : public Page {
   /** @return the page ID of this table page */
   auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
 
+  /** @return true if the page is laid out as a PaxPage rather than a slotted page */
+  auto IsPaxPage() -> bool { return GetFreeSpacePointer() == PaxPage::MAGIC; }
+
+  /** @return the page as a PaxPage, see IsPaxPage() */
+  auto AsPaxPage() -> PaxPage * { return reinterpret_cast<PaxPage *>(this); }
+
   /** @return the page ID of the previous table page */
   auto GetPrevPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
 
@@ -123,6 +134,50 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Read a tuple without the page latch, from a BufferPoolManager::OptimisticReadPage() callback. A concurrent writer
+   * may tear the page, so every slot and offset is checked against the page before it is followed, and what is read
+   * only counts once the buffer pool has validated the read. Unlike GetTuple(), this never aborts the transaction.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that was read
+   * @return true if the tuple exists
+   */
+  auto GetTupleOptimistic(const RID &rid, Tuple *tuple) -> bool;
+
+  /** @return the number of bytes left for new tuples, their slots included */
+  auto GetFreeSpaceRemaining() -> uint32_t {
+    if (IsPaxPage()) {
+      return AsPaxPage()->GetFreeSpaceRemaining();
+    }
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return the number of free bytes a page needs to take the tuple, see GetFreeSpaceRemaining() */
+  static auto GetSpaceNeeded(const Tuple &tuple) -> uint32_t { return tuple.GetLength() + SIZE_TUPLE; }
+
+  /**
+   * Copy every tuple in this page that is not deleted into a batch, in slot order.
+   * @param[out] batch the batch to append the tuples to
+   */
+  void GetTuples(TupleBatch *batch);
+
+  /**
+   * Point a view at every tuple in this page that is not deleted, in slot order. The views are valid as long as the
+   * page stays pinned and latched. A PaxPage keeps no tuple in one piece, so it has no views.
+   * @param[out] views the vector to append the views to
+   */
+  void GetTupleViews(std::vector<TupleView> *views);
+
+  /**
+   * Drop the empty slots at the end of the slot array, giving their room back to new tuples. An empty slot holds no
+   * tuple and no RID points at it, so no tuple moves.
+   * @return the number of slots dropped
+   */
+  auto TrimSlots() -> uint32_t;
+
+  /** @return true if a tuple in this page is marked deleted, i.e. its delete has yet to commit or roll back */
+  auto HasMarkedTuples() -> bool;
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -167,10 +222,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  auto GetFreeSpaceRemaining() -> uint32_t {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   auto GetTupleOffsetAtSlot(uint32_t slot_num) -> uint32_t {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
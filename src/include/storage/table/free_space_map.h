@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap keeps track of roughly how many bytes are free in every page of a table heap, so that an insert can go
+ * straight to a page with room instead of walking the whole page chain.
+ *
+ * The free space of a page is recorded as a category of BYTES_PER_CATEGORY bytes, rounded down, so a page is never
+ * thought to have more room than it had when it was last recorded. A page may fill up behind the map's back though;
+ * callers must check for room themselves and record what they find.
+ *
+ * The map is kept in memory, and its changes are written back to FreeSpaceMapPages in the buffer pool in batches of
+ * WRITE_BACK_BATCH, or by Flush(), so that inserters do not line up behind the map pages; TableHeap flushes its map
+ * when it goes away and on BufferPoolManager::FlushAllPages(). The pages may still miss the last changes, e.g. after a
+ * crash, so Load() only takes the entries of pages that are still in the table.
+ *
+ * The entries are kept in the order their pages were first recorded, which for a table heap is the order of its page
+ * chain, except that Remove() fills the gap a page leaves from the end.
+ */
+class FreeSpaceMap {
+ public:
+  /** Granularity of the recorded free space. */
+  static constexpr uint32_t BYTES_PER_CATEGORY = BUSTUB_PAGE_SIZE / 256;
+  /** Number of changes after which the map writes its changed pages back. */
+  static constexpr size_t WRITE_BACK_BATCH = 64;
+
+  /**
+   * Create an empty map with no pages of its own yet, see Create() and Load().
+   * @param buffer_pool_manager the buffer pool manager that holds the map pages
+   */
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Allocate the first map page of an empty map.
+   * @return the id of the first map page, or INVALID_PAGE_ID if no page could be allocated
+   */
+  auto Create() -> page_id_t;
+
+  /**
+   * Load the map stored from the given first map page.
+   * @param root_page_id the id of the first map page
+   * @param heap_page_ids the pages of the table heap; entries of other pages are stale and dropped
+   * @return false if the page is not a map page, in which case the map stays empty
+   */
+  auto Load(page_id_t root_page_id, const std::unordered_set<page_id_t> &heap_page_ids) -> bool;
+
+  /** @return the id of the first map page, INVALID_PAGE_ID if there is none */
+  auto GetRootPageId() -> page_id_t;
+
+  /**
+   * Find a page that had room for at least size bytes when it was last recorded, the fullest such page first. Each
+   * thread starts looking at a different entry among the fullest pages, so that concurrent inserters spread out.
+   * @param size number of free bytes needed
+   * @return the id of the page, or INVALID_PAGE_ID if no page is known to have room
+   */
+  auto FindPage(uint32_t size) -> page_id_t;
+
+  /**
+   * Record the free space of a page, adding the page to the map if it is new.
+   * @param page_id id of the heap page
+   * @param free_space number of free bytes in the page
+   */
+  void Update(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Forget a page that was taken out of the table heap. The second-to-last entry takes its place and the last entry
+   * that of the second-to-last, so the page recorded last stays last. A map page that is left without entries is given
+   * back to the buffer pool with the next write-back, the first one excepted.
+   * @param page_id id of the heap page
+   */
+  void Remove(page_id_t page_id);
+
+  /** Write the changes to the map back to its pages. */
+  void Flush();
+
+  /** @return the free space recorded for a page, rounded down to its category; 0 for a page the map does not know */
+  auto GetFreeSpace(page_id_t page_id) -> uint32_t;
+
+  /** @return the page that was recorded last, INVALID_PAGE_ID if there is none */
+  auto GetLastPageId() -> page_id_t;
+
+  /** @return the number of heap pages in the map */
+  auto GetNumPages() -> size_t;
+
+ private:
+  /** @return the category of free_space bytes */
+  static auto ToCategory(uint32_t free_space) -> uint8_t {
+    return static_cast<uint8_t>(std::min<uint32_t>(free_space / BYTES_PER_CATEGORY, UINT8_MAX));
+  }
+
+  /**
+   * Note that an entry changed. Caller must hold latch_ exclusively.
+   * @return true if enough changes piled up to write them back
+   */
+  auto MarkChanged(size_t index) -> bool;
+
+  /**
+   * Write the map pages with changed entries back, adding and dropping map pages as the number of entries asks.
+   * @param wait false to leave the write-back to a thread that is already at it
+   */
+  void WriteBack(bool wait);
+
+  /** Allocate another, empty map page at the end of the map. Caller must hold write_latch_. @return success */
+  auto AddMapPage() -> bool;
+
+  BufferPoolManager *buffer_pool_manager_;
+  /** Serializes writing the map pages. Protects map_page_ids_; taken before latch_. */
+  std::mutex write_latch_;
+  /** The map pages, in order. */
+  std::vector<page_id_t> map_page_ids_;
+  /** Protects the fields below. */
+  std::shared_mutex latch_;
+  /** The heap page and category of every entry, and where every heap page's entry is. */
+  std::vector<std::pair<page_id_t, uint8_t>> entries_;
+  std::unordered_map<page_id_t, size_t> entry_of_;
+  /** The entries by category and index, to find the fullest page with room. */
+  std::set<std::pair<uint8_t, size_t>> by_category_;
+  /** The map pages, by their index in map_page_ids_, whose entries changed since they were written back. */
+  std::set<size_t> changed_map_pages_;
+  size_t num_changes_{0};
+};
+
+}  // namespace bustub
@@ -12,9 +12,18 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/enums/table_format.h"
 #include "recovery/log_manager.h"
+#include "storage/page/page_guard.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -23,12 +32,23 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * A FreeSpaceMap records how much room every page has, so that inserts go straight to a page that can take the tuple
+ * and only append a page when none can. The map has pages of its own, which the table is opened with again, see
+ * TableInfo::free_space_map_root_id_.
+ *
+ * The pages are either slotted TablePages or, for a TableFormat::PAX table, PaxPages laid out for the table's schema.
+ * The format is picked when the table is created and holds for all of its pages.
  */
 class TableHeap {
   friend class TableIterator;
 
  public:
-  ~TableHeap() = default;
+  /** Called for every tuple VacuumPages() moves; the tuple still carries its old RID. */
+  using move_fn = std::function<void(const Tuple &tuple, const RID &new_rid)>;
+
+  /** Write the free space map back, so that the table finds it as it was left when it is opened again. */
+  ~TableHeap();
 
   /**
    * Create a table heap without a transaction. (open table)
@@ -36,9 +56,13 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param free_space_map_root_id the id of the first page of the free space map, see FreeSpaceMap::GetRootPageId();
+   * INVALID_PAGE_ID to build a new map from the pages
+   * @param schema the schema of the table; only needed if it is a PAX table, whose format the first page tells
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, page_id_t free_space_map_root_id = INVALID_PAGE_ID,
+            const Schema *schema = nullptr);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,12 +70,15 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param format the format of the pages of the table
+   * @param schema the schema of the table; only needed for TableFormat::PAX, where a tuple of it must fit a page
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, TableFormat format = TableFormat::ROW, const Schema *schema = nullptr);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table. If the tuple is too large (>= page_size), or a VARCHAR of it is longer than a PAX
+   * table allows, return false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,6 +86,18 @@ class TableHeap {
    */
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
 
+  /**
+   * Append many tuples at once, e.g. for a large INSERT or a bulk load. The tuples are packed into fresh pages while
+   * nobody else can see them, without latching anything, and every batch of pages is then linked to the end of the
+   * table and written out with a single BufferPoolManager::FlushPages() call. Room left in existing pages is not used.
+   * The caller is expected to hold a table lock rather than one lock per tuple.
+   * @param tuples tuples to insert
+   * @param[out] rids the rids of the inserted tuples, in order
+   * @param txn the transaction performing the insert
+   * @return true iff all the tuples were inserted; otherwise rids holds the ones that were
+   */
+  auto BulkInsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -95,10 +134,55 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
+   * @param acquire_read_lock false if the caller latches the page itself, otherwise the page is read optimistically
+   * without pinning or latching it, see BufferPoolManager::OptimisticReadPage()
    * @return true if the read was successful (i.e. the tuple exists)
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
+  /**
+   * Read every tuple of a page at once, pinning and latching the page a single time. A scan that walks the table
+   * page by page with this pays one buffer pool round trip per page rather than one per tuple.
+   * @param page_id the page to read, e.g. GetFirstPageId() or the result of the previous call
+   * @param[out] batch cleared, then filled with the tuples of the page that are not deleted, in slot order
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  auto GetPageTuples(page_id_t page_id, TupleBatch *batch) -> page_id_t;
+
+  /**
+   * Look at every tuple of a page in place, without copying any of them. The page stays pinned and read-latched until
+   * the guard is released, and the views are only valid until then.
+   * @param page_id the page to read, e.g. GetFirstPageId() or the result of the previous call
+   * @param[out] guard takes over the page, letting go of the page it held before
+   * @param[out] views cleared, then filled with views of the tuples of the page that are not deleted, in slot order
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  auto GetPageTupleViews(page_id_t page_id, PageGuard *guard, std::vector<TupleView> *views) -> page_id_t;
+
+  /**
+   * Pin and read-latch a page for a scan that reads it itself, e.g. the minipages of a PaxPage.
+   * @param page_id the page to read, e.g. GetFirstPageId() or the result of the previous call
+   * @param[out] guard takes over the page, letting go of the page it held before
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  auto ScanPage(page_id_t page_id, PageGuard *guard) -> page_id_t;
+
+  /**
+   * Vacuum a stretch of the page chain. Every page gets the empty slots at its end trimmed, and a page whose tuples fit
+   * into the page before it, leaving that page at most vacuum_merge_fill_ratio full, has them moved there and is taken
+   * out of the chain, the free space map and the buffer pool. Moving a tuple changes its RID, so the caller must keep
+   * every other transaction off the table, e.g. with an exclusive table lock, and fix up the indexes in on_move. A page
+   * that is still pinned when it is taken out of the buffer pool is deleted by a later call.
+   * @param page_id the page to start at, e.g. GetFirstPageId() or the result of the previous call
+   * @param max_pages the number of pages after the first one to look at
+   * @param on_move called for every tuple that moves
+   * @param txn the vacuuming transaction
+   * @param[out] num_freed_pages incremented by the number of pages taken out of the table
+   * @return the page to go on from, INVALID_PAGE_ID once the last page has been looked at
+   */
+  auto VacuumPages(page_id_t page_id, size_t max_pages, const move_fn &on_move, Transaction *txn,
+                   size_t *num_freed_pages) -> page_id_t;
+
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
@@ -108,11 +192,60 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the format of the pages of this table */
+  inline auto GetFormat() const -> TableFormat { return format_; }
+
+  /** @return the free space map of this table */
+  inline auto GetFreeSpaceMap() -> FreeSpaceMap * { return &free_space_map_; }
+
  private:
+  /** Ask the buffer pool to read the pages that follow the given page, see scan_read_ahead_distance. */
+  void ReadAhead(page_id_t next_page_id);
+
+  /** Initialize a fresh page of the table, in the table's format. */
+  void InitPage(TablePage *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn);
+
+  /** @return true if the tuple fits a page of the table */
+  auto Fits(const Tuple &tuple) -> bool;
+
+  /** @return the number of free bytes a page of the table needs to take the tuple, see RecordFreeSpace() */
+  auto GetSpaceNeeded(const Tuple &tuple) -> uint32_t {
+    return format_ == TableFormat::PAX ? PaxPage::GetSpaceNeeded(*schema_) : TablePage::GetSpaceNeeded(tuple);
+  }
+
+  /**
+   * Move every tuple of a page into the page before it, if they fit as VacuumPages() asks. Caller must hold both page
+   * latches.
+   * @param[out] moved_any set to true if any tuple moved, even if the page could not be emptied after all
+   * @return true if the page was emptied
+   */
+  auto MergeInto(TablePage *page, TablePage *next_page, const move_fn &on_move, Transaction *txn, bool *moved_any)
+      -> bool;
+
+  /** Delete the pages VacuumPages() took out of the table but could not delete from the buffer pool yet. */
+  void FreeUnfreedPages();
+
+  /** Link a batch of fresh pages, chained to each other, to the end of the table, write them out and unpin them. */
+  void AppendPages(const std::vector<TablePage *> &pages);
+
+  /** Record the free space of a page in the free space map. Caller must hold the page latch. */
+  void RecordFreeSpace(TablePage *page) {
+    free_space_map_.Update(page->GetTablePageId(), page->GetFreeSpaceRemaining());
+  }
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  FreeSpaceMap free_space_map_;
+  /** The id of the flush hook that writes free_space_map_ back, see BufferPoolManager::AddFlushHook() */
+  size_t flush_hook_id_{0};
+  TableFormat format_{TableFormat::ROW};
+  /** The schema the pages of a PAX table are laid out for, nullptr for a row table */
+  std::unique_ptr<Schema> schema_;
+  /** Pages taken out of the table that were still pinned, e.g. by a read-ahead, when VacuumPages() went to delete them */
+  std::vector<page_id_t> unfreed_page_ids_;
+  std::mutex unfreed_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_vacuum.h
+//
+// Identification: src/include/storage/table/table_vacuum.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <shared_mutex>
+#include <thread>  // NOLINT
+#include <unordered_map>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+
+namespace bustub {
+
+/**
+ * TableVacuum compacts the table heaps of a catalog in the background, see TableHeap::VacuumPages(). Deletes and
+ * aborted inserts leave pages half empty behind them; the vacuum merges such pages with their neighbours and gives the
+ * pages it frees back to the buffer pool, and to the database file when the buffer pool keeps a free page map.
+ *
+ * The vacuum throttles itself: a round looks at up to vacuum_batch_pages pages of one table, picking up where the last
+ * round on that table left off, the tables take turns, and the thread sleeps vacuum_interval between rounds.
+ *
+ * Merging pages moves tuples to new RIDs, so a round runs as a transaction of its own that holds an exclusive lock on
+ * the table. It waits for the transactions holding locks on the table to finish, and gives the round up if the lock
+ * manager aborts it instead. The indexes of the table are updated for every tuple that moves.
+ *
+ * The table lock is all that keeps scans and writers away from the moving tuples, so the vacuum is only safe to Start()
+ * with a lock manager that really locks; BustubInstance leaves it off unless StartTableVacuum() is called.
+ */
+class TableVacuum {
+ public:
+  /**
+   * @param catalog the catalog whose tables to vacuum
+   * @param buffer_pool_manager the buffer pool manager that holds the tables
+   * @param txn_manager the transaction manager to run the rounds with
+   * @param lock_manager the lock manager to lock the tables with
+   * @param catalog_latch if not nullptr, held in shared mode while a round looks at the catalog
+   */
+  TableVacuum(Catalog *catalog, BufferPoolManager *buffer_pool_manager, TransactionManager *txn_manager,
+              LockManager *lock_manager, std::shared_mutex *catalog_latch = nullptr);
+
+  ~TableVacuum();
+
+  DISALLOW_COPY_AND_MOVE(TableVacuum);
+
+  /** Start the vacuum thread. Does nothing if it is running. */
+  void Start();
+
+  /** Stop and join the vacuum thread. Does nothing if it is not running. */
+  void Stop();
+
+  /**
+   * Run one round now, on the table whose turn it is.
+   * @return the number of pages freed
+   */
+  auto VacuumNext() -> size_t;
+
+  /**
+   * Vacuum a whole table now, one round after the other, e.g. after a large delete.
+   * @param table_oid the table to vacuum
+   * @return the number of pages freed
+   */
+  auto VacuumTable(table_oid_t table_oid) -> size_t;
+
+  /** @return the number of pages the vacuum has freed so far */
+  auto GetNumFreedPages() const -> size_t { return num_freed_pages_; }
+
+  /** @return the number of tuples the vacuum has moved so far */
+  auto GetNumMovedTuples() const -> size_t { return num_moved_tuples_; }
+
+ private:
+  /**
+   * Vacuum the next batch of pages of a table. Caller must hold round_latch_.
+   * @param table_oid the table to vacuum
+   * @param[out] num_freed_pages incremented by the number of pages freed
+   * @return true if the round reached the end of the table
+   */
+  auto VacuumBatch(table_oid_t table_oid, size_t *num_freed_pages) -> bool;
+
+  /** Body of the vacuum thread. */
+  void Run();
+
+  Catalog *catalog_;
+  BufferPoolManager *buffer_pool_manager_;
+  TransactionManager *txn_manager_;
+  LockManager *lock_manager_;
+  std::shared_mutex *catalog_latch_;
+
+  /** Serializes the rounds. Protects the fields below. */
+  std::mutex round_latch_;
+  /** The table whose turn it is. */
+  table_oid_t next_table_oid_{0};
+  /** Where the next round on a table goes on from; a table without an entry starts at its first page. */
+  std::unordered_map<table_oid_t, page_id_t> cursors_;
+  /** The number of pages freed since the free page map was last truncated. */
+  size_t num_untruncated_pages_{0};
+
+  std::atomic<size_t> num_freed_pages_{0};
+  std::atomic<size_t> num_moved_tuples_{0};
+
+  /** The vacuum thread, nullptr if it is not running. */
+  std::thread *thread_{nullptr};
+  /** Protected by latch_. Tells the vacuum thread to exit. */
+  bool stop_{false};
+  /** Wakes the vacuum thread up when it has to stop. */
+  std::condition_variable cv_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/storage/table/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds the tuples of a table page, copied out of the page while it is pinned and latched once, see
+ * TableHeap::GetPageTuples(). The tuples share one buffer that is kept when the batch is cleared, so reading page after
+ * page into the same batch only allocates while the batch grows.
+ */
+class TupleBatch {
+ public:
+  /** Drop the tuples, keeping the memory they took. */
+  void Clear() {
+    data_.clear();
+    offsets_.clear();
+    rids_.clear();
+  }
+
+  /** Append a copy of a tuple. */
+  void Append(const RID &rid, const char *data, uint32_t size) {
+    offsets_.push_back(static_cast<uint32_t>(data_.size()));
+    data_.insert(data_.end(), data, data + size);
+    rids_.push_back(rid);
+  }
+
+  /** Append a copy of the tuple a view points to. */
+  void Append(const TupleView &view) { Append(view.GetRid(), view.GetData(), view.GetLength()); }
+
+  /** @return the number of tuples in the batch */
+  auto Size() const -> size_t { return rids_.size(); }
+
+  /** @return the rid of the i-th tuple */
+  auto GetRid(size_t i) const -> const RID & { return rids_[i]; }
+
+  /** @return the size of the i-th tuple */
+  auto GetTupleSize(size_t i) const -> uint32_t {
+    auto end = i + 1 < offsets_.size() ? offsets_[i + 1] : static_cast<uint32_t>(data_.size());
+    return end - offsets_[i];
+  }
+
+  /**
+   * Copy the i-th tuple out of the batch, reusing the tuple's buffer if it is large enough.
+   * @param i index of the tuple
+   * @param[out] tuple the tuple to copy into
+   */
+  void GetTuple(size_t i, Tuple *tuple) const {
+    uint32_t size = GetTupleSize(i);
+    if (!tuple->allocated_ || tuple->size_ < size) {
+      if (tuple->allocated_) {
+        delete[] tuple->data_;
+      }
+      tuple->data_ = new char[size];
+      tuple->allocated_ = true;
+    }
+    tuple->size_ = size;
+    memcpy(tuple->data_, data_.data() + offsets_[i], size);
+    tuple->rid_ = rids_[i];
+  }
+
+ private:
+  /** The bytes of all the tuples, one after the other, and where each tuple starts. */
+  std::vector<char> data_;
+  std::vector<uint32_t> offsets_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
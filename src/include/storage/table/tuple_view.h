@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.h
+//
+// Identification: src/include/storage/table/tuple_view.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleView is a tuple that does not own its bytes: it points into the frame of a table page, and is only valid while
+ * the PageGuard that holds the page does. Looking at a view copies nothing; Materialize() copies the tuple out once
+ * it is known to be needed beyond the guard, e.g. after it passed a predicate.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  /**
+   * Create a view over the bytes of a tuple.
+   * @param rid rid of the tuple
+   * @param data the tuple's bytes, inside a page held by a PageGuard
+   * @param size the size of the tuple
+   */
+  TupleView(const RID &rid, const char *data, uint32_t size) {
+    tuple_.rid_ = rid;
+    // The tuple is never allocated_, so it is never written through or freed.
+    tuple_.data_ = const_cast<char *>(data);
+    tuple_.size_ = size;
+  }
+
+  /** @return the rid of the tuple */
+  auto GetRid() const -> RID { return tuple_.GetRid(); }
+
+  /** @return the bytes of the tuple, inside the page */
+  auto GetData() const -> const char * { return tuple_.GetData(); }
+
+  /** @return the size of the tuple */
+  auto GetLength() const -> uint32_t { return tuple_.GetLength(); }
+
+  /** @return the value of a column, deserialized straight from the page */
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value {
+    return tuple_.GetValue(schema, column_idx);
+  }
+
+  /**
+   * @return the view as a Tuple that shares the page's bytes, to evaluate expressions on. Copies of it share them
+   * too, so it must not outlive the view.
+   */
+  auto AsTuple() const -> const Tuple * { return &tuple_; }
+
+  /**
+   * Copy the tuple out of the page. The bytes of the tuple copied into are reused if they are enough.
+   * @param[out] tuple the tuple to copy into, which then owns its bytes
+   */
+  void Materialize(Tuple *tuple) const {
+    if (!tuple->allocated_ || tuple->size_ < tuple_.size_) {
+      if (tuple->allocated_) {
+        delete[] tuple->data_;
+      }
+      tuple->data_ = new char[tuple_.size_];
+    }
+    memcpy(tuple->data_, tuple_.data_, tuple_.size_);
+    tuple->size_ = tuple_.size_;
+    tuple->rid_ = tuple_.rid_;
+    tuple->allocated_ = true;
+  }
+
+ private:
+  Tuple tuple_;
+};
+
+}  // namespace bustub
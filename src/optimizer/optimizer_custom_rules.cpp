@@ -15,6 +15,9 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
   p = OptimizeOrderByAsIndexScan(p);
   p = OptimizeSortLimitAsTopN(p);
+  // Last, so that the rules above still see plain scans: a predicate merged into a scan runs on views of its pages.
+  p = OptimizeMergeFilterScan(p);
+  p = OptimizePruneScanColumns(p);
   return p;
 }
 
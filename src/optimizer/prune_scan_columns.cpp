@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+/** Add the columns an expression reads to column_ids. */
+static void CollectColumnIds(const AbstractExpression &expr, std::vector<uint32_t> *column_ids) {
+  if (const auto *column_value = dynamic_cast<const ColumnValueExpression *>(&expr); column_value != nullptr) {
+    column_ids->push_back(column_value->GetColIdx());
+  }
+  for (const auto &child : expr.GetChildren()) {
+    CollectColumnIds(*child, column_ids);
+  }
+}
+
+auto Optimizer::OptimizePruneScanColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizePruneScanColumns(child));
+  }
+
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // Only a projection or an aggregation tells for sure which columns of its child it reads.
+  std::vector<AbstractExpressionRef> exprs;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    exprs = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan).GetExpressions();
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &aggregation_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    exprs = aggregation_plan.GetGroupBys();
+    exprs.insert(exprs.end(), aggregation_plan.GetAggregates().begin(), aggregation_plan.GetAggregates().end());
+  } else {
+    return optimized_plan;
+  }
+
+  BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+  if (optimized_plan->children_[0]->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*optimized_plan->children_[0]);
+  // Only the scan of a PAX table gains from reading fewer columns.
+  const auto *table_info = catalog_.GetTable(seq_scan_plan.GetTableOid());
+  if (seq_scan_plan.column_ids_ || table_info->table_ == nullptr ||
+      table_info->table_->GetFormat() != TableFormat::PAX) {
+    return optimized_plan;
+  }
+
+  std::vector<uint32_t> column_ids;
+  for (const auto &expr : exprs) {
+    CollectColumnIds(*expr, &column_ids);
+  }
+  std::sort(column_ids.begin(), column_ids.end());
+  column_ids.erase(std::unique(column_ids.begin(), column_ids.end()), column_ids.end());
+  auto pruned_scan =
+      std::make_shared<SeqScanPlanNode>(seq_scan_plan.output_schema_, seq_scan_plan.table_oid_,
+                                        seq_scan_plan.table_name_, seq_scan_plan.filter_predicate_, column_ids);
+  return optimized_plan->CloneWithChildren({pruned_scan});
+}
+
+}  // namespace bustub
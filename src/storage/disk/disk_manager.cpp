@@ -11,12 +11,16 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -31,10 +35,33 @@ static char *buffer_used;
  * @input db_file: database file name
  */
 DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+  if (!OpenLog()) {
+    return;
+  }
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  if (!db_io_.is_open()) {
+    db_io_.clear();
+    // create a new file
+    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!db_io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+  buffer_used = nullptr;
+}
+
+/**
+ * Open/create the log file that goes with file_name_
+ * @return: false if file_name_ has no extension to replace
+ */
+auto DiskManager::OpenLog() -> bool {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
-    return;
+    return false;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
@@ -48,19 +75,7 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open dblog file");
     }
   }
-
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
-  }
-  buffer_used = nullptr;
+  return true;
 }
 
 /**
@@ -122,6 +137,119 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Number of pages in the database file; the memory based disk managers have none
+ */
+auto DiskManager::GetNumPages() -> page_id_t {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (!db_io_.is_open()) {
+    return 0;
+  }
+  int size = GetFileSize(file_name_);
+  return size <= 0 ? 0 : (size + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE;
+}
+
+/**
+ * Cut the database file down to its first num_pages pages
+ */
+void DiskManager::TruncatePages(page_id_t num_pages) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (!db_io_.is_open()) {
+    return;
+  }
+  db_io_.flush();
+  if (truncate(file_name_.c_str(), static_cast<off_t>(num_pages) * BUSTUB_PAGE_SIZE) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+  }
+}
+
+/**
+ * Read a batch of pages, holding the file latch once and reading each run of consecutive pages in one call
+ */
+void DiskManager::ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) {
+  std::vector<std::pair<page_id_t, char *>> sorted_reads(reads);
+  std::sort(sorted_reads.begin(), sorted_reads.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  std::vector<char> buffer;
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  int64_t file_size = GetFileSize(file_name_);
+  for (size_t begin = 0; begin < sorted_reads.size();) {
+    size_t end = begin + 1;
+    while (end < sorted_reads.size() && sorted_reads[end].first == sorted_reads[end - 1].first + 1) {
+      end++;
+    }
+    size_t offset = static_cast<size_t>(sorted_reads[begin].first) * BUSTUB_PAGE_SIZE;
+    size_t length = (end - begin) * BUSTUB_PAGE_SIZE;
+    // Whatever lies past the end of the file reads as zeros.
+    buffer.assign(length, 0);
+    if (static_cast<int64_t>(offset) > file_size) {
+      LOG_DEBUG("I/O error reading past end of file");
+    } else {
+      db_io_.seekp(offset);
+      db_io_.read(buffer.data(), length);
+      if (db_io_.bad()) {
+        LOG_DEBUG("I/O error while reading");
+      } else if (static_cast<size_t>(db_io_.gcount()) < length) {
+        db_io_.clear();
+      }
+    }
+    for (size_t i = begin; i < end; i++) {
+      memcpy(sorted_reads[i].second, buffer.data() + (i - begin) * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE);
+    }
+    begin = end;
+  }
+}
+
+/**
+ * Write a batch of pages, one at a time
+ */
+void DiskManager::WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) {
+  for (const auto &[page_id, page_data] : writes) {
+    WritePage(page_id, page_data);
+  }
+}
+
+/**
+ * Carry out a batch of asynchronous requests synchronously, in order
+ */
+void DiskManager::SubmitIo(std::vector<AsyncIoRequest> requests) {
+  for (auto &request : requests) {
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    request.callback_(true);
+  }
+}
+
+void DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, io_callback_fn callback) {
+  std::vector<AsyncIoRequest> requests;
+  requests.push_back({false, page_id, page_data, std::move(callback)});
+  SubmitIo(std::move(requests));
+}
+
+void DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, io_callback_fn callback) {
+  std::vector<AsyncIoRequest> requests;
+  // The data is only ever read from for a write.
+  requests.push_back({true, page_id, const_cast<char *>(page_data), std::move(callback)});
+  SubmitIo(std::move(requests));
+}
+
+auto DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  ReadPageAsync(page_id, page_data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
+auto DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  WritePageAsync(page_id, page_data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
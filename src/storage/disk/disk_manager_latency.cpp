@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency.cpp
+//
+// Identification: src/storage/disk/disk_manager_latency.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_latency.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+DiskManagerLatency::DiskManagerLatency(DiskManager *disk_manager, const DiskProfile &profile)
+    : disk_manager_(disk_manager), profile_(profile), slot_free_(profile.queue_depth_) {}
+
+void DiskManagerLatency::ShutDown() { disk_manager_->ShutDown(); }
+
+void DiskManagerLatency::WritePage(page_id_t page_id, const char *page_data) {
+  auto done = ScheduleBatch({page_id}, true);
+  num_writes_ += 1;
+  disk_manager_->WritePage(page_id, page_data);
+  std::this_thread::sleep_until(done);
+}
+
+void DiskManagerLatency::ReadPage(page_id_t page_id, char *page_data) {
+  auto done = ScheduleBatch({page_id}, false);
+  num_reads_ += 1;
+  disk_manager_->ReadPage(page_id, page_data);
+  std::this_thread::sleep_until(done);
+}
+
+void DiskManagerLatency::ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) {
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(reads.size());
+  for (const auto &read : reads) {
+    page_ids.push_back(read.first);
+  }
+  auto done = ScheduleBatch(std::move(page_ids), false);
+  num_reads_ += static_cast<int>(reads.size());
+  disk_manager_->ReadPages(reads);
+  std::this_thread::sleep_until(done);
+}
+
+void DiskManagerLatency::WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) {
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(writes.size());
+  for (const auto &write : writes) {
+    page_ids.push_back(write.first);
+  }
+  auto done = ScheduleBatch(std::move(page_ids), true);
+  num_writes_ += static_cast<int>(writes.size());
+  disk_manager_->WritePages(writes);
+  std::this_thread::sleep_until(done);
+}
+
+void DiskManagerLatency::SubmitIo(std::vector<AsyncIoRequest> requests) {
+  std::vector<clock::time_point> done(requests.size());
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto now = clock::now();
+    for (size_t i = 0; i < requests.size(); i++) {
+      done[i] = Schedule({requests[i].page_id_, 1, requests[i].is_write_}, now);
+    }
+  }
+  for (auto &request : requests) {
+    if (request.is_write_) {
+      num_writes_ += 1;
+      disk_manager_->WritePage(request.page_id_, request.data_);
+    } else {
+      num_reads_ += 1;
+      disk_manager_->ReadPage(request.page_id_, request.data_);
+    }
+  }
+  // Complete the requests in the order the device would finish them.
+  std::vector<size_t> order(requests.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&done](size_t a, size_t b) { return done[a] < done[b]; });
+  for (size_t i : order) {
+    std::this_thread::sleep_until(done[i]);
+    if (requests[i].callback_) {
+      requests[i].callback_(true);
+    }
+  }
+}
+
+auto DiskManagerLatency::GetTransferTime() -> std::chrono::microseconds {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return std::chrono::duration_cast<std::chrono::microseconds>(transfer_time_);
+}
+
+auto DiskManagerLatency::Schedule(const Run &run, clock::time_point now) -> clock::time_point {
+  clock::duration latency = run.is_write_ ? profile_.write_latency_ : profile_.read_latency_;
+  if (profile_.sequential_skips_latency_ && run.first_page_id_ == next_sequential_page_id_) {
+    latency = clock::duration::zero();
+  }
+  next_sequential_page_id_ = run.first_page_id_ + static_cast<page_id_t>(run.num_pages_);
+
+  // Wait for the queue slot that frees up first, if the queue is full.
+  auto slot = std::min_element(slot_free_.begin(), slot_free_.end());
+  auto start = slot == slot_free_.end() ? now : std::max(now, *slot);
+  auto done = start + latency;
+  if (profile_.bandwidth_ > 0) {
+    auto bytes = static_cast<uint64_t>(run.num_pages_) * BUSTUB_PAGE_SIZE;
+    auto transfer = std::chrono::duration_cast<clock::duration>(
+        std::chrono::nanoseconds(bytes * 1000000000ULL / profile_.bandwidth_));
+    done = std::max(done, channel_free_) + transfer;
+    channel_free_ = done;
+    transfer_time_ += transfer;
+  }
+  if (slot != slot_free_.end()) {
+    *slot = done;
+  }
+  return done;
+}
+
+auto DiskManagerLatency::ScheduleBatch(std::vector<page_id_t> page_ids, bool is_write) -> clock::time_point {
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto now = clock::now();
+  auto done = now;
+  for (size_t i = 0; i < page_ids.size();) {
+    size_t j = i + 1;
+    while (j < page_ids.size() && page_ids[j] == page_ids[j - 1] + 1) {
+      j++;
+    }
+    done = std::max(done, Schedule({page_ids[i], j - i, is_write}, now));
+    i = j;
+  }
+  return done;
+}
+
+}  // namespace bustub
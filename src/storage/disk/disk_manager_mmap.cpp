@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.cpp
+//
+// Identification: src/storage/disk/disk_manager_mmap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_mmap.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstring>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+DiskManagerMmap::DiskManagerMmap(const std::string &db_file, size_t max_mapped_bytes, FsyncPolicy fsync_policy)
+    : DiskManagerPosix(db_file, fsync_policy), max_mapped_bytes_(max_mapped_bytes) {
+  if (fd_ < 0) {
+    return;
+  }
+  // Reserve the address space only; the file is mapped over it piece by piece.
+  void *base = mmap(nullptr, max_mapped_bytes_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED) {
+    LOG_INFO("cannot reserve address space for the database file, reading with pread instead");
+    return;
+  }
+  base_ = static_cast<char *>(base);
+  GrowMapping(GetDbFileSize());
+}
+
+DiskManagerMmap::~DiskManagerMmap() { ShutDown(); }
+
+void DiskManagerMmap::ShutDown() {
+  if (base_ != nullptr) {
+    munmap(base_, max_mapped_bytes_);
+    base_ = nullptr;
+    mapped_bytes_ = 0;
+  }
+  DiskManagerPosix::ShutDown();
+}
+
+void DiskManagerMmap::ReadPage(page_id_t page_id, char *page_data) {
+  {
+    std::shared_lock<std::shared_mutex> lock(truncate_latch_);
+    const char *page = GetMappedPage(page_id);
+    if (page != nullptr) {
+      memcpy(page_data, page, BUSTUB_PAGE_SIZE);
+      return;
+    }
+  }
+  DiskManagerPosix::ReadPages({{page_id, page_data}});
+}
+
+void DiskManagerMmap::ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) {
+  std::vector<std::pair<page_id_t, char *>> unmapped;
+  {
+    std::shared_lock<std::shared_mutex> lock(truncate_latch_);
+    for (const auto &[page_id, page_data] : reads) {
+      const char *page = GetMappedPage(page_id);
+      if (page == nullptr) {
+        unmapped.emplace_back(page_id, page_data);
+        continue;
+      }
+      memcpy(page_data, page, BUSTUB_PAGE_SIZE);
+    }
+  }
+  if (!unmapped.empty()) {
+    DiskManagerPosix::ReadPages(unmapped);
+  }
+}
+
+void DiskManagerMmap::TruncatePages(page_id_t num_pages) {
+  std::scoped_lock<std::shared_mutex> lock(truncate_latch_);
+  DiskManagerPosix::TruncatePages(num_pages);
+}
+
+auto DiskManagerMmap::GetMappedPage(page_id_t page_id) -> const char * {
+  size_t end = (static_cast<size_t>(page_id) + 1) * BUSTUB_PAGE_SIZE;
+  if (base_ == nullptr || end > max_mapped_bytes_ || static_cast<int64_t>(end) > GetDbFileSize()) {
+    return nullptr;
+  }
+  if (end > mapped_bytes_.load(std::memory_order_acquire)) {
+    GrowMapping(end);
+  }
+  return base_ + end - BUSTUB_PAGE_SIZE;
+}
+
+void DiskManagerMmap::GrowMapping(size_t size) {
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  size_t mapped = mapped_bytes_.load(std::memory_order_relaxed);
+  if (size <= mapped) {
+    return;
+  }
+  // Map whole extents, even past the end of the file. Only bytes below the file size are ever touched, since touching
+  // the rest of the last extent would fault.
+  size_t target = std::min((size + MAP_EXTENT_SIZE - 1) / MAP_EXTENT_SIZE * MAP_EXTENT_SIZE, max_mapped_bytes_);
+  void *extent = mmap(base_ + mapped, target - mapped, PROT_READ, MAP_SHARED | MAP_FIXED, fd_, mapped);
+  if (extent == MAP_FAILED) {
+    LOG_DEBUG("cannot extend the mapping of the database file");
+    return;
+  }
+  mapped_bytes_.store(target, std::memory_order_release);
+}
+
+}  // namespace bustub
@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file, FsyncPolicy fsync_policy, size_t sync_interval,
+                                   bool with_log)
+    : fsync_policy_(fsync_policy),
+      sync_interval_(std::max<size_t>(sync_interval, 1)),
+      extent_size_(static_cast<int64_t>(disk_extent_pages) * BUSTUB_PAGE_SIZE) {
+  file_name_ = db_file;
+  if (with_log && !OpenLog()) {
+    return;
+  }
+  fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0) {
+    file_size_ = stat_buf.st_size;
+    // Extents reserved by an earlier run lie past the end of the file.
+    allocated_size_ = static_cast<int64_t>(stat_buf.st_blocks) * 512;
+  }
+}
+
+DiskManagerPosix::~DiskManagerPosix() { ShutDown(); }
+
+void DiskManagerPosix::ShutDown() {
+  if (fd_ >= 0) {
+    if (fsync_policy_ != FsyncPolicy::Never) {
+      Sync();
+    }
+    close(fd_);
+    fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += 1;
+  ReserveExtent(offset);
+  size_t written = 0;
+  while (written < static_cast<size_t>(BUSTUB_PAGE_SIZE)) {
+    ssize_t rc = pwrite(fd_, page_data + written, BUSTUB_PAGE_SIZE - written, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += rc;
+  }
+  OnPageWritten(offset);
+}
+
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) { ReadPages({{page_id, page_data}}); }
+
+void DiskManagerPosix::ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) {
+  std::vector<std::pair<page_id_t, char *>> sorted_reads(reads);
+  std::sort(sorted_reads.begin(), sorted_reads.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  int64_t file_size = file_size_.load(std::memory_order_relaxed);
+  std::vector<iovec> iovecs;
+  for (size_t begin = 0; begin < sorted_reads.size();) {
+    size_t end = begin + 1;
+    while (end < sorted_reads.size() && end - begin < IOV_MAX &&
+           sorted_reads[end].first == sorted_reads[end - 1].first + 1) {
+      end++;
+    }
+    auto offset = static_cast<int64_t>(sorted_reads[begin].first) * BUSTUB_PAGE_SIZE;
+    size_t length = (end - begin) * BUSTUB_PAGE_SIZE;
+    size_t read_count = 0;
+    if (offset >= file_size) {
+      LOG_DEBUG("I/O error reading past end of file");
+    } else {
+      iovecs.clear();
+      for (size_t i = begin; i < end; i++) {
+        iovecs.push_back({sorted_reads[i].second, static_cast<size_t>(BUSTUB_PAGE_SIZE)});
+      }
+      // A short read leaves the rest of the run to read again, starting at the first buffer not filled completely.
+      while (read_count < length) {
+        size_t first = read_count / BUSTUB_PAGE_SIZE;
+        iovec head = iovecs[first];
+        iovecs[first].iov_base = static_cast<char *>(head.iov_base) + read_count % BUSTUB_PAGE_SIZE;
+        iovecs[first].iov_len = BUSTUB_PAGE_SIZE - read_count % BUSTUB_PAGE_SIZE;
+        ssize_t rc = preadv(fd_, iovecs.data() + first, static_cast<int>(iovecs.size() - first), offset + read_count);
+        iovecs[first] = head;
+        if (rc < 0 && errno == EINTR) {
+          continue;
+        }
+        if (rc < 0) {
+          LOG_DEBUG("I/O error while reading");
+        }
+        if (rc <= 0) {
+          break;
+        }
+        read_count += rc;
+      }
+    }
+    // Whatever lies past the end of the file reads as zeros.
+    for (size_t i = begin + read_count / BUSTUB_PAGE_SIZE; i < end; i++) {
+      size_t filled = i == begin + read_count / BUSTUB_PAGE_SIZE ? read_count % BUSTUB_PAGE_SIZE : 0;
+      memset(sorted_reads[i].second + filled, 0, BUSTUB_PAGE_SIZE - filled);
+    }
+    begin = end;
+  }
+}
+
+void DiskManagerPosix::Sync() {
+  writes_since_sync_ = 0;
+  if (fdatasync(fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+    return;
+  }
+  num_syncs_++;
+}
+
+auto DiskManagerPosix::GetNumPages() -> page_id_t {
+  return static_cast<page_id_t>((file_size_ + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerPosix::TruncatePages(page_id_t num_pages) {
+  auto size = static_cast<int64_t>(num_pages) * BUSTUB_PAGE_SIZE;
+  if (ftruncate(fd_, size) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+    return;
+  }
+  // Truncating also gives back the extents reserved past the new end.
+  file_size_ = size;
+  allocated_size_ = size;
+}
+
+void DiskManagerPosix::ReserveExtent(int64_t offset) {
+  int64_t end = offset + BUSTUB_PAGE_SIZE;
+  if (extent_size_ == 0 || end <= allocated_size_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  int64_t allocated = std::max<int64_t>(allocated_size_, file_size_);
+  if (extent_size_ == 0 || end <= allocated) {
+    return;
+  }
+  int64_t new_allocated = (end + extent_size_ - 1) / extent_size_ * extent_size_;
+  if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, allocated, new_allocated - allocated) != 0) {
+    // The file system cannot reserve space, so let the file grow page by page from now on.
+    LOG_DEBUG("cannot reserve an extent for the database file");
+    extent_size_ = 0;
+    return;
+  }
+  allocated_size_.store(new_allocated, std::memory_order_release);
+}
+
+void DiskManagerPosix::OnPageWritten(int64_t offset) {
+  // Another thread may have extended the file further meanwhile, so only ever grow the size.
+  int64_t end = offset + BUSTUB_PAGE_SIZE;
+  int64_t file_size = file_size_.load(std::memory_order_relaxed);
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end, std::memory_order_relaxed)) {
+  }
+  switch (fsync_policy_) {
+    case FsyncPolicy::Never:
+      return;
+    case FsyncPolicy::EveryWrite:
+      Sync();
+      return;
+    case FsyncPolicy::Periodic:
+      if (writes_since_sync_.fetch_add(1) + 1 == sync_interval_) {
+        Sync();
+      }
+      return;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,229 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_tablespace.cpp
+//
+// Identification: src/storage/disk/disk_manager_tablespace.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_tablespace.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskManagerTablespace::DiskManagerTablespace(const std::vector<std::string> &db_files, size_t stripe_pages,
+                                             FsyncPolicy fsync_policy)
+    : stripe_pages_(static_cast<page_id_t>(std::max<size_t>(stripe_pages, 1))) {
+  if (db_files.empty()) {
+    throw Exception("a tablespace needs at least one data file");
+  }
+  file_name_ = db_files[0];
+  OpenLog();
+  for (const auto &db_file : db_files) {
+    owned_files_.emplace_back(std::make_unique<DiskManagerPosix>(db_file, fsync_policy, 64, false));
+    files_.push_back(owned_files_.back().get());
+  }
+  StartQueues();
+}
+
+DiskManagerTablespace::DiskManagerTablespace(const std::vector<DiskManager *> &files, size_t stripe_pages)
+    : stripe_pages_(static_cast<page_id_t>(std::max<size_t>(stripe_pages, 1))), files_(files) {
+  BUSTUB_ASSERT(!files_.empty(), "a tablespace needs at least one data file");
+  StartQueues();
+}
+
+DiskManagerTablespace::~DiskManagerTablespace() { ShutDown(); }
+
+void DiskManagerTablespace::StartQueues() {
+  for (size_t i = 0; i < files_.size(); i++) {
+    queues_.emplace_back(std::make_unique<FileQueue>());
+  }
+  for (size_t i = 0; i < files_.size(); i++) {
+    queues_[i]->thread_ = std::thread([this, i] { ServeQueue(i); });
+  }
+}
+
+void DiskManagerTablespace::ShutDown() {
+  if (queues_.empty()) {
+    return;
+  }
+  for (auto &queue : queues_) {
+    {
+      std::scoped_lock<std::mutex> lock(queue->latch_);
+      queue->stop_ = true;
+    }
+    queue->cv_.notify_one();
+    queue->thread_.join();
+  }
+  queues_.clear();
+  for (auto *file : files_) {
+    file->ShutDown();
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerTablespace::WritePage(page_id_t page_id, const char *page_data) {
+  num_writes_ += 1;
+  files_[FileOf(page_id)]->WritePage(LocalPageId(page_id), page_data);
+}
+
+void DiskManagerTablespace::ReadPage(page_id_t page_id, char *page_data) {
+  files_[FileOf(page_id)]->ReadPage(LocalPageId(page_id), page_data);
+}
+
+void DiskManagerTablespace::ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) {
+  if (reads.empty()) {
+    return;
+  }
+  size_t file_index = FileOf(reads[0].first);
+  auto in_file = [&](const auto &read) { return FileOf(read.first) == file_index; };
+  if (std::all_of(reads.begin(), reads.end(), in_file)) {
+    std::vector<std::pair<page_id_t, char *>> local_reads;
+    local_reads.reserve(reads.size());
+    for (const auto &[page_id, page_data] : reads) {
+      local_reads.emplace_back(LocalPageId(page_id), page_data);
+    }
+    files_[file_index]->ReadPages(local_reads);
+    return;
+  }
+  std::vector<AsyncIoRequest> requests;
+  requests.reserve(reads.size());
+  for (const auto &[page_id, page_data] : reads) {
+    requests.push_back({false, page_id, page_data, nullptr});
+  }
+  SubmitAndWait(std::move(requests));
+}
+
+void DiskManagerTablespace::WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) {
+  if (writes.empty()) {
+    return;
+  }
+  size_t file_index = FileOf(writes[0].first);
+  auto in_file = [&](const auto &write) { return FileOf(write.first) == file_index; };
+  if (std::all_of(writes.begin(), writes.end(), in_file)) {
+    std::vector<std::pair<page_id_t, const char *>> local_writes;
+    local_writes.reserve(writes.size());
+    for (const auto &[page_id, page_data] : writes) {
+      local_writes.emplace_back(LocalPageId(page_id), page_data);
+    }
+    num_writes_ += static_cast<int>(writes.size());
+    files_[file_index]->WritePages(local_writes);
+    return;
+  }
+  std::vector<AsyncIoRequest> requests;
+  requests.reserve(writes.size());
+  for (const auto &[page_id, page_data] : writes) {
+    // The data is only ever read from for a write.
+    requests.push_back({true, page_id, const_cast<char *>(page_data), nullptr});
+  }
+  SubmitAndWait(std::move(requests));
+}
+
+void DiskManagerTablespace::SubmitIo(std::vector<AsyncIoRequest> requests) {
+  std::vector<std::vector<AsyncIoRequest>> per_file(files_.size());
+  for (auto &request : requests) {
+    per_file[FileOf(request.page_id_)].push_back(std::move(request));
+  }
+  for (size_t i = 0; i < files_.size(); i++) {
+    if (per_file[i].empty()) {
+      continue;
+    }
+    FileQueue &queue = *queues_[i];
+    {
+      std::scoped_lock<std::mutex> lock(queue.latch_);
+      for (auto &request : per_file[i]) {
+        queue.requests_.push_back(std::move(request));
+      }
+    }
+    queue.cv_.notify_one();
+  }
+}
+
+void DiskManagerTablespace::SubmitAndWait(std::vector<AsyncIoRequest> requests) {
+  std::mutex latch;
+  std::condition_variable cv;
+  size_t num_pending = requests.size();
+  for (auto &request : requests) {
+    request.callback_ = [&latch, &cv, &num_pending](bool success) {
+      std::scoped_lock<std::mutex> lock(latch);
+      if (--num_pending == 0) {
+        cv.notify_one();
+      }
+    };
+  }
+  SubmitIo(std::move(requests));
+  std::unique_lock<std::mutex> lock(latch);
+  cv.wait(lock, [&num_pending] { return num_pending == 0; });
+}
+
+void DiskManagerTablespace::ServeQueue(size_t file_index) {
+  FileQueue &queue = *queues_[file_index];
+  DiskManager *file = files_[file_index];
+  while (true) {
+    std::deque<AsyncIoRequest> requests;
+    {
+      std::unique_lock<std::mutex> lock(queue.latch_);
+      queue.cv_.wait(lock, [&queue] { return queue.stop_ || !queue.requests_.empty(); });
+      if (queue.requests_.empty()) {
+        return;
+      }
+      requests.swap(queue.requests_);
+    }
+    // Hand everything that queued up to the file as one batch, so that runs of consecutive pages are coalesced.
+    std::vector<std::pair<page_id_t, const char *>> writes;
+    std::vector<std::pair<page_id_t, char *>> reads;
+    for (const auto &request : requests) {
+      if (request.is_write_) {
+        writes.emplace_back(LocalPageId(request.page_id_), request.data_);
+      } else {
+        reads.emplace_back(LocalPageId(request.page_id_), request.data_);
+      }
+    }
+    if (!writes.empty()) {
+      num_writes_ += static_cast<int>(writes.size());
+      file->WritePages(writes);
+    }
+    if (!reads.empty()) {
+      file->ReadPages(reads);
+    }
+    for (auto &request : requests) {
+      if (request.callback_) {
+        request.callback_(true);
+      }
+    }
+  }
+}
+
+auto DiskManagerTablespace::GetNumPages() -> page_id_t {
+  page_id_t num_pages = 0;
+  for (size_t i = 0; i < files_.size(); i++) {
+    page_id_t local_num_pages = files_[i]->GetNumPages();
+    if (local_num_pages > 0) {
+      num_pages = std::max(num_pages, GlobalPageId(i, local_num_pages - 1) + 1);
+    }
+  }
+  return num_pages;
+}
+
+void DiskManagerTablespace::TruncatePages(page_id_t num_pages) {
+  auto num_files = static_cast<page_id_t>(files_.size());
+  page_id_t round_pages = stripe_pages_ * num_files;
+  for (size_t i = 0; i < files_.size(); i++) {
+    // Every full round of stripes leaves a stripe in each file; the last, partial round may leave part of one.
+    page_id_t rest = num_pages % round_pages - static_cast<page_id_t>(i) * stripe_pages_;
+    page_id_t local_num_pages = num_pages / round_pages * stripe_pages_ + std::clamp(rest, 0, stripe_pages_);
+    if (files_[i]->GetNumPages() > local_num_pages) {
+      files_[i]->TruncatePages(local_num_pages);
+    }
+  }
+}
+
+}  // namespace bustub
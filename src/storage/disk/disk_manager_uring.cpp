@@ -0,0 +1,319 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define BUSTUB_HAVE_IO_URING
+#endif
+
+namespace bustub {
+
+struct DiskManagerUring::InFlight {
+  AsyncIoRequest request_;
+  int64_t offset_;
+  iovec iov_;
+};
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, uint32_t queue_depth, FsyncPolicy fsync_policy,
+                                   size_t sync_interval)
+    : DiskManagerPosix(db_file, fsync_policy, sync_interval) {
+  SetUpRing(queue_depth);
+}
+
+DiskManagerUring::~DiskManagerUring() { ShutDown(); }
+
+void DiskManagerUring::ShutDown() {
+  if (IsAsync()) {
+    {
+      std::unique_lock<std::mutex> lock(submit_latch_);
+      in_flight_cv_.wait(lock, [this] { return num_in_flight_ == 0; });
+      // A no-op without a request tells the completion thread to exit.
+      PushRequest(nullptr);
+      Enter(1);
+    }
+    reaper_thread_->join();
+    delete reaper_thread_;
+    reaper_thread_ = nullptr;
+    TearDownRing();
+  }
+  DiskManagerPosix::ShutDown();
+}
+
+void DiskManagerUring::SubmitIo(std::vector<AsyncIoRequest> requests) {
+  if (!IsAsync()) {
+    DiskManager::SubmitIo(std::move(requests));
+    return;
+  }
+  std::unique_lock<std::mutex> lock(submit_latch_);
+  uint32_t to_submit = 0;
+  for (auto &request : requests) {
+    // Never have more requests in flight than the completion queue holds, so that no completion is lost.
+    if (num_in_flight_ == cq_entries_ || to_submit == sq_entries_) {
+      Enter(to_submit);
+      to_submit = 0;
+      in_flight_cv_.wait(lock, [this] { return num_in_flight_ < cq_entries_; });
+    }
+    auto offset = static_cast<int64_t>(request.page_id_) * BUSTUB_PAGE_SIZE;
+    if (request.is_write_) {
+      ReserveExtent(offset);
+    }
+    auto *in_flight = new InFlight{std::move(request), offset, {}};
+    in_flight->iov_.iov_base = in_flight->request_.data_;
+    in_flight->iov_.iov_len = BUSTUB_PAGE_SIZE;
+    PushRequest(in_flight);
+    num_in_flight_++;
+    to_submit++;
+  }
+  Enter(to_submit);
+}
+
+void DiskManagerUring::ReadPages(const std::vector<std::pair<page_id_t, char *>> &reads) {
+  if (!IsAsync()) {
+    DiskManagerPosix::ReadPages(reads);
+    return;
+  }
+  std::vector<AsyncIoRequest> requests;
+  requests.reserve(reads.size());
+  for (const auto &[page_id, page_data] : reads) {
+    requests.push_back({false, page_id, page_data, nullptr});
+  }
+  SubmitAndWait(std::move(requests));
+}
+
+void DiskManagerUring::WritePages(const std::vector<std::pair<page_id_t, const char *>> &writes) {
+  if (!IsAsync()) {
+    DiskManagerPosix::WritePages(writes);
+    return;
+  }
+  std::vector<AsyncIoRequest> requests;
+  requests.reserve(writes.size());
+  for (const auto &[page_id, page_data] : writes) {
+    // The data is only ever read from for a write.
+    requests.push_back({true, page_id, const_cast<char *>(page_data), nullptr});
+  }
+  SubmitAndWait(std::move(requests));
+}
+
+void DiskManagerUring::SubmitAndWait(std::vector<AsyncIoRequest> requests) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t remaining = requests.size();
+  for (auto &request : requests) {
+    // Notify under the mutex, so that the waiter cannot return and destroy the mutex while it is still in use.
+    request.callback_ = [&mutex, &cv, &remaining](bool success) {
+      std::scoped_lock<std::mutex> lock(mutex);
+      if (--remaining == 0) {
+        cv.notify_all();
+      }
+    };
+  }
+  SubmitIo(std::move(requests));
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&remaining] { return remaining == 0; });
+}
+
+void DiskManagerUring::Complete(InFlight *request, int res) {
+  AsyncIoRequest &io = request->request_;
+  bool success = true;
+  if (res == -EINTR || res == -EAGAIN || (res >= 0 && io.is_write_ && res < BUSTUB_PAGE_SIZE)) {
+    // Interrupted, or a short write: just do it again synchronously. This runs on the reaper thread, so it must not
+    // go through ReadPages(), which would wait on a completion that only this thread can reap.
+    if (io.is_write_) {
+      DiskManagerPosix::WritePage(io.page_id_, io.data_);
+    } else {
+      DiskManagerPosix::ReadPages({{io.page_id_, io.data_}});
+    }
+  } else if (res < 0) {
+    LOG_DEBUG("I/O error in io_uring request");
+    success = false;
+  } else if (io.is_write_) {
+    num_writes_ += 1;
+    OnPageWritten(request->offset_);
+  } else if (res < BUSTUB_PAGE_SIZE) {
+    // Whatever lies past the end of the file reads as zeros.
+    memset(io.data_ + res, 0, BUSTUB_PAGE_SIZE - res);
+  }
+  if (io.callback_ != nullptr) {
+    io.callback_(success);
+  }
+  delete request;
+}
+
+#ifdef BUSTUB_HAVE_IO_URING
+
+void DiskManagerUring::SetUpRing(uint32_t queue_depth) {
+  if (queue_depth == 0 || fd_ < 0) {
+    return;
+  }
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+  if (ring_fd < 0) {
+    LOG_INFO("io_uring is not available, falling back to synchronous I/O");
+    return;
+  }
+  ring_fd_ = ring_fd;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  auto map = [ring_fd](size_t size, off_t offset) -> void * {
+    void *ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+    return ring == MAP_FAILED ? nullptr : ring;
+  };
+  sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+  cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+  sqes_ = map(sqes_size_, IORING_OFF_SQES);
+  if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr) {
+    LOG_INFO("io_uring rings cannot be mapped, falling back to synchronous I/O");
+    TearDownRing();
+    return;
+  }
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  auto *cq = static_cast<char *>(cq_ring_);
+  sq_tail_ = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+  cq_head_ = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+  sq_entries_ = params.sq_entries;
+  cq_entries_ = params.cq_entries;
+  reaper_thread_ = new std::thread(&DiskManagerUring::ReapCompletions, this);
+}
+
+void DiskManagerUring::TearDownRing() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  sqes_ = cq_ring_ = sq_ring_ = nullptr;
+  close(ring_fd_);
+  ring_fd_ = -1;
+}
+
+void DiskManagerUring::PushRequest(InFlight *request) {
+  // Only submitters write the tail, and they hold submit_latch_, so the tail can be read without ordering.
+  uint32_t tail = *sq_tail_;
+  uint32_t index = tail & *sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  if (request == nullptr) {
+    sqe->opcode = IORING_OP_NOP;
+  } else {
+    // The vectored opcodes are the oldest ones, so they work on every kernel that has io_uring at all.
+    sqe->opcode = request->request_.is_write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = fd_;
+    sqe->off = request->offset_;
+    sqe->addr = reinterpret_cast<uint64_t>(&request->iov_);
+    sqe->len = 1;
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  // Publish the entry before the kernel can see the new tail.
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+}
+
+void DiskManagerUring::Enter(uint32_t to_submit) {
+  while (to_submit > 0) {
+    auto rc = syscall(__NR_io_uring_enter, ring_fd_, to_submit, 0, 0, nullptr, 0);
+    if (rc < 0) {
+      if (errno == EINTR || errno == EAGAIN) {
+        continue;
+      }
+      throw Exception(ExceptionType::EXECUTION, "io_uring_enter failed");
+    }
+    to_submit -= static_cast<uint32_t>(rc);
+  }
+}
+
+void DiskManagerUring::ReapCompletions() {
+  auto *cqes = static_cast<io_uring_cqe *>(cqes_);
+  while (true) {
+    // Only this thread writes the head; the kernel publishes completions by moving the tail.
+    uint32_t head = *cq_head_;
+    uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      auto rc = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (rc < 0 && errno != EINTR) {
+        LOG_DEBUG("io_uring_enter failed while waiting for completions");
+      }
+      continue;
+    }
+    bool stop = false;
+    uint32_t num_completed = 0;
+    for (; head != tail; head++) {
+      io_uring_cqe *cqe = &cqes[head & *cq_mask_];
+      auto *request = reinterpret_cast<InFlight *>(cqe->user_data);
+      int res = cqe->res;
+      // Hand the entry back to the kernel before running the callback, which may take a while.
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      if (request == nullptr) {
+        stop = true;
+        continue;
+      }
+      Complete(request, res);
+      num_completed++;
+    }
+    if (num_completed > 0) {
+      std::scoped_lock<std::mutex> lock(submit_latch_);
+      num_in_flight_ -= num_completed;
+      in_flight_cv_.notify_all();
+    }
+    if (stop) {
+      return;
+    }
+  }
+}
+
+#else
+
+void DiskManagerUring::SetUpRing(uint32_t queue_depth) {
+  if (queue_depth > 0) {
+    LOG_INFO("io_uring is not available, falling back to synchronous I/O");
+  }
+}
+
+void DiskManagerUring::TearDownRing() {}
+
+void DiskManagerUring::PushRequest(InFlight *request) {}
+
+void DiskManagerUring::Enter(uint32_t to_submit) {}
+
+void DiskManagerUring::ReapCompletions() {}
+
+#endif
+
+}  // namespace bustub
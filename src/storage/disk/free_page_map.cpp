@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.cpp
+//
+// Identification: src/storage/disk/free_page_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_map.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+FreePageMap::FreePageMap(DiskManager *disk_manager, uint32_t num_instances)
+    : disk_manager_(disk_manager), num_instances_(num_instances), free_pages_(num_instances) {
+  BUSTUB_ASSERT(num_instances > 0, "a free page map needs at least one buffer pool instance");
+  std::scoped_lock<std::mutex> lock(latch_);
+  num_pages_ = disk_manager_->GetNumPages();
+  map_pages_.resize(NumRanges(num_pages_));
+  dirty_.resize(map_pages_.size(), false);
+  for (size_t range = 0; range < map_pages_.size(); range++) {
+    char *data = map_pages_[range].data();
+    auto first_page_id = static_cast<page_id_t>(range * PAGES_PER_MAP_PAGE);
+    disk_manager_->ReadPage(first_page_id + 1, data);
+    uint32_t header[2];
+    memcpy(header, data, sizeof(header));
+    if (header[0] != MAP_PAGE_MAGIC || header[1] != range) {
+      if (std::any_of(data, data + BUSTUB_PAGE_SIZE, [](char c) { return c != 0; })) {
+        throw Exception("the database file has no free page map, or it is corrupted");
+      }
+      // The map page was never written, so nothing in its range is known to be free.
+      header[0] = MAP_PAGE_MAGIC;
+      header[1] = static_cast<uint32_t>(range);
+      memcpy(data, header, sizeof(header));
+      dirty_[range] = true;
+    }
+    for (page_id_t bit = 0; bit < PAGES_PER_MAP_PAGE; bit++) {
+      if ((data[MAP_PAGE_HEADER_SIZE + bit / 8] & (1 << (bit % 8))) == 0) {
+        continue;
+      }
+      page_id_t page_id = first_page_id + bit;
+      if (page_id >= num_pages_ || IsMapPage(page_id)) {
+        // Freed pages past the end of the file were never written; the file may grow over them again.
+        SetBit(page_id, false);
+        continue;
+      }
+      free_pages_[page_id % num_instances_].insert(page_id);
+    }
+  }
+  for (size_t range = 0; range < map_pages_.size(); range++) {
+    WriteMapPage(range);
+  }
+}
+
+FreePageMap::~FreePageMap() { Flush(); }
+
+auto FreePageMap::AllocatePage(uint32_t instance_index) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &free_pages = free_pages_[instance_index % num_instances_];
+  if (!free_pages.empty()) {
+    page_id_t page_id = *free_pages.begin();
+    free_pages.erase(free_pages.begin());
+    SetBit(page_id, false);
+    // The page is about to be written, so the map must no longer say it is free if there is a crash.
+    WriteMapPage(page_id / PAGES_PER_MAP_PAGE);
+    return page_id;
+  }
+
+  page_id_t page_id = num_pages_;
+  while (page_id % num_instances_ != instance_index % num_instances_ || IsMapPage(page_id)) {
+    page_id++;
+  }
+  ResizeMap(page_id + 1);
+  // The pages skipped over belong to other instances; they get them from the map.
+  for (page_id_t skipped = num_pages_; skipped < page_id; skipped++) {
+    if (!IsMapPage(skipped)) {
+      SetBit(skipped, true);
+      free_pages_[skipped % num_instances_].insert(skipped);
+    }
+  }
+  num_pages_ = page_id + 1;
+  return page_id;
+}
+
+void FreePageMap::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (page_id < 0 || page_id >= num_pages_ || IsMapPage(page_id) || TestBit(page_id)) {
+    return;
+  }
+  SetBit(page_id, true);
+  free_pages_[page_id % num_instances_].insert(page_id);
+}
+
+auto FreePageMap::IsFree(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_id >= 0 && page_id < num_pages_ && TestBit(page_id);
+}
+
+auto FreePageMap::GetNumFreePages() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  size_t num_free_pages = 0;
+  for (const auto &free_pages : free_pages_) {
+    num_free_pages += free_pages.size();
+  }
+  return num_free_pages;
+}
+
+auto FreePageMap::GetNumPages() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_pages_;
+}
+
+auto FreePageMap::TruncateFreePages() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_id_t num_pages = num_pages_;
+  while (num_pages > 0 && (IsMapPage(num_pages - 1) || TestBit(num_pages - 1))) {
+    num_pages--;
+  }
+  if (num_pages == num_pages_) {
+    return 0;
+  }
+  for (page_id_t page_id = num_pages; page_id < num_pages_; page_id++) {
+    if (!IsMapPage(page_id) && TestBit(page_id)) {
+      SetBit(page_id, false);
+      free_pages_[page_id % num_instances_].erase(page_id);
+    }
+  }
+  num_pages_ = num_pages;
+  ResizeMap(num_pages);
+  // The pages cut off may be handed out again later, so the map must not say they are free if there is a crash.
+  for (size_t range = 0; range < map_pages_.size(); range++) {
+    WriteMapPage(range);
+  }
+  page_id_t file_pages = disk_manager_->GetNumPages();
+  if (file_pages <= num_pages) {
+    return 0;
+  }
+  disk_manager_->TruncatePages(num_pages);
+  return file_pages - num_pages;
+}
+
+void FreePageMap::Flush() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (size_t range = 0; range < map_pages_.size(); range++) {
+    WriteMapPage(range);
+  }
+}
+
+auto FreePageMap::TestBit(page_id_t page_id) const -> bool {
+  const MapPage &map_page = map_pages_[page_id / PAGES_PER_MAP_PAGE];
+  page_id_t bit = page_id % PAGES_PER_MAP_PAGE;
+  return (map_page[MAP_PAGE_HEADER_SIZE + bit / 8] & (1 << (bit % 8))) != 0;
+}
+
+void FreePageMap::SetBit(page_id_t page_id, bool is_free) {
+  size_t range = page_id / PAGES_PER_MAP_PAGE;
+  page_id_t bit = page_id % PAGES_PER_MAP_PAGE;
+  char &byte = map_pages_[range][MAP_PAGE_HEADER_SIZE + bit / 8];
+  if (is_free) {
+    byte = static_cast<char>(byte | (1 << (bit % 8)));
+  } else {
+    byte = static_cast<char>(byte & ~(1 << (bit % 8)));
+  }
+  dirty_[range] = true;
+}
+
+void FreePageMap::ResizeMap(page_id_t num_pages) {
+  size_t num_ranges = NumRanges(num_pages);
+  while (map_pages_.size() < num_ranges) {
+    MapPage &map_page = map_pages_.emplace_back();
+    map_page.fill(0);
+    uint32_t header[2] = {MAP_PAGE_MAGIC, static_cast<uint32_t>(map_pages_.size() - 1)};
+    memcpy(map_page.data(), header, sizeof(header));
+    dirty_.push_back(true);
+  }
+  map_pages_.resize(num_ranges);
+  dirty_.resize(num_ranges);
+}
+
+void FreePageMap::WriteMapPage(size_t range) {
+  if (!dirty_[range]) {
+    return;
+  }
+  disk_manager_->WritePage(static_cast<page_id_t>(range * PAGES_PER_MAP_PAGE + 1), map_pages_[range].data());
+  dirty_[range] = false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,362 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+auto PaxPage::GetSpaceNeeded(const Schema &schema) -> uint32_t {
+  uint32_t space_needed = 1;
+  for (const auto &column : schema.GetColumns()) {
+    space_needed += GetColumnWidth(column);
+  }
+  return space_needed;
+}
+
+auto PaxPage::GetCapacity(const Schema &schema) -> uint32_t {
+  size_t header_size = OFFSET_COLUMNS + SIZE_COLUMN * schema.GetColumnCount();
+  if (header_size >= BUSTUB_PAGE_SIZE) {
+    return 0;
+  }
+  return static_cast<uint32_t>((BUSTUB_PAGE_SIZE - header_size) / GetSpaceNeeded(schema));
+}
+
+auto PaxPage::IsStorable(const Tuple &tuple, const Schema &schema) -> bool {
+  if (tuple.GetLength() < schema.GetLength()) {
+    return false;
+  }
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const auto &column = schema.GetColumn(column_idx);
+    uint32_t offset = *reinterpret_cast<const uint32_t *>(tuple.GetData() + column.GetOffset());
+    if (offset + sizeof(uint32_t) > tuple.GetLength()) {
+      return false;
+    }
+    uint32_t len = *reinterpret_cast<const uint32_t *>(tuple.GetData() + offset);
+    if (len != BUSTUB_VALUE_NULL && sizeof(uint32_t) + len > GetColumnWidth(column)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_page_id, const Schema &schema, LogManager *log_manager,
+                   Transaction *txn) {
+  uint32_t capacity = GetCapacity(schema);
+  BUSTUB_ASSERT(capacity > 0, "A tuple of the schema must fit a PAX page.");
+  // Set the page ID.
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  // Log that we are creating a new page.
+  if (enable_logging) {
+    LogRecord log_record =
+        LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::NEWPAGE, prev_page_id, page_id);
+    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  // Set the previous and next page IDs, at the same place as a TablePage does.
+  SetField(OFFSET_PREV_PAGE_ID, prev_page_id);
+  SetField(OFFSET_NEXT_PAGE_ID, INVALID_PAGE_ID);
+  SetField(OFFSET_MAGIC, MAGIC);
+  SetField(OFFSET_TUPLE_COUNT, 0);
+  SetField(OFFSET_USED_COUNT, 0);
+  SetField(OFFSET_CAPACITY, capacity);
+  SetField(OFFSET_COLUMN_COUNT, schema.GetColumnCount());
+
+  // Every slot starts out empty, and the minipages follow the slot states.
+  uint32_t offset = OFFSET_COLUMNS + SIZE_COLUMN * schema.GetColumnCount();
+  memset(GetData() + offset, SLOT_EMPTY, capacity);
+  offset += capacity;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    SetField(OFFSET_COLUMNS + SIZE_COLUMN * i, static_cast<uint32_t>(column.GetType()));
+    SetField(OFFSET_COLUMNS + SIZE_COLUMN * i + 4, GetColumnWidth(column));
+    SetField(OFFSET_COLUMNS + SIZE_COLUMN * i + 8, offset);
+    offset += GetColumnWidth(column) * capacity;
+  }
+}
+
+auto PaxPage::InsertTuple(const Tuple &tuple, RID *rid) -> bool {
+  BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+  if (GetField(OFFSET_USED_COUNT) == GetField(OFFSET_CAPACITY) || !Fits(tuple)) {
+    return false;
+  }
+
+  // Reuse the first empty slot, or else claim a new one; there is one, since not every slot is used.
+  uint32_t slot_num = 0;
+  while (slot_num < GetTupleCount() && GetSlotState(slot_num) != SLOT_EMPTY) {
+    slot_num++;
+  }
+  WriteTuple(slot_num, tuple);
+  SetSlotState(slot_num, SLOT_LIVE);
+  SetField(OFFSET_USED_COUNT, GetField(OFFSET_USED_COUNT) + 1);
+  if (slot_num == GetTupleCount()) {
+    SetField(OFFSET_TUPLE_COUNT, slot_num + 1);
+  }
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
+auto PaxPage::MarkDelete(const RID &rid) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetSlotState(slot_num) != SLOT_LIVE) {
+    return false;
+  }
+  SetSlotState(slot_num, SLOT_DELETED);
+  return true;
+}
+
+auto PaxPage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid) -> bool {
+  BUSTUB_ASSERT(new_tuple.size_ > 0, "Cannot have empty tuples.");
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetSlotState(slot_num) != SLOT_LIVE || !Fits(new_tuple)) {
+    return false;
+  }
+  // Copy out the old value, then overwrite the entries in place: they are as wide as ever.
+  BUSTUB_ENSURE(ReadTuple(slot_num, old_tuple, nullptr), "A tuple in the page can be read back.");
+  old_tuple->rid_ = rid;
+  WriteTuple(slot_num, new_tuple);
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RID &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  // This either commits a delete, or rolls back an insert.
+  if (GetSlotState(slot_num) != SLOT_EMPTY) {
+    SetSlotState(slot_num, SLOT_EMPTY);
+    SetField(OFFSET_USED_COUNT, GetField(OFFSET_USED_COUNT) - 1);
+  }
+}
+
+void PaxPage::RollbackDelete(const RID &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  BUSTUB_ASSERT(slot_num < GetTupleCount(), "We can't have more slots than tuples.");
+  if (GetSlotState(slot_num) == SLOT_DELETED) {
+    SetSlotState(slot_num, SLOT_LIVE);
+  }
+}
+
+auto PaxPage::GetTuple(const RID &rid, Tuple *tuple) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsVisible(slot_num) || !ReadTuple(slot_num, tuple, nullptr)) {
+    return false;
+  }
+  tuple->rid_ = rid;
+  return true;
+}
+
+auto PaxPage::GetTupleOptimistic(const RID &rid, Tuple *tuple) -> bool {
+  // The page may be changing underneath, so check every bound that reading the tuple relies on.
+  return IsLayoutValid() && GetTuple(rid, tuple);
+}
+
+void PaxPage::GetTuples(TupleBatch *batch) {
+  Tuple tuple;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (IsVisible(i) && ReadTuple(i, &tuple, nullptr)) {
+      batch->Append(RID(GetTablePageId(), i), tuple.data_, tuple.size_);
+    }
+  }
+}
+
+auto PaxPage::TrimSlots() -> uint32_t {
+  uint32_t tuple_count = GetTupleCount();
+  uint32_t num_trimmed = 0;
+  while (num_trimmed < tuple_count && GetSlotState(tuple_count - num_trimmed - 1) == SLOT_EMPTY) {
+    num_trimmed++;
+  }
+  SetField(OFFSET_TUPLE_COUNT, tuple_count - num_trimmed);
+  return num_trimmed;
+}
+
+auto PaxPage::HasMarkedTuples() -> bool {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetSlotState(i) == SLOT_DELETED) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto PaxPage::GetFirstTupleRid(RID *first_rid) -> bool {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (IsVisible(i)) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
+    if (IsVisible(i)) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetFreeSpaceRemaining() -> uint32_t {
+  uint32_t space_needed = 1;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    space_needed += GetColumnWidth(i);
+  }
+  return (GetField(OFFSET_CAPACITY) - GetField(OFFSET_USED_COUNT)) * space_needed;
+}
+
+auto PaxPage::IsLayoutValid() -> bool {
+  uint64_t column_count = GetColumnCount();
+  uint64_t capacity = GetField(OFFSET_CAPACITY);
+  if (column_count == 0 || column_count > (BUSTUB_PAGE_SIZE - OFFSET_COLUMNS) / SIZE_COLUMN ||
+      GetTupleCount() > capacity) {
+    return false;
+  }
+  uint64_t body_offset = OFFSET_COLUMNS + SIZE_COLUMN * column_count + capacity;
+  if (body_offset > BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  for (uint32_t i = 0; i < column_count; i++) {
+    uint64_t width = GetColumnWidth(i);
+    uint64_t offset = GetField(OFFSET_COLUMNS + SIZE_COLUMN * i + 8);
+    if (width < sizeof(uint32_t) && GetColumnType(i) == TypeId::VARCHAR) {
+      return false;
+    }
+    if (offset < body_offset || offset + width * capacity > BUSTUB_PAGE_SIZE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto PaxPage::Fits(const Tuple &tuple) -> bool {
+  uint32_t tuple_offset = 0;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    if (GetColumnType(i) != TypeId::VARCHAR) {
+      tuple_offset += GetColumnWidth(i);
+      continue;
+    }
+    if (tuple_offset + VARCHAR_FIXED_LENGTH > tuple.size_) {
+      return false;
+    }
+    uint32_t offset = *reinterpret_cast<uint32_t *>(tuple.data_ + tuple_offset);
+    if (offset + sizeof(uint32_t) > tuple.size_) {
+      return false;
+    }
+    uint32_t len = *reinterpret_cast<uint32_t *>(tuple.data_ + offset);
+    if (len != BUSTUB_VALUE_NULL &&
+        (sizeof(uint32_t) + len > GetColumnWidth(i) || offset + sizeof(uint32_t) + len > tuple.size_)) {
+      return false;
+    }
+    tuple_offset += VARCHAR_FIXED_LENGTH;
+  }
+  return tuple_offset <= tuple.size_;
+}
+
+void PaxPage::WriteTuple(uint32_t slot_num, const Tuple &tuple) {
+  uint32_t tuple_offset = 0;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    uint32_t width = GetColumnWidth(i);
+    char *entry = GetData() + GetField(OFFSET_COLUMNS + SIZE_COLUMN * i + 8) + width * slot_num;
+    if (GetColumnType(i) != TypeId::VARCHAR) {
+      memcpy(entry, tuple.data_ + tuple_offset, width);
+      tuple_offset += width;
+      continue;
+    }
+    // The tuple keeps the length and the bytes of a VARCHAR behind its fixed-size part; the entry keeps them inline.
+    uint32_t offset = *reinterpret_cast<uint32_t *>(tuple.data_ + tuple_offset);
+    uint32_t len = *reinterpret_cast<uint32_t *>(tuple.data_ + offset);
+    memcpy(entry, tuple.data_ + offset, sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len));
+    tuple_offset += VARCHAR_FIXED_LENGTH;
+  }
+}
+
+auto PaxPage::GetColumns(uint32_t slot_num, const std::vector<bool> &read_columns, Tuple *tuple) -> bool {
+  if (!ReadTuple(slot_num, tuple, &read_columns)) {
+    return false;
+  }
+  tuple->rid_ = RID(GetTablePageId(), slot_num);
+  return true;
+}
+
+auto PaxPage::ReadTuple(uint32_t slot_num, Tuple *tuple, const std::vector<bool> *read_columns) -> bool {
+  uint32_t column_count = GetColumnCount();
+  // Size the tuple as Tuple(values, schema) would: the fixed-size part, then the length and bytes of every VARCHAR.
+  uint32_t fixed_size = 0;
+  uint32_t var_size = 0;
+  for (uint32_t i = 0; i < column_count; i++) {
+    uint32_t width = GetColumnWidth(i);
+    if (GetColumnType(i) != TypeId::VARCHAR) {
+      fixed_size += width;
+      continue;
+    }
+    uint32_t len = BUSTUB_VALUE_NULL;
+    if (read_columns == nullptr || (*read_columns)[i]) {
+      len = *reinterpret_cast<const uint32_t *>(GetColumnData(i) + width * slot_num);
+    }
+    if (len == BUSTUB_VALUE_NULL) {
+      len = 0;
+    } else if (sizeof(uint32_t) + len > width) {
+      return false;
+    }
+    fixed_size += VARCHAR_FIXED_LENGTH;
+    var_size += sizeof(uint32_t) + len;
+  }
+
+  if (!tuple->allocated_ || tuple->size_ < fixed_size + var_size) {
+    if (tuple->allocated_) {
+      delete[] tuple->data_;
+    }
+    tuple->data_ = new char[fixed_size + var_size];
+    tuple->allocated_ = true;
+  }
+  tuple->size_ = fixed_size + var_size;
+  memset(tuple->data_, 0, fixed_size);
+  uint32_t tuple_offset = 0;
+  uint32_t var_offset = fixed_size;
+  for (uint32_t i = 0; i < column_count; i++) {
+    uint32_t width = GetColumnWidth(i);
+    const char *entry = GetColumnData(i) + width * slot_num;
+    bool read = read_columns == nullptr || (*read_columns)[i];
+    // An optimistic read may see the page change between the two passes; stay within the tuple if it does.
+    if (GetColumnType(i) != TypeId::VARCHAR) {
+      if (tuple_offset + width > fixed_size) {
+        return false;
+      }
+      if (read) {
+        memcpy(tuple->data_ + tuple_offset, entry, width);
+      } else {
+        ValueFactory::GetNullValueByType(GetColumnType(i)).SerializeTo(tuple->data_ + tuple_offset);
+      }
+      tuple_offset += width;
+      continue;
+    }
+    uint32_t len = read ? *reinterpret_cast<const uint32_t *>(entry) : BUSTUB_VALUE_NULL;
+    uint32_t entry_size = sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len);
+    if (tuple_offset + VARCHAR_FIXED_LENGTH > fixed_size || entry_size > width ||
+        var_offset + entry_size > tuple->size_) {
+      return false;
+    }
+    memcpy(tuple->data_ + tuple_offset, &var_offset, sizeof(uint32_t));
+    memcpy(tuple->data_ + var_offset, read ? entry : reinterpret_cast<const char *>(&len), entry_size);
+    tuple_offset += VARCHAR_FIXED_LENGTH;
+    var_offset += entry_size;
+  }
+  return true;
+}
+
+}  // namespace bustub
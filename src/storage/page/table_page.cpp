@@ -37,6 +37,9 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
 
 auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
                             LogManager *log_manager) -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->InsertTuple(tuple, rid);
+  }
   BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
   // If there is not enough space, then return false.
   if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
@@ -91,6 +94,9 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
 
 auto TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
     -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->MarkDelete(rid);
+  }
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort the transaction.
   if (slot_num >= GetTupleCount()) {
@@ -138,6 +144,9 @@ auto TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_m
 
 auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                             LockManager *lock_manager, LogManager *log_manager) -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->UpdateTuple(new_tuple, old_tuple, rid);
+  }
   BUSTUB_ASSERT(new_tuple.size_ > 0, "Cannot have empty tuples.");
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort the transaction.
@@ -209,6 +218,10 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
 }
 
 void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+  if (IsPaxPage()) {
+    AsPaxPage()->ApplyDelete(rid);
+    return;
+  }
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -260,6 +273,10 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
 }
 
 void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+  if (IsPaxPage()) {
+    AsPaxPage()->RollbackDelete(rid);
+    return;
+  }
   // Log the rollback.
   /**
    * Removed to support new lock manager API for p4 (multilevel locking); Big hack energy
@@ -283,6 +300,9 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
 }
 
 auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->GetTuple(rid, tuple);
+  }
   // Get the current slot number.
   uint32_t slot_num = rid.GetSlotNum();
   // If somehow we have more slots than tuples, abort the transaction.
@@ -326,7 +346,82 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
+auto TablePage::GetTupleOptimistic(const RID &rid, Tuple *tuple) -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->GetTupleOptimistic(rid, tuple);
+  }
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num + sizeof(uint32_t) > BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  if (IsDeleted(tuple_size) || tuple_offset > BUSTUB_PAGE_SIZE || tuple_size > BUSTUB_PAGE_SIZE - tuple_offset) {
+    return false;
+  }
+  tuple->size_ = tuple_size;
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = new char[tuple->size_];
+  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
+  tuple->rid_ = rid;
+  tuple->allocated_ = true;
+  return true;
+}
+
+void TablePage::GetTuples(TupleBatch *batch) {
+  if (IsPaxPage()) {
+    AsPaxPage()->GetTuples(batch);
+    return;
+  }
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (!IsDeleted(tuple_size)) {
+      batch->Append(RID(GetTablePageId(), i), GetData() + GetTupleOffsetAtSlot(i), tuple_size);
+    }
+  }
+}
+
+void TablePage::GetTupleViews(std::vector<TupleView> *views) {
+  BUSTUB_ASSERT(!IsPaxPage(), "A PAX page has no tuple views.");
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (!IsDeleted(tuple_size)) {
+      views->emplace_back(RID(GetTablePageId(), i), GetData() + GetTupleOffsetAtSlot(i), tuple_size);
+    }
+  }
+}
+
+auto TablePage::TrimSlots() -> uint32_t {
+  if (IsPaxPage()) {
+    return AsPaxPage()->TrimSlots();
+  }
+  uint32_t tuple_count = GetTupleCount();
+  uint32_t num_trimmed = 0;
+  while (num_trimmed < tuple_count && GetTupleSize(tuple_count - num_trimmed - 1) == 0) {
+    num_trimmed++;
+  }
+  SetTupleCount(tuple_count - num_trimmed);
+  return num_trimmed;
+}
+
+auto TablePage::HasMarkedTuples() -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->HasMarkedTuples();
+  }
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    if ((GetTupleSize(i) & DELETE_MASK) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->GetFirstTupleRid(first_rid);
+  }
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     if (!IsDeleted(GetTupleSize(i))) {
@@ -339,6 +434,9 @@ auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
 }
 
 auto TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
+  if (IsPaxPage()) {
+    return AsPaxPage()->GetNextTupleRid(cur_rid, next_rid);
+  }
   BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); ++i) {
@@ -0,0 +1,276 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+auto FreeSpaceMap::Create() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(write_latch_);
+  BUSTUB_ASSERT(map_page_ids_.empty(), "the map already has pages");
+  if (!AddMapPage()) {
+    return INVALID_PAGE_ID;
+  }
+  return map_page_ids_[0];
+}
+
+auto FreeSpaceMap::Load(page_id_t root_page_id, const std::unordered_set<page_id_t> &heap_page_ids) -> bool {
+  std::scoped_lock<std::mutex> write_lock(write_latch_);
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  BUSTUB_ASSERT(map_page_ids_.empty(), "the map already has pages");
+  size_t num_stored_entries = 0;
+  page_id_t map_page_id = root_page_id;
+  while (map_page_id != INVALID_PAGE_ID) {
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_id));
+    if (map_page == nullptr) {
+      break;
+    }
+    map_page->RLatch();
+    if (!map_page->IsMapPage()) {
+      map_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(map_page_id, false);
+      break;
+    }
+    // A map page is only ever added once the ones before it are full.
+    BUSTUB_ASSERT(num_stored_entries == map_page_ids_.size() * FreeSpaceMapPage::MAX_ENTRIES,
+                  "map page out of order");
+    map_page_ids_.push_back(map_page_id);
+    num_stored_entries += map_page->GetEntryCount();
+    for (uint32_t i = 0; i < map_page->GetEntryCount(); i++) {
+      if (heap_page_ids.count(map_page->GetPageId(i)) == 0 || entry_of_.count(map_page->GetPageId(i)) > 0) {
+        continue;
+      }
+      size_t index = entries_.size();
+      entries_.emplace_back(map_page->GetPageId(i), map_page->GetCategory(i));
+      entry_of_.emplace(map_page->GetPageId(i), index);
+      by_category_.emplace(map_page->GetCategory(i), index);
+    }
+    page_id_t next_page_id = map_page->GetNextPageId();
+    map_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_id, false);
+    map_page_id = next_page_id;
+  }
+  if (entries_.size() < num_stored_entries) {
+    // Stale entries were dropped, and the ones after them moved up; the next write-back rewrites the pages.
+    for (size_t i = 0; i < map_page_ids_.size(); i++) {
+      changed_map_pages_.insert(i);
+    }
+  }
+  return !map_page_ids_.empty();
+}
+
+auto FreeSpaceMap::GetRootPageId() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(write_latch_);
+  return map_page_ids_.empty() ? INVALID_PAGE_ID : map_page_ids_[0];
+}
+
+auto FreeSpaceMap::FindPage(uint32_t size) -> page_id_t {
+  uint32_t category = (size + BYTES_PER_CATEGORY - 1) / BYTES_PER_CATEGORY;
+  if (category > UINT8_MAX) {
+    return INVALID_PAGE_ID;
+  }
+  static thread_local size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  auto fullest = by_category_.lower_bound({static_cast<uint8_t>(category), 0});
+  if (fullest == by_category_.end()) {
+    return INVALID_PAGE_ID;
+  }
+  // Among the fullest pages with room, start at this thread's own entry, and wrap around to the first one.
+  auto it = by_category_.lower_bound({fullest->first, hash % entries_.size()});
+  if (it == by_category_.end() || it->first != fullest->first) {
+    it = fullest;
+  }
+  return entries_[it->second].first;
+}
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  uint8_t category = ToCategory(free_space);
+  bool write_back;
+  {
+    std::scoped_lock<std::shared_mutex> lock(latch_);
+    size_t index;
+    auto it = entry_of_.find(page_id);
+    if (it == entry_of_.end()) {
+      index = entries_.size();
+      entries_.emplace_back(page_id, category);
+      entry_of_.emplace(page_id, index);
+    } else {
+      index = it->second;
+      if (entries_[index].second == category) {
+        return;
+      }
+      by_category_.erase({entries_[index].second, index});
+      entries_[index].second = category;
+    }
+    by_category_.emplace(category, index);
+    write_back = MarkChanged(index);
+  }
+  if (write_back) {
+    WriteBack(false);
+  }
+}
+
+void FreeSpaceMap::Remove(page_id_t page_id) {
+  bool write_back = false;
+  {
+    std::scoped_lock<std::shared_mutex> lock(latch_);
+    auto it = entry_of_.find(page_id);
+    if (it == entry_of_.end()) {
+      return;
+    }
+    size_t index = it->second;
+    entry_of_.erase(it);
+    by_category_.erase({entries_[index].second, index});
+    // Fill the gap from the end, keeping the entry recorded last at the end.
+    size_t last = entries_.size() - 1;
+    for (size_t from : {last - 1, last}) {
+      if (from <= index || from > last) {
+        continue;
+      }
+      by_category_.erase({entries_[from].second, from});
+      entries_[index] = entries_[from];
+      entry_of_[entries_[index].first] = index;
+      by_category_.emplace(entries_[index].second, index);
+      write_back = MarkChanged(index) || write_back;
+      index = from;
+    }
+    entries_.pop_back();
+    write_back = MarkChanged(last) || write_back;
+  }
+  if (write_back) {
+    WriteBack(false);
+  }
+}
+
+void FreeSpaceMap::Flush() { WriteBack(true); }
+
+auto FreeSpaceMap::GetFreeSpace(page_id_t page_id) -> uint32_t {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  auto it = entry_of_.find(page_id);
+  return it == entry_of_.end() ? 0 : entries_[it->second].second * BYTES_PER_CATEGORY;
+}
+
+auto FreeSpaceMap::GetLastPageId() -> page_id_t {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  return entries_.empty() ? INVALID_PAGE_ID : entries_.back().first;
+}
+
+auto FreeSpaceMap::GetNumPages() -> size_t {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  return entries_.size();
+}
+
+auto FreeSpaceMap::MarkChanged(size_t index) -> bool {
+  changed_map_pages_.insert(index / FreeSpaceMapPage::MAX_ENTRIES);
+  return ++num_changes_ >= WRITE_BACK_BATCH;
+}
+
+void FreeSpaceMap::WriteBack(bool wait) {
+  std::unique_lock<std::mutex> write_lock(write_latch_, std::defer_lock);
+  if (wait) {
+    write_lock.lock();
+  } else if (!write_lock.try_lock()) {
+    return;
+  }
+
+  // Copy out the changed map pages, so that the map is not held up while they are written.
+  size_t num_map_pages;
+  std::vector<std::pair<size_t, std::vector<std::pair<page_id_t, uint8_t>>>> changed_pages;
+  {
+    std::scoped_lock<std::shared_mutex> lock(latch_);
+    num_map_pages = std::max<size_t>(1, (entries_.size() + FreeSpaceMapPage::MAX_ENTRIES - 1) /
+                                            FreeSpaceMapPage::MAX_ENTRIES);
+    for (size_t map_page_index : changed_map_pages_) {
+      if (map_page_index >= num_map_pages) {
+        continue;
+      }
+      size_t begin = map_page_index * FreeSpaceMapPage::MAX_ENTRIES;
+      size_t end = std::min(entries_.size(), begin + FreeSpaceMapPage::MAX_ENTRIES);
+      changed_pages.emplace_back(map_page_index, std::vector<std::pair<page_id_t, uint8_t>>(
+                                                     entries_.begin() + static_cast<ptrdiff_t>(begin),
+                                                     entries_.begin() + static_cast<ptrdiff_t>(end)));
+    }
+    changed_map_pages_.clear();
+    num_changes_ = 0;
+  }
+
+  while (map_page_ids_.size() < num_map_pages && AddMapPage()) {
+  }
+  std::vector<size_t> unwritten_pages;
+  for (const auto &[map_page_index, entries] : changed_pages) {
+    FreeSpaceMapPage *map_page = nullptr;
+    if (map_page_index < map_page_ids_.size()) {
+      map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_ids_[map_page_index]));
+    }
+    if (map_page == nullptr) {
+      // The buffer pool is out of frames; the entries stay in memory and are written back another time.
+      unwritten_pages.push_back(map_page_index);
+      continue;
+    }
+    map_page->WLatch();
+    for (size_t i = 0; i < entries.size(); i++) {
+      map_page->SetEntry(i, entries[i].first, entries[i].second);
+    }
+    map_page->SetEntryCount(entries.size());
+    map_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_ids_[map_page_index], true);
+  }
+  if (!unwritten_pages.empty()) {
+    std::scoped_lock<std::shared_mutex> lock(latch_);
+    changed_map_pages_.insert(unwritten_pages.begin(), unwritten_pages.end());
+  }
+
+  // A map page is only ever added once the ones before it are full, so the empty ones can only be at the end.
+  while (map_page_ids_.size() > num_map_pages) {
+    page_id_t map_page_id = map_page_ids_.back();
+    map_page_ids_.pop_back();
+    auto prev_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_ids_.back()));
+    BUSTUB_ASSERT(prev_page != nullptr, "Couldn't fetch the previous map page.");
+    prev_page->WLatch();
+    prev_page->SetNextPageId(INVALID_PAGE_ID);
+    prev_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_ids_.back(), true);
+    buffer_pool_manager_->DeletePage(map_page_id);
+  }
+}
+
+auto FreeSpaceMap::AddMapPage() -> bool {
+  page_id_t map_page_id;
+  auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(&map_page_id));
+  if (map_page == nullptr) {
+    return false;
+  }
+  map_page->WLatch();
+  map_page->Init();
+  map_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(map_page_id, true);
+
+  if (!map_page_ids_.empty()) {
+    auto prev_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_ids_.back()));
+    BUSTUB_ASSERT(prev_page != nullptr, "Couldn't fetch the previous map page.");
+    prev_page->WLatch();
+    prev_page->SetNextPageId(map_page_id);
+    prev_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_ids_.back(), true);
+  }
+  map_page_ids_.push_back(map_page_id);
+  return true;
+}
+
+}  // namespace bustub
@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/logger.h"
 #include "fmt/format.h"
@@ -19,30 +23,106 @@
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, page_id_t free_space_map_root_id, const Schema *schema)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      free_space_map_(buffer_pool_manager) {
+  auto first_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  BUSTUB_ASSERT(first_page != nullptr, "Couldn't fetch the first page of the table heap.");
+  first_page->RLatch();
+  if (first_page->IsPaxPage()) {
+    BUSTUB_ASSERT(schema != nullptr, "A PAX table needs its schema to lay out new pages.");
+    format_ = TableFormat::PAX;
+    schema_ = std::make_unique<Schema>(*schema);
+  }
+  first_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+
+  // The map may have missed the last changes to the table, so check it against the page chain, and record what the
+  // pages have now.
+  std::vector<std::pair<page_id_t, uint32_t>> free_spaces;
+  std::unordered_set<page_id_t> page_ids;
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->RLatch();
+    free_spaces.emplace_back(page_id, page->GetFreeSpaceRemaining());
+    page_ids.insert(page_id);
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  if (free_space_map_root_id == INVALID_PAGE_ID || !free_space_map_.Load(free_space_map_root_id, page_ids)) {
+    // The table was written without a free space map; start one.
+    BUSTUB_ENSURE(free_space_map_.Create() != INVALID_PAGE_ID, "Couldn't create a page for the free space map.");
+  }
+  for (const auto &[page_id, free_space] : free_spaces) {
+    free_space_map_.Update(page_id, free_space);
+  }
+  flush_hook_id_ = buffer_pool_manager_->AddFlushHook([this] { free_space_map_.Flush(); });
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, TableFormat format, const Schema *schema)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      free_space_map_(buffer_pool_manager),
+      format_(format) {
+  if (format_ == TableFormat::PAX) {
+    BUSTUB_ASSERT(schema != nullptr && PaxPage::GetCapacity(*schema) > 0, "A tuple of the schema must fit a page.");
+    schema_ = std::make_unique<Schema>(*schema);
+  }
   // Initialize the first table page.
   auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  InitPage(first_page, first_page_id_, INVALID_LSN, txn);
+  BUSTUB_ENSURE(free_space_map_.Create() != INVALID_PAGE_ID, "Couldn't create a page for the free space map.");
+  RecordFreeSpace(first_page);
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  flush_hook_id_ = buffer_pool_manager_->AddFlushHook([this] { free_space_map_.Flush(); });
+}
+
+TableHeap::~TableHeap() {
+  buffer_pool_manager_->RemoveFlushHook(flush_hook_id_);
+  free_space_map_.Flush();
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
-  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+  if (!Fits(tuple)) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  // Try the pages the free space map says have room. A page may have filled up since it was recorded; recording what
+  // it has now keeps the map from offering it again.
+  uint32_t space_needed = GetSpaceNeeded(tuple);
+  for (auto page_id = free_space_map_.FindPage(space_needed); page_id != INVALID_PAGE_ID;
+       page_id = free_space_map_.FindPage(space_needed)) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    bool is_inserted = page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+    RecordFreeSpace(page);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, is_inserted);
+    if (is_inserted) {
+      // Update the transaction's write set.
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+  }
+
+  // No page has room, so the tuple goes to the end of the table. Start at the last page the map knows of; pages may
+  // have been appended after it.
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(free_space_map_.GetLastPageId()));
   if (cur_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
@@ -53,6 +133,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
   // INVARIANT: cur_page is WLatched if you leave the loop normally.
   while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+    RecordFreeSpace(cur_page);
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
@@ -76,12 +157,13 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       // Otherwise we were able to create a new page. We initialize it now.
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      InitPage(new_page, next_page_id, cur_page->GetTablePageId(), txn);
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
     }
   }
+  RecordFreeSpace(cur_page);
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
   cur_page->WUnlatch();
@@ -91,6 +173,87 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
   return true;
 }
 
+auto TableHeap::BulkInsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool {
+  for (const auto &tuple : tuples) {
+    if (!Fits(tuple)) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+  rids->clear();
+  rids->reserve(tuples.size());
+
+  // Only keep a share of the buffer pool pinned, so that other threads still find frames.
+  size_t max_batch_pages = std::max<size_t>(buffer_pool_manager_->GetPoolSize() / 8, 1);
+  std::vector<TablePage *> batch;
+  bool is_inserted = true;
+  for (const auto &tuple : tuples) {
+    RID rid;
+    if (batch.empty() || !batch.back()->InsertTuple(tuple, &rid, txn, lock_manager_, log_manager_)) {
+      if (batch.size() == max_batch_pages) {
+        AppendPages(batch);
+        batch.clear();
+      }
+      page_id_t page_id;
+      auto page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&page_id));
+      if (page == nullptr) {
+        is_inserted = false;
+        break;
+      }
+      page_id_t prev_page_id = batch.empty() ? INVALID_PAGE_ID : batch.back()->GetTablePageId();
+      InitPage(page, page_id, prev_page_id, txn);
+      if (!batch.empty()) {
+        batch.back()->SetNextPageId(page_id);
+      }
+      batch.push_back(page);
+      BUSTUB_ENSURE(page->InsertTuple(tuple, &rid, txn, lock_manager_, log_manager_), "a fresh page takes any tuple");
+    }
+    rids->push_back(rid);
+  }
+  if (!batch.empty()) {
+    AppendPages(batch);
+  }
+  // Update the transaction's write set.
+  for (const auto &rid : *rids) {
+    txn->GetWriteSet()->emplace_back(rid, WType::INSERT, Tuple{}, this);
+  }
+  if (!is_inserted) {
+    txn->SetState(TransactionState::ABORTED);
+  }
+  return is_inserted;
+}
+
+void TableHeap::AppendPages(const std::vector<TablePage *> &pages) {
+  // Find the end of the table. Start at the last page the map knows of; pages may have been appended after it.
+  auto last_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(free_space_map_.GetLastPageId()));
+  BUSTUB_ASSERT(last_page != nullptr, "Couldn't fetch the last page of the table heap.");
+  last_page->WLatch();
+  for (auto next_page_id = last_page->GetNextPageId(); next_page_id != INVALID_PAGE_ID;
+       next_page_id = last_page->GetNextPageId()) {
+    auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    BUSTUB_ASSERT(next_page != nullptr, "Couldn't fetch a page of the table heap.");
+    next_page->WLatch();
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), false);
+    last_page = next_page;
+  }
+
+  // Link the pages in, and record them while the end of the table is latched, so that the map keeps the chain order.
+  pages.front()->SetPrevPageId(last_page->GetTablePageId());
+  last_page->SetNextPageId(pages.front()->GetTablePageId());
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(pages.size());
+  for (auto page : pages) {
+    RecordFreeSpace(page);
+    page_ids.push_back(page->GetTablePageId());
+  }
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page->GetTablePageId(), true);
+
+  buffer_pool_manager_->FlushPages(page_ids);
+  buffer_pool_manager_->UnpinPages(page_ids, false);
+}
+
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
@@ -122,6 +285,9 @@ auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   Tuple old_tuple;
   page->WLatch();
   bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  if (is_updated) {
+    RecordFreeSpace(page);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
@@ -138,6 +304,7 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   // Delete the tuple from the page.
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
+  RecordFreeSpace(page);
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
@@ -157,6 +324,17 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
 }
 
 auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
+  if (acquire_read_lock) {
+    // Point lookups read the page optimistically, without pinning or latching it.
+    bool res = false;
+    bool fetched = buffer_pool_manager_->OptimisticReadPage(rid.GetPageId(), [rid, tuple, &res](Page *page) {
+      res = reinterpret_cast<TablePage *>(page)->GetTupleOptimistic(rid, tuple);
+    });
+    if (!fetched || (!res && enable_logging)) {
+      txn->SetState(TransactionState::ABORTED);
+    }
+    return res;
+  }
   // Find the page which contains the tuple.
   auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -164,25 +342,123 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
-  // Read the tuple from the page.
-  if (acquire_read_lock) {
-    page->RLatch();
-  }
+  // Read the tuple from the page. The caller takes care of latching it.
   bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
-  if (acquire_read_lock) {
-    page->RUnlatch();
-  }
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
   return res;
 }
 
+auto TableHeap::GetPageTuples(page_id_t page_id, TupleBatch *batch) -> page_id_t {
+  batch->Clear();
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+  page->RLatch();
+  page->GetTuples(batch);
+  auto next_page_id = page->GetNextPageId();
+  ReadAhead(next_page_id);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+auto TableHeap::GetPageTupleViews(page_id_t page_id, PageGuard *guard, std::vector<TupleView> *views) -> page_id_t {
+  views->clear();
+  auto next_page_id = ScanPage(page_id, guard);
+  static_cast<TablePage *>(guard->GetPage())->GetTupleViews(views);
+  return next_page_id;
+}
+
+auto TableHeap::ScanPage(page_id_t page_id, PageGuard *guard) -> page_id_t {
+  guard->Release();
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+  page->RLatch();
+  *guard = PageGuard(buffer_pool_manager_, page);
+  auto next_page_id = page->GetNextPageId();
+  ReadAhead(next_page_id);
+  return next_page_id;
+}
+
+auto TableHeap::VacuumPages(page_id_t page_id, size_t max_pages, const move_fn &on_move, Transaction *txn,
+                            size_t *num_freed_pages) -> page_id_t {
+  FreeUnfreedPages();
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (cur_page == nullptr) {
+    return page_id;
+  }
+  cur_page->WLatch();
+  bool cur_is_dirty = cur_page->TrimSlots() > 0;
+
+  // INVARIANT: cur_page is WLatched, and every page is latched in page chain order.
+  for (size_t num_pages = 0; num_pages < max_pages && cur_page->GetNextPageId() != INVALID_PAGE_ID; num_pages++) {
+    page_id_t next_page_id = cur_page->GetNextPageId();
+    auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    if (next_page == nullptr) {
+      break;
+    }
+    next_page->WLatch();
+    bool next_is_dirty = next_page->TrimSlots() > 0;
+
+    // The page after the next one has to point back to the current one once the next one is gone.
+    page_id_t after_page_id = next_page->GetNextPageId();
+    TablePage *after_page = nullptr;
+    if (after_page_id != INVALID_PAGE_ID) {
+      after_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(after_page_id));
+    }
+    bool moved_any = false;
+    if ((after_page_id == INVALID_PAGE_ID || after_page != nullptr) &&
+        MergeInto(cur_page, next_page, on_move, txn, &moved_any)) {
+      cur_is_dirty = true;
+      cur_page->SetNextPageId(after_page_id);
+      if (after_page != nullptr) {
+        after_page->WLatch();
+        after_page->SetPrevPageId(cur_page->GetTablePageId());
+        after_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(after_page_id, true);
+      }
+      free_space_map_.Remove(next_page_id);
+      next_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+      // Nothing links to the page any more; if a read-ahead still has it pinned, it is deleted by a later call.
+      if (!buffer_pool_manager_->DeletePage(next_page_id)) {
+        std::scoped_lock<std::mutex> lock(unfreed_latch_);
+        unfreed_page_ids_.push_back(next_page_id);
+      }
+      (*num_freed_pages)++;
+      continue;
+    }
+    if (after_page != nullptr) {
+      buffer_pool_manager_->UnpinPage(after_page_id, false);
+    }
+    if (moved_any) {
+      // Some tuples moved before the page ran out of room; both pages changed, and the indexes point at the moves.
+      cur_is_dirty = true;
+      next_is_dirty = true;
+    }
+
+    RecordFreeSpace(cur_page);
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), cur_is_dirty);
+    cur_page = next_page;
+    cur_is_dirty = next_is_dirty;
+  }
+
+  // Go on from the last page looked at, so that the next call can still merge the page after it into it.
+  RecordFreeSpace(cur_page);
+  page_id_t resume_page_id =
+      cur_page->GetNextPageId() == INVALID_PAGE_ID ? INVALID_PAGE_ID : cur_page->GetTablePageId();
+  cur_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), cur_is_dirty);
+  return resume_page_id;
+}
+
 auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
@@ -198,4 +474,73 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
+void TableHeap::InitPage(TablePage *page, page_id_t page_id, page_id_t prev_page_id, Transaction *txn) {
+  if (format_ == TableFormat::PAX) {
+    page->AsPaxPage()->Init(page_id, prev_page_id, *schema_, log_manager_, txn);
+  } else {
+    page->Init(page_id, BUSTUB_PAGE_SIZE, prev_page_id, log_manager_, txn);
+  }
+}
+
+auto TableHeap::Fits(const Tuple &tuple) -> bool {
+  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+    return false;
+  }
+  return format_ != TableFormat::PAX || PaxPage::IsStorable(tuple, *schema_);
+}
+
+auto TableHeap::MergeInto(TablePage *page, TablePage *next_page, const move_fn &on_move, Transaction *txn,
+                          bool *moved_any) -> bool {
+  // A delete that has yet to commit or roll back finds its tuple by RID, so the tuple must stay where it is.
+  if (next_page->HasMarkedTuples()) {
+    return false;
+  }
+  TupleBatch batch;
+  next_page->GetTuples(&batch);
+  Tuple tuple;
+  size_t space_needed = 0;
+  for (size_t i = 0; i < batch.Size(); i++) {
+    batch.GetTuple(i, &tuple);
+    space_needed += GetSpaceNeeded(tuple);
+  }
+  // Keep the merged page from filling up, so that it does not split up again with the next few inserts.
+  auto room_kept = static_cast<size_t>((1 - vacuum_merge_fill_ratio) * BUSTUB_PAGE_SIZE);
+  if (batch.Size() > 0 && page->GetFreeSpaceRemaining() < space_needed + room_kept) {
+    return false;
+  }
+
+  for (size_t i = 0; i < batch.Size(); i++) {
+    batch.GetTuple(i, &tuple);
+    RID new_rid;
+    if (!page->InsertTuple(tuple, &new_rid, txn, lock_manager_, log_manager_)) {
+      // The tuples moved so far are gone from the next page, so both pages are still consistent.
+      return false;
+    }
+    next_page->ApplyDelete(tuple.rid_, txn, log_manager_);
+    *moved_any = true;
+    on_move(tuple, new_rid);
+  }
+  return true;
+}
+
+void TableHeap::FreeUnfreedPages() {
+  std::scoped_lock<std::mutex> lock(unfreed_latch_);
+  std::vector<page_id_t> page_ids;
+  page_ids.swap(unfreed_page_ids_);
+  for (page_id_t page_id : page_ids) {
+    if (!buffer_pool_manager_->DeletePage(page_id)) {
+      unfreed_page_ids_.push_back(page_id);
+    }
+  }
+}
+
+void TableHeap::ReadAhead(page_id_t next_page_id) {
+  if (scan_read_ahead_distance == 0 || next_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  buffer_pool_manager_->PrefetchChain(next_page_id, scan_read_ahead_distance, [](Page *page) {
+    return reinterpret_cast<TablePage *>(page)->GetNextPageId();
+  });
+}
+
 }  // namespace bustub
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_vacuum.cpp
+//
+// Identification: src/storage/table/table_vacuum.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_vacuum.h"
+
+#include <vector>
+
+#include "storage/disk/free_page_map.h"
+
+namespace bustub {
+
+TableVacuum::TableVacuum(Catalog *catalog, BufferPoolManager *buffer_pool_manager, TransactionManager *txn_manager,
+                         LockManager *lock_manager, std::shared_mutex *catalog_latch)
+    : catalog_(catalog),
+      buffer_pool_manager_(buffer_pool_manager),
+      txn_manager_(txn_manager),
+      lock_manager_(lock_manager),
+      catalog_latch_(catalog_latch) {}
+
+TableVacuum::~TableVacuum() { Stop(); }
+
+void TableVacuum::Start() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (thread_ != nullptr) {
+    return;
+  }
+  stop_ = false;
+  thread_ = new std::thread(&TableVacuum::Run, this);
+}
+
+void TableVacuum::Stop() {
+  std::thread *thread;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (thread_ == nullptr) {
+      return;
+    }
+    thread = thread_;
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread->join();
+  delete thread;
+  std::scoped_lock<std::mutex> lock(latch_);
+  thread_ = nullptr;
+}
+
+auto TableVacuum::VacuumNext() -> size_t {
+  std::scoped_lock<std::mutex> lock(round_latch_);
+  {
+    std::shared_lock<std::shared_mutex> catalog_lock;
+    if (catalog_latch_ != nullptr) {
+      catalog_lock = std::shared_lock<std::shared_mutex>(*catalog_latch_);
+    }
+    // Table oids are handed out in order, so the first missing one is where the turns start over.
+    if (catalog_->GetTable(next_table_oid_) == Catalog::NULL_TABLE_INFO) {
+      next_table_oid_ = 0;
+    }
+  }
+  size_t num_freed_pages = 0;
+  // A table that is busy waits for its next turn rather than holding the others up.
+  if (!VacuumBatch(next_table_oid_, &num_freed_pages) || cursors_.count(next_table_oid_) == 0) {
+    next_table_oid_++;
+  }
+  return num_freed_pages;
+}
+
+auto TableVacuum::VacuumTable(table_oid_t table_oid) -> size_t {
+  std::scoped_lock<std::mutex> lock(round_latch_);
+  size_t num_freed_pages = 0;
+  while (VacuumBatch(table_oid, &num_freed_pages)) {
+    if (cursors_.count(table_oid) == 0) {
+      break;
+    }
+  }
+  return num_freed_pages;
+}
+
+auto TableVacuum::VacuumBatch(table_oid_t table_oid, size_t *num_freed_pages) -> bool {
+  std::shared_lock<std::shared_mutex> catalog_lock;
+  if (catalog_latch_ != nullptr) {
+    catalog_lock = std::shared_lock<std::shared_mutex>(*catalog_latch_);
+  }
+  TableInfo *table_info = catalog_->GetTable(table_oid);
+  // A mock table has no heap to vacuum.
+  if (table_info == Catalog::NULL_TABLE_INFO || table_info->table_ == nullptr) {
+    return false;
+  }
+  // The transactions the table lock waits for may need the catalog exclusively, e.g. to create an index, so the
+  // catalog is let go of while waiting.
+  if (catalog_lock.owns_lock()) {
+    catalog_lock.unlock();
+  }
+
+  Transaction *txn = txn_manager_->Begin();
+  bool is_locked = false;
+  try {
+    is_locked = lock_manager_->LockTable(txn, LockManager::LockMode::EXCLUSIVE, table_oid);
+  } catch (TransactionAbortException &e) {
+    is_locked = false;
+  }
+  if (!is_locked) {
+    // The lock manager aborted the round, e.g. to break a deadlock; the table gets another turn later.
+    txn_manager_->Abort(txn);
+    delete txn;
+    return false;
+  }
+  if (catalog_latch_ != nullptr) {
+    catalog_lock.lock();
+  }
+  if (catalog_->GetTable(table_oid) != table_info) {
+    txn_manager_->Abort(txn);
+    delete txn;
+    return false;
+  }
+  std::vector<IndexInfo *> indexes = catalog_->GetTableIndexes(table_info->name_);
+
+  auto on_move = [&](const Tuple &tuple, const RID &new_rid) {
+    for (auto *index_info : indexes) {
+      auto key = tuple.KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
+      index_info->index_->DeleteEntry(key, tuple.GetRid(), txn);
+      index_info->index_->InsertEntry(key, new_rid, txn);
+    }
+    num_moved_tuples_++;
+  };
+  auto cursor = cursors_.find(table_oid);
+  page_id_t page_id = cursor == cursors_.end() ? table_info->table_->GetFirstPageId() : cursor->second;
+  size_t num_freed = 0;
+  page_id_t next_page_id = table_info->table_->VacuumPages(page_id, vacuum_batch_pages, on_move, txn, &num_freed);
+  txn_manager_->Commit(txn);
+  delete txn;
+
+  *num_freed_pages += num_freed;
+  num_freed_pages_ += num_freed;
+  num_untruncated_pages_ += num_freed;
+  if (next_page_id != INVALID_PAGE_ID) {
+    cursors_[table_oid] = next_page_id;
+    // The round got nowhere if it could not get at the pages, e.g. because the buffer pool is full.
+    return next_page_id != page_id || num_freed > 0;
+  }
+
+  // A pass over the table is done. The pages it freed may have left free pages at the end of the database file.
+  cursors_.erase(table_oid);
+  FreePageMap *free_page_map = buffer_pool_manager_->GetFreePageMap();
+  if (free_page_map != nullptr && num_untruncated_pages_ > 0) {
+    free_page_map->TruncateFreePages();
+    num_untruncated_pages_ = 0;
+  }
+  return true;
+}
+
+void TableVacuum::Run() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      cv_.wait_for(lock, vacuum_interval, [this] { return stop_; });
+      if (stop_) {
+        return;
+      }
+    }
+    VacuumNext();
+  }
+}
+
+}  // namespace bustub
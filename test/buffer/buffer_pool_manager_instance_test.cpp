@@ -12,18 +12,23 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerInstanceTest, DISABLED_BinaryDataTest) {
+TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -89,7 +94,7 @@ TEST(BufferPoolManagerInstanceTest, DISABLED_BinaryDataTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerInstanceTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerInstanceTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -145,4 +150,530 @@ TEST(BufferPoolManagerInstanceTest, DISABLED_SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ScanResistanceTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 32;
+  const size_t k = 2;
+  const int num_hot_pages = 8;
+  const int num_scan_pages = 200;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: create enough pages on disk for the hot set and a scan much larger than the pool.
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_hot_pages + num_scan_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: look up the first pages once. They are the most recently used pages in the pool, but they do not have
+  // k accesses yet, so without the scan ring a scan would evict them just like any other page.
+  for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+    auto *page = bpm->FetchPage(page_id, AccessType::Lookup);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a sequential scan over the remaining pages only recycles the scan ring.
+  for (page_id_t page_id = num_hot_pages; page_id < num_hot_pages + num_scan_pages; ++page_id) {
+    auto *page = bpm->FetchPage(page_id, AccessType::Scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), page->GetData());
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: overwrite the hot pages on disk behind the buffer pool's back. Since they survived the scan, fetching
+  // them again returns the cached copies rather than reading the new contents.
+  char overwritten[BUSTUB_PAGE_SIZE] = "overwritten";
+  for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+    disk_manager->WritePage(page_id, overwritten);
+  }
+  for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), page->GetData());
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const size_t k = 2;
+
+  auto old_interval = bpm_writer_interval;
+  auto old_dirty_ratio = bpm_writer_dirty_ratio;
+  bpm_writer_interval = std::chrono::milliseconds(1);
+  bpm_writer_dirty_ratio = 0;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+  bpm->StartBackgroundWriter();
+
+  // Scenario: fill the pool with dirty pages. The background writer should clean all of them.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (int i = 0; i < 1000 && bpm->GetNumBackgroundFlushes() < buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetNumBackgroundFlushes());
+
+  // Scenario: evicting the clean pages does not make the foreground write anything.
+  bpm->StopBackgroundWriter();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumForegroundFlushes());
+
+  // Scenario: the pages written in the background can be read back.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), page->GetData());
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+  bpm_writer_interval = old_interval;
+  bpm_writer_dirty_ratio = old_dirty_ratio;
+}
+
+/** Counts the pages read from a DiskManagerMemory. */
+class CountingDiskManager : public DiskManagerMemory {
+ public:
+  explicit CountingDiskManager(size_t pages) : DiskManagerMemory(pages) {}
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManagerMemory::ReadPage(page_id, page_data);
+  }
+  std::atomic<int> num_reads_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const size_t buffer_pool_size = 64;
+  const size_t k = 2;
+  const int num_pages = 3 * buffer_pool_size;
+
+  auto *disk_manager = new CountingDiskManager(num_pages);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: write a chain of pages, each holding the id of the next one, then push them out of the pool.
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = i + 1 < num_pages ? page_id_temp + 1 : INVALID_PAGE_ID;
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto wait_for_reads = [disk_manager](int expected) {
+    for (int i = 0; i < 1000 && disk_manager->num_reads_ < expected; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(expected, disk_manager->num_reads_);
+  };
+
+  // Scenario: prefetched pages are read in the background, and fetching them afterwards does not touch the disk.
+  bpm->PrefetchPages({0, 1, 2, 3});
+  wait_for_reads(4);
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id + 1, *reinterpret_cast<page_id_t *>(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(4, disk_manager->num_reads_);
+
+  // Scenario: prefetching resident pages is a no-op.
+  bpm->PrefetchPages({0, 1, 2, 3});
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(4, disk_manager->num_reads_);
+
+  // Scenario: a chain is followed through the next page ids stored in the pages.
+  auto next_page = [](Page *page) { return *reinterpret_cast<page_id_t *>(page->GetData()); };
+  bpm->PrefetchChain(10, 5, next_page);
+  wait_for_reads(9);
+  for (page_id_t page_id = 10; page_id < 15; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(9, disk_manager->num_reads_);
+
+  // Scenario: fetching a page while it is being prefetched waits for the read instead of reading it twice.
+  for (page_id_t page_id = 20; page_id < 40; ++page_id) {
+    bpm->PrefetchPages({page_id});
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id + 1, *reinterpret_cast<page_id_t *>(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  wait_for_reads(29);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ReplacerPolicyTest) {
+  const size_t buffer_pool_size = 10;
+  for (auto replacer_type : {ReplacerType::LRUK, ReplacerType::LRU, ReplacerType::Clock, ReplacerType::ARC,
+                             ReplacerType::TwoQueue, ReplacerType::TinyLFU}) {
+    SCOPED_TRACE(static_cast<int>(replacer_type));
+    auto *disk_manager = new DiskManagerMemory(100);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr, replacer_type);
+
+    // Scenario: many more pages than frames are written, so every policy has to evict and write back dirty pages.
+    page_id_t page_id;
+    for (int i = 0; i < 50; ++i) {
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    }
+
+    std::mt19937 gen(15445);
+    std::uniform_int_distribution<page_id_t> dist(0, 49);
+    char expected[BUSTUB_PAGE_SIZE];
+    for (int i = 0; i < 500; ++i) {
+      page_id = dist(gen);
+      auto *page = bpm->FetchPage(page_id, i % 3 == 0 ? AccessType::Scan : AccessType::Lookup);
+      ASSERT_NE(nullptr, page);
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(0, strcmp(page->GetData(), expected));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+
+    // Scenario: pinned pages are never evicted.
+    for (page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(buffer_pool_size));
+    for (page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BufferPoolManagerInstanceTest, StatisticsTest) {
+  const size_t buffer_pool_size = 3;
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(true, bpm->UnpinPage(1, true));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+
+  // Scenario: a new page evicts page 1, which is dirty, and then every frame is pinned.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+
+  auto stats = bpm->GetStatistics();
+  EXPECT_EQ(4, stats.new_pages_);
+  EXPECT_EQ(1, stats.fetch_hits_);
+  EXPECT_EQ(1, stats.fetch_misses_);
+  EXPECT_EQ(2, stats.evictions_);
+  EXPECT_EQ(2, stats.foreground_writes_);
+  EXPECT_EQ(0, stats.background_writes_);
+  EXPECT_EQ(1, stats.no_free_frame_);
+  EXPECT_GT(stats.disk_read_ns_, 0);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+
+  // Scenario: counters updated from many threads at once add up.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 4; ++tid) {
+    threads.emplace_back([bpm]() {
+      for (int i = 0; i < 1000; ++i) {
+        bpm->FetchPage(1);
+        bpm->UnpinPage(1, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(4001, bpm->GetStatistics().fetch_hits_);
+
+  bpm->ResetStatistics();
+  stats = bpm->GetStatistics();
+  EXPECT_EQ(0, stats.fetch_hits_);
+  EXPECT_EQ(0, stats.new_pages_);
+  EXPECT_EQ(0, stats.disk_read_ns_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ResizeTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  Page *pages[8];
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    pages[i] = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, pages[i]);
+    snprintf(pages[i]->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  EXPECT_FALSE(bpm->Resize(0));
+
+  // Scenario: growing the pool while every page is pinned makes room for new pages, and old pages stay in place.
+  ASSERT_TRUE(bpm->Resize(8));
+  EXPECT_EQ(8, bpm->GetPoolSize());
+  for (size_t i = buffer_pool_size; i < 8; ++i) {
+    pages[i] = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, pages[i]);
+    snprintf(pages[i]->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, strcmp(pages[0]->GetData(), "page 0"));
+  for (page_id = 0; page_id < 8; ++page_id) {
+    if (page_id != 3) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    }
+  }
+
+  // Scenario: shrinking waits for page 3 to be unpinned, but the pool keeps serving fetches meanwhile.
+  std::atomic<bool> resized{false};
+  std::thread resizer([bpm, &resized]() {
+    EXPECT_TRUE(bpm->Resize(2));
+    resized = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(resized);
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(3, true));
+  resizer.join();
+  EXPECT_TRUE(resized);
+  EXPECT_EQ(2, bpm->GetPoolSize());
+
+  // The pages of the retired frames were written back before the frames went away.
+  char expected[BUSTUB_PAGE_SIZE];
+  for (page_id = 0; page_id < 8; ++page_id) {
+    page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: shrinking gives up if the frames stay pinned, and the pool goes on as it was.
+  auto old_timeout = bpm_resize_timeout;
+  bpm_resize_timeout = std::chrono::milliseconds(50);
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+  EXPECT_FALSE(bpm->Resize(1));
+  EXPECT_EQ(2, bpm->GetPoolSize());
+  EXPECT_EQ(nullptr, bpm->FetchPage(2));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(2));
+  ASSERT_NE(nullptr, bpm->FetchPage(3));
+  EXPECT_EQ(true, bpm->UnpinPage(2, false));
+  EXPECT_EQ(true, bpm->UnpinPage(3, false));
+  bpm_resize_timeout = old_timeout;
+
+  // Scenario: the pool is resized over and over while other threads fetch pages.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 2; ++tid) {
+    threads.emplace_back([bpm, &done, tid]() {
+      char expected[BUSTUB_PAGE_SIZE];
+      for (int i = 0; !done; ++i) {
+        page_id_t page_id = (i * 3 + tid) % 8;
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+        EXPECT_EQ(0, strcmp(page->GetData(), expected));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, i % 2 == 0));
+      }
+    });
+  }
+  for (int round = 0; round < 20; ++round) {
+    EXPECT_TRUE(bpm->Resize(round % 2 == 0 ? 16 : 3));
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(3, bpm->GetPoolSize());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, FetchPagesTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < 8; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  // Pages 4 to 7 are resident, pages 0 to 3 were evicted and written back.
+  bpm->ResetStatistics();
+
+  // Scenario: a batch mixes hits and misses, skips invalid ids and pins a page that appears twice twice.
+  std::vector<page_id_t> page_ids = {5, 0, INVALID_PAGE_ID, 1, 0};
+  auto pages = bpm->FetchPages(page_ids);
+  ASSERT_EQ(page_ids.size(), pages.size());
+  EXPECT_EQ(nullptr, pages[2]);
+  char expected[BUSTUB_PAGE_SIZE];
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    if (page_ids[i] != INVALID_PAGE_ID) {
+      ASSERT_NE(nullptr, pages[i]);
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_ids[i]);
+      EXPECT_EQ(0, strcmp(pages[i]->GetData(), expected));
+    }
+  }
+  EXPECT_EQ(pages[1], pages[4]);
+  EXPECT_EQ(2, pages[1]->GetPinCount());
+  auto stats = bpm->GetStatistics();
+  EXPECT_EQ(2, stats.fetch_hits_);
+  EXPECT_EQ(2, stats.fetch_misses_);
+
+  // Scenario: once every frame is pinned, the rest of the batch cannot be fetched.
+  pages = bpm->FetchPages({2, 3});
+  ASSERT_NE(nullptr, pages[0]);
+  EXPECT_EQ(nullptr, pages[1]);
+
+  EXPECT_TRUE(bpm->UnpinPages(page_ids, false));
+  EXPECT_TRUE(bpm->UnpinPages({2}, false));
+  EXPECT_FALSE(bpm->UnpinPages({5, 3}, false));
+  for (auto *page : bpm->FetchPages({3, 7})) {
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+  EXPECT_TRUE(bpm->UnpinPages({3, 7}, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, OptimisticReadTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < 6; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  // Pages 2 to 5 are resident, pages 0 and 1 were evicted.
+  bpm->ResetStatistics();
+
+  // Scenario: a resident page is read without pinning it.
+  std::string data;
+  auto read_data = [&data](Page *page) { data = page->GetData(); };
+  EXPECT_TRUE(bpm->OptimisticReadPage(3, read_data));
+  EXPECT_EQ("page 3", data);
+  EXPECT_EQ(1, bpm->GetStatistics().optimistic_reads_);
+  EXPECT_EQ(0, bpm->GetStatistics().fetch_hits_);
+
+  // Scenario: a page that is not resident is fetched, read and unpinned.
+  EXPECT_TRUE(bpm->OptimisticReadPage(0, read_data));
+  EXPECT_EQ("page 0", data);
+  EXPECT_EQ(1, bpm->GetStatistics().fetch_misses_);
+  EXPECT_EQ(0, bpm->GetFrame(0)->GetPinCount() + bpm->GetFrame(1)->GetPinCount() + bpm->GetFrame(2)->GetPinCount() +
+                   bpm->GetFrame(3)->GetPinCount());
+
+  // Scenario: the version is odd while the page is write latched and moves on when the latch is released.
+  auto *page = bpm->FetchPage(3);
+  ASSERT_NE(nullptr, page);
+  uint64_t version = page->GetVersion();
+  EXPECT_EQ(0, version % 2);
+  page->WLatch();
+  EXPECT_EQ(1, page->GetVersion() % 2);
+  EXPECT_FALSE(page->ValidateVersion(version));
+
+  // Scenario: a reader that keeps running into the writer ends up waiting for the read latch, and sees the write.
+  std::thread reader([&] { EXPECT_TRUE(bpm->OptimisticReadPage(3, read_data)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page 3, updated");
+  page->WUnlatch();
+  reader.join();
+  EXPECT_EQ("page 3, updated", data);
+  EXPECT_EQ(version + 2, page->GetVersion());
+  EXPECT_GE(bpm->GetStatistics().optimistic_read_conflicts_, 1);
+  EXPECT_EQ(true, bpm->UnpinPage(3, true));
+
+  // Scenario: readers never see a half-written page while writers keep rewriting it.
+  std::atomic<bool> stop = false;
+  std::thread writer([&] {
+    auto *page = bpm->FetchPage(4);
+    for (int i = 0; !stop; i++) {
+      page->WLatch();
+      memset(page->GetData(), 'a' + i % 26, BUSTUB_PAGE_SIZE);
+      page->WUnlatch();
+    }
+    bpm->UnpinPage(4, true);
+  });
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; i++) {
+    readers.emplace_back([&] {
+      for (int j = 0; j < 2000; j++) {
+        char first = 0;
+        bool torn = true;
+        EXPECT_TRUE(bpm->OptimisticReadPage(4, [&first, &torn](Page *page) {
+          first = page->GetData()[0];
+          torn = page->GetData()[BUSTUB_PAGE_SIZE - 1] != first;
+        }));
+        EXPECT_FALSE(torn);
+      }
+    });
+  }
+  for (auto &thread : readers) {
+    thread.join();
+  }
+  stop = true;
+  writer.join();
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,264 @@
+/**
+ * compressed_page_cache_test.cpp
+ */
+
+#include "buffer/compressed_page_cache.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** Fill a page the way a table page looks: a small header, free space, then fixed-size tuples packed at the end. */
+void FillTablePage(page_id_t page_id, char *data) {
+  memset(data, 0, BUSTUB_PAGE_SIZE);
+  const int tuple_size = 32;
+  const int num_tuples = 64;
+  memcpy(data, &page_id, sizeof(page_id));
+  memcpy(data + 4, &num_tuples, sizeof(num_tuples));
+  for (int i = 0; i < num_tuples; i++) {
+    char *tuple = data + BUSTUB_PAGE_SIZE - (i + 1) * tuple_size;
+    int32_t id = page_id * num_tuples + i;
+    int32_t amount = (id * 7919) % 1000;
+    memcpy(tuple, &id, sizeof(id));
+    memcpy(tuple + 4, &amount, sizeof(amount));
+    snprintf(tuple + 8, tuple_size - 8, "customer_%06d", id % 5000);
+  }
+}
+
+TEST(CompressedPageCacheTest, CodecTest) {
+  char page[BUSTUB_PAGE_SIZE];
+  char compressed[MAX_COMPRESSED_PAGE_SIZE];
+  char decompressed[BUSTUB_PAGE_SIZE];
+
+  // Scenario: an empty page shrinks to almost nothing.
+  memset(page, 0, BUSTUB_PAGE_SIZE);
+  size_t size = CompressPage(page, compressed);
+  EXPECT_LT(size, 64);
+  ASSERT_TRUE(DecompressPage(compressed, size, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: a table page compresses well.
+  FillTablePage(42, page);
+  size = CompressPage(page, compressed);
+  EXPECT_LT(size, BUSTUB_PAGE_SIZE / 2);
+  ASSERT_TRUE(DecompressPage(compressed, size, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: random bytes do not compress, but still round-trip within the bound.
+  std::mt19937 gen(15445);
+  for (char &c : page) {
+    c = static_cast<char>(gen());
+  }
+  size = CompressPage(page, compressed);
+  EXPECT_GE(size, BUSTUB_PAGE_SIZE);
+  EXPECT_LE(size, MAX_COMPRESSED_PAGE_SIZE);
+  ASSERT_TRUE(DecompressPage(compressed, size, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, BUSTUB_PAGE_SIZE));
+
+  // Scenario: truncated or corrupt input is rejected.
+  FillTablePage(7, page);
+  size = CompressPage(page, compressed);
+  EXPECT_FALSE(DecompressPage(compressed, size / 2, decompressed));
+  const char more_literals_than_input[] = {static_cast<char>(0xf0)};
+  EXPECT_FALSE(DecompressPage(more_literals_than_input, 1, decompressed));
+  const char match_before_start[] = {0x10, 'a', 0x08, 0x00};
+  EXPECT_FALSE(DecompressPage(match_before_start, 4, decompressed));
+}
+
+TEST(CompressedPageCacheTest, CacheTest) {
+  char page[BUSTUB_PAGE_SIZE];
+  char compressed[MAX_COMPRESSED_PAGE_SIZE];
+  FillTablePage(0, page);
+  size_t page_size = CompressPage(page, compressed);
+
+  // Room for three compressed pages.
+  CompressedPageCache cache(3 * page_size + page_size / 2);
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    FillTablePage(page_id, page);
+    cache.Insert(page_id, page);
+  }
+  // Scenario: page 0 was dropped to make room for page 3.
+  EXPECT_EQ(3, cache.Size());
+  char data[BUSTUB_PAGE_SIZE];
+  EXPECT_FALSE(cache.Lookup(0, data));
+
+  // Scenario: pages are dropped in least recently used order, and a lookup or a touch counts as a use.
+  ASSERT_TRUE(cache.Lookup(1, data));
+  FillTablePage(1, page);
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+  EXPECT_TRUE(cache.Touch(2));
+  EXPECT_FALSE(cache.Touch(0));
+  FillTablePage(4, page);
+  cache.Insert(4, page);
+  EXPECT_EQ(3, cache.Size());
+  EXPECT_FALSE(cache.Lookup(3, data));
+  EXPECT_TRUE(cache.Lookup(1, data));
+
+  cache.Erase(1);
+  cache.Erase(2);
+  EXPECT_EQ(1, cache.Size());
+  EXPECT_LT(cache.GetUsedBytes(), 2 * page_size);
+
+  // Scenario: a page that does not compress is kept as it is, unless it does not fit the budget at all.
+  std::mt19937 gen(15445);
+  for (char &c : page) {
+    c = static_cast<char>(gen());
+  }
+  CompressedPageCache large_cache(BUSTUB_PAGE_SIZE);
+  large_cache.Insert(3, page);
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, large_cache.GetUsedBytes());
+  ASSERT_TRUE(large_cache.Lookup(3, data));
+  EXPECT_EQ(0, memcmp(page, data, BUSTUB_PAGE_SIZE));
+  CompressedPageCache small_cache(BUSTUB_PAGE_SIZE - 1);
+  small_cache.Insert(3, page);
+  EXPECT_EQ(0, small_cache.Size());
+}
+
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  auto old_cache_bytes = bpm_victim_cache_bytes;
+  bpm_victim_cache_bytes = 16 * BUSTUB_PAGE_SIZE;
+  const size_t buffer_pool_size = 2;
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < 6; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillTablePage(page_id, page->GetData());
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: evicted pages are read back from the victim cache, and the disk holds the same contents.
+  char expected[BUSTUB_PAGE_SIZE];
+  char on_disk[BUSTUB_PAGE_SIZE];
+  for (page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    FillTablePage(page_id, expected);
+    EXPECT_EQ(0, memcmp(expected, page->GetData(), BUSTUB_PAGE_SIZE));
+    disk_manager->ReadPage(page_id, on_disk);
+    EXPECT_EQ(0, memcmp(expected, on_disk, BUSTUB_PAGE_SIZE));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  auto stats = bpm->GetStatistics();
+  EXPECT_EQ(4, stats.victim_cache_hits_);
+  EXPECT_EQ(0, stats.victim_cache_misses_);
+
+  // Scenario: a page that is dirtied and written back again is not served from its old copy.
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "changed");
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_EQ(true, bpm->FlushPage(0));
+  for (page_id = 1; page_id < 4; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_STREQ("changed", page->GetData());
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: a deleted page is not served from the cache later.
+  EXPECT_EQ(true, bpm->DeletePage(4));
+  memset(on_disk, 0, BUSTUB_PAGE_SIZE);
+  disk_manager->WritePage(4, on_disk);
+  bpm->ResetStatistics();
+  page = bpm->FetchPage(4);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, memcmp(on_disk, page->GetData(), BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(true, bpm->UnpinPage(4, false));
+  EXPECT_EQ(1, bpm->GetStatistics().victim_cache_misses_);
+
+  // Scenario: neither is a page deleted while it is in the pool, after it was read back from the cache.
+  page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  disk_manager->WritePage(1, on_disk);
+  bpm->ResetStatistics();
+  page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, memcmp(on_disk, page->GetData(), BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+  EXPECT_EQ(1, bpm->GetStatistics().victim_cache_misses_);
+
+  delete bpm;
+  delete disk_manager;
+  bpm_victim_cache_bytes = old_cache_bytes;
+}
+
+/** Fetch random pages of a working set and return the throughput in fetches per millisecond. */
+auto VictimCacheBenchmarkCall(DiskManager *disk_manager, size_t pool_size, size_t working_set, size_t cache_bytes,
+                              BufferPoolStats *stats) -> double {
+  const size_t num_fetches = 100000;
+  auto old_cache_bytes = bpm_victim_cache_bytes;
+  bpm_victim_cache_bytes = cache_bytes;
+  auto *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  bpm_victim_cache_bytes = old_cache_bytes;
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(working_set) - 1);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_fetches; i++) {
+    page_id_t page_id = dist(gen);
+    if (bpm->FetchPage(page_id) != nullptr) {
+      bpm->UnpinPage(page_id, false);
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  *stats = bpm->GetStatistics();
+  delete bpm;
+  return static_cast<double>(num_fetches) * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+TEST(CompressedPageCacheTest, DISABLED_VictimCacheBenchmark) {  // NOLINT
+  const size_t pool_size = 256;
+  // Enough for every page of the largest working set, since table pages compress to less than a third.
+  const size_t cache_bytes = 4 * pool_size * BUSTUB_PAGE_SIZE / 3;
+  std::string db_file("victim_cache_bench.db");
+  remove(db_file.c_str());
+  auto *disk_manager = new DiskManager(db_file);
+  char data[BUSTUB_PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(4 * pool_size); page_id++) {
+    FillTablePage(page_id, data);
+    disk_manager->WritePage(page_id, data);
+  }
+
+  std::cout << "This test compares random FetchPage throughput with and without the compressed victim cache, "
+            << "for working sets of 1 to 4 times the buffer pool (" << pool_size << " frames)." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t factor = 1; factor <= 4; factor++) {
+    size_t working_set = factor * pool_size;
+    BufferPoolStats disk_stats;
+    BufferPoolStats cache_stats;
+    double disk_only = VictimCacheBenchmarkCall(disk_manager, pool_size, working_set, 0, &disk_stats);
+    double with_cache = VictimCacheBenchmarkCall(disk_manager, pool_size, working_set, cache_bytes, &cache_stats);
+    std::cout << "working_set=" << factor << "x disk_only=" << disk_only << " fetches/ms"
+              << " with_cache=" << with_cache << " fetches/ms"
+              << " disk_read_ms=" << static_cast<double>(disk_stats.disk_read_ns_) / 1e6 << "/"
+              << static_cast<double>(cache_stats.disk_read_ns_) / 1e6
+              << " victim_hits=" << cache_stats.victim_cache_hits_
+              << " victim_misses=" << cache_stats.victim_cache_misses_ << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove(db_file.c_str());
+  remove("victim_cache_bench.log");
+}
+
+}  // namespace bustub
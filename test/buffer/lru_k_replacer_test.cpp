@@ -5,7 +5,9 @@
 #include "buffer/lru_k_replacer.h"
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
 #include <memory>
 #include <random>
 #include <set>
@@ -16,7 +18,7 @@
 
 namespace bustub {
 
-TEST(LRUKReplacerTest, DISABLED_SampleTest) {
+TEST(LRUKReplacerTest, SampleTest) {
   LRUKReplacer lru_replacer(7, 2);
 
   // Scenario: add six elements to the replacer. We have [1,2,3,4,5]. Frame 6 is non-evictable.
@@ -97,4 +99,77 @@ TEST(LRUKReplacerTest, DISABLED_SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, ScanAccessTest) {
+  LRUKReplacer lru_replacer(7, 2);
+  frame_id_t value;
+
+  // Scenario: frames 1 and 2 are looked up, frames 3 and 4 are only touched by a scan.
+  lru_replacer.RecordAccess(1, AccessType::Lookup);
+  lru_replacer.RecordAccess(2, AccessType::Lookup);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+  for (frame_id_t frame_id = 1; frame_id <= 4; ++frame_id) {
+    lru_replacer.SetEvictable(frame_id, true);
+  }
+  ASSERT_EQ(4, lru_replacer.Size());
+
+  // Scenario: scanning frame 1 again must not make it look hot, and a lookup promotes frame 4 out of the scan set.
+  lru_replacer.RecordAccess(1, AccessType::Scan);
+  lru_replacer.RecordAccess(4, AccessType::Lookup);
+
+  // Scan-only frames go first, then frames with +inf backward k-distance in LRU order.
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(4, value);
+  ASSERT_EQ(0, lru_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, DISABLED_EvictionBenchmark) {  // NOLINT
+  const size_t num_frames = 1000000;
+  const size_t k = 2;
+  const size_t num_ops = 1000000;
+  std::cout << "This test measures miss-heavy LRU-K replacer throughput with " << num_frames << " frames." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+
+  LRUKReplacer lru_replacer(num_frames, k);
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<frame_id_t> dist(0, num_frames - 1);
+  auto start_time = std::chrono::system_clock::now();
+  for (size_t i = 0; i < num_frames; i++) {
+    lru_replacer.RecordAccess(i);
+    lru_replacer.SetEvictable(i, true);
+  }
+  // Give a random half of the frames a full history.
+  for (size_t i = 0; i < num_frames / 2; i++) {
+    lru_replacer.RecordAccess(dist(gen));
+  }
+  auto fill_time = std::chrono::system_clock::now();
+
+  // Every miss evicts a victim and installs a new page in it; every hit refreshes a random frame.
+  frame_id_t frame_id;
+  for (size_t i = 0; i < num_ops; i++) {
+    if (i % 2 == 0) {
+      ASSERT_TRUE(lru_replacer.Evict(&frame_id));
+      lru_replacer.RecordAccess(frame_id);
+      lru_replacer.SetEvictable(frame_id, true);
+    } else {
+      lru_replacer.RecordAccess(dist(gen));
+    }
+  }
+  auto end_time = std::chrono::system_clock::now();
+  ASSERT_EQ(num_frames, lru_replacer.Size());
+
+  auto fill_ms = std::chrono::duration_cast<std::chrono::milliseconds>(fill_time - start_time).count();
+  auto ops_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - fill_time).count();
+  std::cout << "fill=" << fill_ms << "ms ops=" << num_ops << " time=" << ops_ms
+            << "ms throughput=" << num_ops / std::max<int64_t>(ops_ms, 1) << " ops/ms" << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
 }  // namespace bustub
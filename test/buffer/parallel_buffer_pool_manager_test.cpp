@@ -0,0 +1,303 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: New pages are handed out round-robin, so the first pages land in consecutive instances.
+  for (size_t i = 1; i < num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(static_cast<page_id_t>(i), page_id_temp);
+  }
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool.
+  for (size_t i = num_instances; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning pages {0, 1, 2, 3, 4}, every instance has one evictable frame, so we can make exactly
+  // five more pages and then nothing is left for page 0.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+
+  // Scenario: Unpinning one page of instance 0 lets us read page 0 back from disk.
+  EXPECT_EQ(true, bpm->UnpinPage(5, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(false, bpm->UnpinPage(0, false));
+
+  // Scenario: Pages are deleted through the instance that owns them.
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  EXPECT_EQ(false, bpm->DeletePage(6));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrentTest) {
+  const size_t num_threads = 4;
+  const size_t pages_per_thread = 200;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(4, 8, disk_manager);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      std::vector<page_id_t> page_ids;
+      for (size_t i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        auto *page = bpm->NewPage(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+        ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+        page_ids.push_back(page_id);
+      }
+      for (auto page_id : page_ids) {
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), page->GetData());
+        ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, StatisticsTest) {
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new ParallelBufferPoolManager(4, 2, disk_manager);
+
+  // Scenario: pages are created round-robin, so every instance counts its own share.
+  page_id_t page_id;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  for (page_id = 0; page_id < 4; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  for (size_t i = 0; i < bpm->GetNumInstances(); ++i) {
+    EXPECT_EQ(2, bpm->GetInstanceStatistics(i).new_pages_);
+    EXPECT_EQ(1, bpm->GetInstanceStatistics(i).fetch_hits_);
+  }
+  auto stats = bpm->GetStatistics();
+  EXPECT_EQ(8, stats.new_pages_);
+  EXPECT_EQ(4, stats.fetch_hits_);
+  EXPECT_EQ(0, stats.fetch_misses_);
+
+  bpm->ResetStatistics();
+  EXPECT_EQ(0, bpm->GetStatistics().new_pages_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new ParallelBufferPoolManager(4, 2, disk_manager);
+
+  // Scenario: frames are split as evenly as possible among the instances.
+  EXPECT_FALSE(bpm->Resize(3));
+  ASSERT_TRUE(bpm->Resize(10));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+  EXPECT_EQ(3, bpm->GetInstancePoolSize(0));
+  EXPECT_EQ(3, bpm->GetInstancePoolSize(1));
+  EXPECT_EQ(2, bpm->GetInstancePoolSize(2));
+  EXPECT_EQ(2, bpm->GetInstancePoolSize(3));
+
+  page_id_t page_id;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  for (page_id = 0; page_id < 10; ++page_id) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: if an instance cannot shrink because its pages stay pinned, the others are grown back.
+  auto old_timeout = bpm_resize_timeout;
+  bpm_resize_timeout = std::chrono::milliseconds(50);
+  ASSERT_NE(nullptr, bpm->FetchPage(2));
+  ASSERT_NE(nullptr, bpm->FetchPage(6));
+  EXPECT_FALSE(bpm->Resize(4));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+  EXPECT_EQ(3, bpm->GetInstancePoolSize(0));
+  EXPECT_EQ(2, bpm->GetInstancePoolSize(2));
+  EXPECT_EQ(true, bpm->UnpinPage(2, false));
+  EXPECT_EQ(true, bpm->UnpinPage(6, false));
+  bpm_resize_timeout = old_timeout;
+
+  // Scenario: after shrinking to one frame per instance, only one page per instance can be pinned.
+  ASSERT_TRUE(bpm->Resize(4));
+  EXPECT_EQ(4, bpm->GetPoolSize());
+  for (page_id = 0; page_id < 4; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(4));
+  for (page_id = 0; page_id < 4; ++page_id) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, FetchPagesTest) {
+  auto *disk_manager = new DiskManagerMemory(100);
+  auto *bpm = new ParallelBufferPoolManager(3, 2, disk_manager);
+
+  page_id_t page_id;
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 12; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: a batch spread over every instance comes back in the order it was asked for.
+  std::vector<page_id_t> batch = {page_ids[7], page_ids[0], page_ids[2], page_ids[10], page_ids[5]};
+  auto pages = bpm->FetchPages(batch);
+  ASSERT_EQ(batch.size(), pages.size());
+  char expected[BUSTUB_PAGE_SIZE];
+  for (size_t i = 0; i < batch.size(); ++i) {
+    ASSERT_NE(nullptr, pages[i]);
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", batch[i]);
+    EXPECT_EQ(0, strcmp(pages[i]->GetData(), expected));
+  }
+  EXPECT_TRUE(bpm->UnpinPages(batch, false));
+  EXPECT_FALSE(bpm->UnpinPages(batch, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+auto ParallelBufferPoolManagerBenchmarkCall(size_t num_threads, size_t num_instances, size_t total_frames)
+    -> size_t {
+  const size_t num_pages = total_frames * 2;
+  const size_t ops_per_thread = 100000;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, total_frames / num_instances, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    if (bpm->NewPage(&page_id) == nullptr) {
+      break;
+    }
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+
+  auto clock_start = std::chrono::system_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid, &page_ids] {
+      std::default_random_engine rng(tid);
+      // Skewed accesses: most of them hit a hot set that fits in memory.
+      std::uniform_int_distribution<size_t> hot_dist(0, page_ids.size() / 4 - 1);
+      std::uniform_int_distribution<size_t> all_dist(0, page_ids.size() - 1);
+      for (size_t i = 0; i < ops_per_thread; i++) {
+        auto page_id = page_ids[(i % 10 == 0) ? all_dist(rng) : hot_dist(rng)];
+        auto *page = bpm->FetchPage(page_id);
+        if (page != nullptr) {
+          bpm->UnpinPage(page_id, i % 5 == 0);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto clock_end = std::chrono::system_clock::now();
+
+  delete bpm;
+  delete disk_manager;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+}
+
+TEST(ParallelBufferPoolManagerTest, DISABLED_ScalingBenchmark) {  // NOLINT
+  const size_t num_threads = 8;
+  const size_t total_frames = 1024;
+  std::cout << "This test measures FetchPage/UnpinPage throughput with " << num_threads
+            << " threads as the buffer pool is split into more instances." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_instances : {1, 2, 4, 8, 16}) {
+    auto dur = ParallelBufferPoolManagerBenchmarkCall(num_threads, num_instances, total_frames);
+    double ops = num_threads * 100000.0;
+    std::cout << "instances=" << num_instances << " time=" << dur << "ms throughput=" << ops / std::max<size_t>(dur, 1)
+              << " ops/ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -0,0 +1,255 @@
+/**
+ * replacer_test.cpp
+ */
+
+#include "buffer/replacer.h"
+
+#include <memory>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/tiny_lfu_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+const std::vector<ReplacerType> ALL_REPLACER_TYPES = {ReplacerType::LRUK, ReplacerType::LRU,      ReplacerType::Clock,
+                                                      ReplacerType::ARC,  ReplacerType::TwoQueue, ReplacerType::TinyLFU};
+
+TEST(ReplacerTest, InterfaceTest) {
+  for (auto replacer_type : ALL_REPLACER_TYPES) {
+    SCOPED_TRACE(static_cast<int>(replacer_type));
+    auto replacer = MakeReplacer(replacer_type, 8, 2);
+
+    // Scenario: frames 0 to 4 are unpinned, frame 5 is pinned and frames 6 and 7 have never been used.
+    for (frame_id_t frame_id = 0; frame_id < 6; frame_id++) {
+      replacer->RecordAccess(frame_id, frame_id, AccessType::Unknown);
+      replacer->SetEvictable(frame_id, frame_id != 5);
+    }
+    replacer->SetEvictable(6, true);
+    EXPECT_EQ(5, replacer->Size());
+    EXPECT_TRUE(replacer->IsEvictable(4));
+    EXPECT_FALSE(replacer->IsEvictable(5));
+    EXPECT_FALSE(replacer->IsEvictable(6));
+
+    // Scenario: removing a frame that is not tracked does nothing, removing an unpinned one shrinks the replacer.
+    replacer->Remove(7);
+    replacer->Remove(4);
+    EXPECT_EQ(4, replacer->Size());
+    EXPECT_EQ(4, replacer->GetEvictionCandidates(10).size());
+
+    // Scenario: every unpinned frame is evicted exactly once, and the pinned frame never is.
+    std::set<frame_id_t> evicted;
+    frame_id_t frame_id;
+    for (int i = 0; i < 4; i++) {
+      ASSERT_TRUE(replacer->Evict(&frame_id));
+      EXPECT_TRUE(evicted.insert(frame_id).second);
+    }
+    EXPECT_EQ((std::set<frame_id_t>{0, 1, 2, 3}), evicted);
+    EXPECT_FALSE(replacer->Evict(&frame_id));
+    EXPECT_EQ(0, replacer->Size());
+
+    // Scenario: the legacy interface. Unpinning an untracked frame adds it, unpinning it twice does not count twice.
+    replacer->Unpin(5);
+    replacer->Unpin(0);
+    replacer->Unpin(0);
+    EXPECT_EQ(2, replacer->Size());
+    replacer->Pin(0);
+    EXPECT_EQ(1, replacer->Size());
+    ASSERT_TRUE(replacer->Victim(&frame_id));
+    EXPECT_EQ(5, frame_id);
+    EXPECT_FALSE(replacer->Victim(&frame_id));
+  }
+}
+
+TEST(ARCReplacerTest, GhostHitTest) {
+  ARCReplacer replacer(4);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    replacer.RecordAccess(frame_id, frame_id, AccessType::Unknown);
+    replacer.SetEvictable(frame_id, true);
+  }
+  EXPECT_EQ(0, replacer.GetRecentTarget());
+
+  // Scenario: page 3 is accessed again, so it is frequent. Page 0 is the least recently used page of T1.
+  replacer.RecordAccess(3, 3, AccessType::Unknown);
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 0 comes back while it is in B1, so T1 was too small. It goes straight into T2.
+  replacer.RecordAccess(0, 0, AccessType::Unknown);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(1, replacer.GetRecentTarget());
+
+  // T1 holds pages 1 and 2, which is more than its target, so it gives up its pages before T2 does.
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(3, frame_id);
+
+  // Scenario: page 3 comes back while it is in B2, so T2 was too small.
+  replacer.RecordAccess(3, 3, AccessType::Unknown);
+  EXPECT_EQ(0, replacer.GetRecentTarget());
+
+  // Scenario: a page that has only been scanned is not remembered, so it does not move the target when it returns.
+  replacer.RecordAccess(1, 10, AccessType::Scan);
+  replacer.SetEvictable(1, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  replacer.RecordAccess(1, 10, AccessType::Unknown);
+  EXPECT_EQ(0, replacer.GetRecentTarget());
+}
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // A1in holds up to 2 frames, A1out remembers up to 4 pages.
+  TwoQueueReplacer replacer(8);
+  for (frame_id_t frame_id = 0; frame_id < 8; frame_id++) {
+    replacer.RecordAccess(frame_id, frame_id, AccessType::Unknown);
+    replacer.SetEvictable(frame_id, true);
+  }
+
+  // Scenario: repeated accesses to a page in A1in are correlated and do not protect it.
+  replacer.RecordAccess(0, 0, AccessType::Unknown);
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 0 comes back while it is in A1out, so it goes into Am.
+  replacer.RecordAccess(0, 0, AccessType::Unknown);
+  replacer.SetEvictable(0, true);
+
+  // A1in gives up its oldest pages until it is down to its target size, then Am gives up page 0.
+  for (frame_id_t expected = 1; expected < 6; expected++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    EXPECT_EQ(expected, frame_id);
+  }
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: A1out only remembers the last four pages evicted from A1in, so page 1 goes into A1in and page 5 into
+  // Am. Once A1in is back to its target size, page 5 is evicted before it.
+  replacer.RecordAccess(1, 1, AccessType::Unknown);
+  replacer.RecordAccess(5, 5, AccessType::Unknown);
+  replacer.SetEvictable(1, true);
+  replacer.SetEvictable(5, true);
+  for (frame_id_t expected : {6, 5, 7, 1}) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    EXPECT_EQ(expected, frame_id);
+  }
+}
+
+TEST(TinyLFUReplacerTest, AdmissionTest) {
+  const size_t num_frames = 100;
+  TinyLFUReplacer replacer(num_frames);
+  for (size_t i = 0; i < num_frames; i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    replacer.RecordAccess(frame_id, frame_id, AccessType::Unknown);
+    replacer.SetEvictable(frame_id, true);
+  }
+  // Scenario: the first half of the pages is hot.
+  for (int round = 0; round < 3; round++) {
+    for (frame_id_t frame_id = 0; frame_id < 50; frame_id++) {
+      replacer.RecordAccess(frame_id, frame_id, AccessType::Unknown);
+    }
+  }
+
+  // Scenario: a large scan is pushed through the pool. Its pages are hardly ever more popular than the resident
+  // pages, so they mostly evict each other, and the hot pages in the protected segment are never touched.
+  page_id_t next_page_id = num_frames;
+  frame_id_t frame_id;
+  for (int i = 0; i < 500; i++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    EXPECT_GE(frame_id, 50);
+    replacer.RecordAccess(frame_id, next_page_id++, AccessType::Scan);
+    replacer.SetEvictable(frame_id, true);
+  }
+
+  // Scenario: a new page that is accessed often enough wins its duel and joins the main area.
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  for (int i = 0; i < 5; i++) {
+    replacer.RecordAccess(frame_id, next_page_id, AccessType::Unknown);
+  }
+  replacer.SetEvictable(frame_id, true);
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_NE(frame_id, victim);
+}
+
+TEST(FrequencySketchTest, AgingTest) {
+  FrequencySketch sketch(16);
+  for (int i = 0; i < 10; i++) {
+    sketch.Increment(1);
+  }
+  sketch.Increment(2);
+  EXPECT_EQ(10, sketch.Estimate(1));
+  EXPECT_EQ(1, sketch.Estimate(2));
+  EXPECT_EQ(0, sketch.Estimate(3));
+
+  // Scenario: counters saturate, and once ten times the width of the sketch has been recorded, they are halved.
+  for (int i = 0; i < 149; i++) {
+    sketch.Increment(2);
+  }
+  EXPECT_EQ(5, sketch.Estimate(1));
+  EXPECT_EQ(7, sketch.Estimate(2));
+}
+
+/** Replay a trace against a pool of num_frames frames that unpins every page right after its access. */
+auto ReplayTrace(Replacer *replacer, size_t num_frames, const std::vector<std::pair<page_id_t, AccessType>> &trace)
+    -> size_t {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(num_frames, INVALID_PAGE_ID);
+  size_t hits = 0;
+  size_t num_used = 0;
+  for (const auto &[page_id, access_type] : trace) {
+    frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      frame_id = it->second;
+    } else if (num_used < num_frames) {
+      frame_id = static_cast<frame_id_t>(num_used++);
+    } else {
+      EXPECT_TRUE(replacer->Evict(&frame_id));
+      page_table.erase(frame_pages[frame_id]);
+    }
+    page_table[page_id] = frame_id;
+    frame_pages[frame_id] = page_id;
+    replacer->RecordAccess(frame_id, page_id, access_type);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return hits;
+}
+
+TEST(ReplacerTest, MixedWorkloadTest) {
+  // Scenario: point lookups on a hot set that fits in the pool, interrupted by scans over a large table.
+  const size_t num_frames = 64;
+  std::vector<std::pair<page_id_t, AccessType>> trace;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> hot(0, 47);
+  page_id_t next_scan_page = 1000;
+  for (int round = 0; round < 20; round++) {
+    for (int i = 0; i < 500; i++) {
+      trace.emplace_back(hot(gen), AccessType::Lookup);
+    }
+    for (int i = 0; i < 200; i++) {
+      trace.emplace_back(next_scan_page++, AccessType::Scan);
+    }
+  }
+
+  auto lru = MakeReplacer(ReplacerType::LRU, num_frames, LRUK_REPLACER_K);
+  size_t lru_hits = ReplayTrace(lru.get(), num_frames, trace);
+  for (auto replacer_type : {ReplacerType::LRUK, ReplacerType::ARC, ReplacerType::TwoQueue, ReplacerType::TinyLFU}) {
+    SCOPED_TRACE(static_cast<int>(replacer_type));
+    auto replacer = MakeReplacer(replacer_type, num_frames, LRUK_REPLACER_K);
+    EXPECT_GT(ReplayTrace(replacer.get(), num_frames, trace), lru_hits);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,208 @@
+/**
+ * concurrent_page_table_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/concurrent_page_table.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(ConcurrentPageTableTest, SampleTest) {
+  auto table = std::make_unique<ConcurrentPageTable>(16);
+
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    table->Insert(page_id, page_id * 2);
+  }
+  EXPECT_EQ(16, table->Size());
+
+  frame_id_t frame_id;
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    ASSERT_TRUE(table->Find(page_id, frame_id));
+    EXPECT_EQ(page_id * 2, frame_id);
+  }
+  EXPECT_FALSE(table->Find(16, frame_id));
+
+  // Scenario: inserting an existing page replaces its frame.
+  table->Insert(3, 100);
+  EXPECT_TRUE(table->Find(3, frame_id));
+  EXPECT_EQ(100, frame_id);
+  EXPECT_EQ(16, table->Size());
+
+  // Scenario: removing pages must not hide the pages that were placed after them in a probe chain.
+  for (page_id_t page_id = 0; page_id < 16; page_id += 2) {
+    EXPECT_TRUE(table->Remove(page_id));
+  }
+  EXPECT_FALSE(table->Remove(0));
+  EXPECT_EQ(8, table->Size());
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    EXPECT_EQ(page_id % 2 == 1, table->Find(page_id, frame_id));
+  }
+}
+
+TEST(ConcurrentPageTableTest, GrowTest) {
+  // Scenario: the table holds many more entries than it was sized for.
+  auto table = std::make_unique<ConcurrentPageTable>(4);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> dist(0, 4000);
+  for (int i = 0; i < 10000; i++) {
+    page_id_t page_id = dist(gen);
+    if (i % 3 == 0) {
+      EXPECT_EQ(expected.erase(page_id) == 1, table->Remove(page_id));
+    } else {
+      table->Insert(page_id, i);
+      expected[page_id] = i;
+    }
+  }
+  EXPECT_EQ(expected.size(), table->Size());
+  frame_id_t frame_id;
+  for (page_id_t page_id = 0; page_id <= 4000; page_id++) {
+    auto it = expected.find(page_id);
+    ASSERT_EQ(it != expected.end(), table->Find(page_id, frame_id));
+    if (it != expected.end()) {
+      EXPECT_EQ(it->second, frame_id);
+    }
+  }
+}
+
+TEST(ConcurrentPageTableTest, ConcurrentTest) {
+  const int num_writers = 4;
+  const int num_readers = 4;
+  const int pages_per_writer = 1000;
+  auto table = std::make_unique<ConcurrentPageTable>(num_writers * pages_per_writer);
+
+  // Pages below the stable range are never removed, so readers must always find them.
+  const page_id_t num_stable = 500;
+  for (page_id_t page_id = 0; page_id < num_stable; page_id++) {
+    table->Insert(page_id, page_id);
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> missing{0};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_readers; tid++) {
+    threads.emplace_back([&]() {
+      frame_id_t frame_id;
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < num_stable; page_id++) {
+          if (!table->Find(page_id, frame_id) || frame_id != page_id) {
+            missing++;
+          }
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int tid = 0; tid < num_writers; tid++) {
+    writers.emplace_back([&, tid]() {
+      page_id_t begin = num_stable + tid * pages_per_writer;
+      for (int round = 0; round < 5; round++) {
+        for (page_id_t page_id = begin; page_id < begin + pages_per_writer; page_id++) {
+          table->Insert(page_id, page_id);
+        }
+        for (page_id_t page_id = begin; page_id < begin + pages_per_writer; page_id++) {
+          EXPECT_TRUE(table->Remove(page_id));
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, missing);
+  EXPECT_EQ(num_stable, table->Size());
+}
+
+template <typename PageTable>
+auto PageTableBenchmarkCall(PageTable *table, size_t num_threads, page_id_t num_pages) -> size_t {
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    table->Insert(page_id, page_id);
+  }
+  auto start_time = std::chrono::system_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([table, tid, num_pages]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      frame_id_t frame_id;
+      for (int i = 0; i < 200000; i++) {
+        table->Find(dist(gen), frame_id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end_time = std::chrono::system_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+}
+
+auto FetchLatencyBenchmarkCall(size_t num_threads, size_t pool_size) -> double {
+  auto disk_manager = std::make_unique<DiskManagerMemory>(pool_size);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  page_id_t page_id;
+  for (size_t i = 0; i < pool_size; i++) {
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, false);
+  }
+
+  const int fetches_per_thread = 50000;
+  std::atomic<int64_t> total_ns{0};
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm, &total_ns, tid, pool_size]() {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> dist(0, pool_size - 1);
+      auto start_time = std::chrono::steady_clock::now();
+      for (int i = 0; i < fetches_per_thread; i++) {
+        page_id_t page_id = dist(gen);
+        bpm->FetchPage(page_id);
+        bpm->UnpinPage(page_id, false);
+      }
+      auto end_time = std::chrono::steady_clock::now();
+      total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(total_ns) / (num_threads * fetches_per_thread);
+}
+
+TEST(ConcurrentPageTableTest, DISABLED_ContentionBenchmark) {  // NOLINT
+  const page_id_t num_pages = 4096;
+  std::cout << "This test compares page table lookups of ExtendibleHashTable and ConcurrentPageTable, and measures the "
+               "latency of FetchPage hits as more threads share one buffer pool."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    ExtendibleHashTable<page_id_t, frame_id_t> extendible(4);
+    ConcurrentPageTable concurrent(num_pages);
+    auto extendible_ms = PageTableBenchmarkCall(&extendible, num_threads, num_pages);
+    auto concurrent_ms = PageTableBenchmarkCall(&concurrent, num_threads, num_pages);
+    double fetch_ns = FetchLatencyBenchmarkCall(num_threads, num_pages);
+    std::cout << "threads=" << num_threads << " extendible_find=" << extendible_ms
+              << "ms concurrent_find=" << concurrent_ms << "ms fetch_latency=" << fetch_ns << "ns" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -10,11 +10,31 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <array>
+#include <chrono>  // NOLINT
+#include <cstdio>
 #include <cstring>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_tablespace.h"
+#include "storage/disk/disk_manager_uring.h"
 
 namespace bustub {
 
@@ -55,6 +75,666 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReadPagesTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  for (page_id_t page_id = 0; page_id < 6; page_id++) {
+    snprintf(data, sizeof(data), "page %d", page_id);
+    dm.WritePage(page_id, data);
+  }
+
+  // Out of order, with a gap, a duplicate and a page past the end of the file.
+  std::vector<page_id_t> page_ids = {4, 1, 2, 5, 1, 9};
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(page_ids.size());
+  std::vector<std::pair<page_id_t, char *>> reads;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    bufs[i].fill(1);
+    reads.emplace_back(page_ids[i], bufs[i].data());
+  }
+  dm.ReadPages(reads);
+  for (size_t i = 0; i + 1 < page_ids.size(); i++) {
+    snprintf(data, sizeof(data), "page %d", page_ids[i]);
+    EXPECT_EQ(std::memcmp(bufs[i].data(), data, sizeof(data)), 0);
+  }
+  EXPECT_EQ(0, bufs.back()[0]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  {
+    DiskManagerPosix dm("test.db");
+    std::strncpy(data, "A test string.", sizeof(data));
+    std::memset(buf, 1, sizeof(buf));
+    dm.ReadPage(0, buf);  // an empty file reads as zeros
+    EXPECT_EQ(0, buf[0]);
+
+    dm.WritePage(0, data);
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    dm.WritePage(5, data);
+    EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+    EXPECT_EQ(2, dm.GetNumWrites());
+
+    // Scenario: a batch mixes pages that exist, a hole in the file, a duplicate and a page past the end.
+    std::vector<page_id_t> page_ids = {5, 3, 0, 5, 7};
+    std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(page_ids.size());
+    std::vector<std::pair<page_id_t, char *>> reads;
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      bufs[i].fill(1);
+      reads.emplace_back(page_ids[i], bufs[i].data());
+    }
+    dm.ReadPages(reads);
+    EXPECT_EQ(std::memcmp(bufs[0].data(), data, sizeof(data)), 0);
+    EXPECT_EQ(0, bufs[1][0]);
+    EXPECT_EQ(std::memcmp(bufs[2].data(), data, sizeof(data)), 0);
+    EXPECT_EQ(std::memcmp(bufs[3].data(), data, sizeof(data)), 0);
+    EXPECT_EQ(0, bufs[4][0]);
+    dm.ShutDown();
+  }
+
+  // Scenario: the pages can be read back by the stream based disk manager, and the file size is picked up on open.
+  auto dm = DiskManager("test.db");
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ShutDown();
+  DiskManagerPosix posix_dm("test.db");
+  EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, posix_dm.GetDbFileSize());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixConcurrentIoTest) {
+  DiskManagerPosix dm("test.db");
+  const int num_threads = 4;
+  const int pages_per_thread = 64;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, t] {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < pages_per_thread; i++) {
+        auto page_id = static_cast<page_id_t>(i * num_threads + t);
+        std::memset(data, 'a' + page_id % 26, sizeof(data));
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixFsyncPolicyTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  {
+    DiskManagerPosix dm("test.db", FsyncPolicy::Never);
+    dm.WritePage(0, data);
+    dm.ShutDown();
+    EXPECT_EQ(0, dm.GetNumSyncs());
+  }
+  {
+    DiskManagerPosix dm("test.db", FsyncPolicy::EveryWrite);
+    dm.WritePage(0, data);
+    dm.WritePage(1, data);
+    EXPECT_EQ(2, dm.GetNumSyncs());
+  }
+  {
+    DiskManagerPosix dm("test.db", FsyncPolicy::Periodic, 4);
+    for (page_id_t page_id = 0; page_id < 10; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+    EXPECT_EQ(2, dm.GetNumSyncs());
+    // The writes since the last sync are synced on shutdown.
+    dm.ShutDown();
+    EXPECT_EQ(3, dm.GetNumSyncs());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixExtentTest) {
+  auto old_extent_pages = disk_extent_pages;
+  disk_extent_pages = 16;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  {
+    DiskManagerPosix dm("test.db");
+    dm.WritePage(0, data);
+    EXPECT_EQ(BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+    EXPECT_EQ(16 * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+    dm.WritePage(15, data);
+    EXPECT_EQ(16 * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+    dm.WritePage(20, data);
+    EXPECT_EQ(21 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+    EXPECT_EQ(32 * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+  }
+
+  // Scenario: the reserved space does not count as pages in use when the file is opened again.
+  DiskManagerPosix dm("test.db");
+  EXPECT_EQ(21, dm.GetNumPages());
+  EXPECT_GE(dm.GetAllocatedSize(), 21 * BUSTUB_PAGE_SIZE);
+  dm.TruncatePages(4);
+  EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+  dm.WritePage(4, data);
+  EXPECT_EQ(16 * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+  disk_extent_pages = old_extent_pages;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UringAsyncIoTest) {
+  // Queue depth 0 forces the synchronous fallback, which has to behave the same.
+  for (uint32_t queue_depth : {8U, 0U}) {
+    SCOPED_TRACE(queue_depth);
+    remove("test.db");
+    DiskManagerUring dm("test.db", queue_depth);
+    EXPECT_EQ(queue_depth > 0, dm.IsAsync());
+    char data[BUSTUB_PAGE_SIZE] = {0};
+    char buf[BUSTUB_PAGE_SIZE] = {0};
+    std::strncpy(data, "A test string.", sizeof(data));
+
+    // Scenario: single requests, waited for with futures.
+    EXPECT_TRUE(dm.WritePageAsync(3, data).get());
+    EXPECT_TRUE(dm.ReadPageAsync(3, buf).get());
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    std::memset(buf, 1, sizeof(buf));
+    EXPECT_TRUE(dm.ReadPageAsync(9, buf).get());
+    EXPECT_EQ(0, buf[0]);
+
+    // Scenario: a batch larger than the queues, with callbacks.
+    const int num_pages = 40;
+    std::vector<std::array<char, BUSTUB_PAGE_SIZE>> pages(num_pages);
+    std::vector<DiskManager::AsyncIoRequest> requests;
+    std::promise<void> done;
+    std::atomic<int> remaining = num_pages;
+    for (int i = 0; i < num_pages; i++) {
+      pages[i].fill('a' + i % 26);
+      requests.push_back({true, i, pages[i].data(), [&](bool success) {
+                            EXPECT_TRUE(success);
+                            if (--remaining == 0) {
+                              done.set_value();
+                            }
+                          }});
+    }
+    dm.SubmitIo(std::move(requests));
+    done.get_future().wait();
+    EXPECT_EQ(num_pages + 1, dm.GetNumWrites());
+    EXPECT_EQ(num_pages * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+
+    // Scenario: batch reads and writes wait for the whole batch.
+    std::vector<std::pair<page_id_t, char *>> reads;
+    std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(num_pages);
+    for (int i = 0; i < num_pages; i++) {
+      reads.emplace_back(num_pages - 1 - i, bufs[i].data());
+    }
+    dm.ReadPages(reads);
+    for (int i = 0; i < num_pages; i++) {
+      EXPECT_EQ(std::memcmp(bufs[i].data(), pages[num_pages - 1 - i].data(), BUSTUB_PAGE_SIZE), 0);
+    }
+    dm.WritePages({{0, data}, {1, data}});
+    dm.ReadPage(1, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    dm.ShutDown();
+  }
+}
+
+/** Have num_threads threads write and read back pages_per_thread random pages each, return pages per ms. */
+auto DiskThroughputBenchmarkCall(DiskManager *disk_manager, int num_threads, int num_pages, int pages_per_thread)
+    -> double {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([=] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<page_id_t> page(0, num_pages - 1);
+      char data[BUSTUB_PAGE_SIZE];
+      std::memset(data, 'a' + t, sizeof(data));
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = page(gen);
+        if (i % 4 == 0) {
+          disk_manager->WritePage(page_id, data);
+        } else {
+          disk_manager->ReadPage(page_id, data);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(num_threads) * pages_per_thread * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+TEST_F(DiskManagerTest, DISABLED_ThroughputBenchmark) {  // NOLINT
+  const int num_pages = 4096;
+  const int pages_per_thread = 20000;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  {
+    DiskManagerPosix dm("test.db");
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+  }
+
+  std::cout << "This test compares the page I/O throughput of DiskManager (fstream under one latch) and "
+            << "DiskManagerPosix (pread/pwrite, no latch) for a 3:1 mix of random reads and writes over "
+            << num_pages << " pages." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (int num_threads : {1, 2, 4, 8}) {
+    auto *stream_dm = new DiskManager("test.db");
+    double stream = DiskThroughputBenchmarkCall(stream_dm, num_threads, num_pages, pages_per_thread);
+    stream_dm->ShutDown();
+    delete stream_dm;
+    auto *posix_dm = new DiskManagerPosix("test.db");
+    double posix = DiskThroughputBenchmarkCall(posix_dm, num_threads, num_pages, pages_per_thread);
+    posix_dm->ShutDown();
+    delete posix_dm;
+    std::cout << "threads=" << num_threads << " fstream=" << stream << " pages/ms posix=" << posix << " pages/ms"
+              << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+/** Append num_pages pages to a new database file, return pages per ms. */
+auto AppendBenchmarkCall(FsyncPolicy fsync_policy, int num_pages) -> double {
+  remove("test.db");
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  auto start = std::chrono::steady_clock::now();
+  {
+    DiskManagerPosix dm("test.db", fsync_policy, 64);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(num_pages) * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+TEST_F(DiskManagerTest, DISABLED_ExtentBenchmark) {  // NOLINT
+  const int num_pages = 16384;
+  auto old_extent_pages = disk_extent_pages;
+  std::cout << "This test appends " << num_pages << " pages to a new database file, as a bulk insert does, with "
+            << "space reserved in extents of different sizes (0 grows the file page by page)." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t extent_pages : {0, 16, 64, 256, 1024}) {
+    disk_extent_pages = extent_pages;
+    double never = AppendBenchmarkCall(FsyncPolicy::Never, num_pages);
+    double periodic = AppendBenchmarkCall(FsyncPolicy::Periodic, num_pages);
+    std::cout << "extent_pages=" << extent_pages << " no_fsync=" << never << " pages/ms fsync_every_64=" << periodic
+              << " pages/ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+  disk_extent_pages = old_extent_pages;
+}
+
+/** Read num_batches batches of batch_size random pages from a single thread, return pages per ms. */
+auto UringBenchmarkCall(DiskManager *disk_manager, int num_pages, int batch_size, int num_batches) -> double {
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<page_id_t> page(0, num_pages - 1);
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(batch_size);
+  std::vector<std::pair<page_id_t, char *>> reads(batch_size);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_batches; i++) {
+    for (int j = 0; j < batch_size; j++) {
+      reads[j] = {page(gen), bufs[j].data()};
+    }
+    disk_manager->ReadPages(reads);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(batch_size) * num_batches * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+TEST_F(DiskManagerTest, DISABLED_UringBenchmark) {  // NOLINT
+  const int num_pages = 16384;
+  const int num_batches = 500;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  {
+    DiskManagerPosix dm("test.db");
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+  }
+
+  std::cout << "This test compares batched random page reads from a single thread, issued synchronously one run "
+            << "at a time (DiskManagerPosix) and all in flight at once (DiskManagerUring)." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (int batch_size : {1, 8, 32, 128}) {
+    DiskManagerPosix posix_dm("test.db");
+    double posix = UringBenchmarkCall(&posix_dm, num_pages, batch_size, num_batches);
+    DiskManagerUring uring_dm("test.db", 256);
+    double uring = UringBenchmarkCall(&uring_dm, num_pages, batch_size, num_batches);
+    std::cout << "batch=" << batch_size << " posix=" << posix << " pages/ms io_uring=" << uring << " pages/ms"
+              << (uring_dm.IsAsync() ? "" : " (io_uring unavailable, fell back)") << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+/** Evict the database file from the page cache, so that the next scan has to go to the disk. */
+void DropFileCache(const char *db_file) {
+  int fd = open(db_file, O_RDONLY);
+  ASSERT_GE(fd, 0);
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+/** Read pages 0 to num_pages - 1 in order and sum their first bytes, return pages per ms. */
+auto ScanBenchmarkCall(DiskManager *disk_manager, int num_pages) -> double {
+  char buf[BUSTUB_PAGE_SIZE];
+  int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    disk_manager->ReadPage(page_id, buf);
+    sum += buf[0];
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_EQ(num_pages, sum);
+  return static_cast<double>(num_pages) * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+/** Same as ScanBenchmarkCall, but looking at the pages in the mapping instead of copying them out. */
+auto MappedScanBenchmarkCall(DiskManagerMmap *disk_manager, int num_pages) -> double {
+  int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    sum += disk_manager->GetMappedPage(page_id)[0];
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_EQ(num_pages, sum);
+  return static_cast<double>(num_pages) * 1000 / std::max<int64_t>(elapsed.count(), 1);
+}
+
+TEST_F(DiskManagerTest, DISABLED_MmapScanBenchmark) {  // NOLINT
+  const int num_pages = 16384;
+  char data[BUSTUB_PAGE_SIZE];
+  std::memset(data, 1, sizeof(data));
+  {
+    DiskManagerPosix dm("test.db");
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      dm.WritePage(page_id, data);
+    }
+  }
+
+  std::cout << "This test compares a sequential scan over " << num_pages << " pages with DiskManager (fstream), "
+            << "DiskManagerMmap (memcpy from the mapping) and DiskManagerMmap without the copy (GetMappedPage), "
+            << "first with the file evicted from the page cache (cold), then again (warm)." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  auto *stream_dm = new DiskManager("test.db");
+  DropFileCache("test.db");
+  double stream_cold = ScanBenchmarkCall(stream_dm, num_pages);
+  double stream_warm = ScanBenchmarkCall(stream_dm, num_pages);
+  stream_dm->ShutDown();
+  delete stream_dm;
+  std::cout << "fstream cold=" << stream_cold << " pages/ms warm=" << stream_warm << " pages/ms" << std::endl;
+
+  DiskManagerMmap mmap_dm("test.db");
+  DropFileCache("test.db");
+  double mmap_cold = ScanBenchmarkCall(&mmap_dm, num_pages);
+  double mmap_warm = ScanBenchmarkCall(&mmap_dm, num_pages);
+  std::cout << "mmap cold=" << mmap_cold << " pages/ms warm=" << mmap_warm << " pages/ms" << std::endl;
+
+  DiskManagerMmap mapped_dm("test.db");
+  DropFileCache("test.db");
+  double mapped_cold = MappedScanBenchmarkCall(&mapped_dm, num_pages);
+  double mapped_warm = MappedScanBenchmarkCall(&mapped_dm, num_pages);
+  std::cout << "mmap zero-copy cold=" << mapped_cold << " pages/ms warm=" << mapped_warm << " pages/ms" << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, MmapReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::strncpy(data, "A test string.", sizeof(data));
+  {
+    DiskManagerPosix dm("test.db");
+    dm.WritePage(2, data);
+  }
+
+  // Scenario: an existing file is mapped on open.
+  DiskManagerMmap dm("test.db");
+  EXPECT_EQ(DiskManagerMmap::MAP_EXTENT_SIZE, dm.GetMappedBytes());
+  dm.ReadPage(2, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(3, buf);  // past the end of the file
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(nullptr, dm.GetMappedPage(3));
+
+  // Scenario: a write shows through the mapping, and writes past the mapped extent grow it.
+  const char *mapped = dm.GetMappedPage(2);
+  ASSERT_NE(nullptr, mapped);
+  data[0] = 'B';
+  dm.WritePage(2, data);
+  EXPECT_EQ('B', mapped[0]);
+  page_id_t far_page = 3 * DiskManagerMmap::MAP_EXTENT_SIZE / BUSTUB_PAGE_SIZE;
+  dm.WritePage(far_page, data);
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(2);
+  dm.ReadPages({{far_page, bufs[0].data()}, {2, bufs[1].data()}});
+  EXPECT_EQ(std::memcmp(bufs[0].data(), data, sizeof(data)), 0);
+  EXPECT_EQ(std::memcmp(bufs[1].data(), data, sizeof(data)), 0);
+  EXPECT_EQ(4 * DiskManagerMmap::MAP_EXTENT_SIZE, dm.GetMappedBytes());
+
+  // Scenario: pages beyond the reservation are read with pread.
+  DiskManagerMmap small_dm("test.db", DiskManagerMmap::MAP_EXTENT_SIZE);
+  EXPECT_EQ(nullptr, small_dm.GetMappedPage(far_page));
+  small_dm.ReadPage(far_page, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  EXPECT_NE(nullptr, small_dm.GetMappedPage(2));
+}
+
+TEST_F(DiskManagerTest, DISABLED_TablespaceBenchmark) {  // NOLINT
+  const int num_pages = 4096;
+  const size_t batch_size = 256;
+  // A device that is limited by its bandwidth rather than by its latency.
+  DiskProfile profile{std::chrono::microseconds(50), std::chrono::microseconds(50), 200ULL << 20, 32, false};
+  std::cout << "This test reads " << num_pages << " pages in batches of " << batch_size << " from a tablespace "
+            << "striped over 1, 2 and 4 simulated devices of 200 MB/s each." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_files : {1, 2, 4}) {
+    std::vector<std::unique_ptr<DiskManagerUnlimitedMemory>> memory_dms;
+    std::vector<std::unique_ptr<DiskManagerLatency>> devices;
+    std::vector<DiskManager *> files;
+    for (size_t i = 0; i < num_files; i++) {
+      memory_dms.emplace_back(std::make_unique<DiskManagerUnlimitedMemory>());
+      devices.emplace_back(std::make_unique<DiskManagerLatency>(memory_dms.back().get(), profile));
+      files.push_back(devices.back().get());
+    }
+    DiskManagerTablespace dm(files, 16);
+    std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(batch_size);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      memory_dms[dm.FileOf(page_id)]->WritePage(dm.LocalPageId(page_id), bufs[0].data());
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (page_id_t first = 0; first < num_pages; first += batch_size) {
+      std::vector<std::pair<page_id_t, char *>> reads;
+      for (size_t i = 0; i < batch_size; i++) {
+        reads.emplace_back(first + static_cast<page_id_t>(i), bufs[i].data());
+      }
+      dm.ReadPages(reads);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "files=" << num_files << " " << static_cast<double>(num_pages) * BUSTUB_PAGE_SIZE / elapsed.count()
+              << " MB/s" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LatencyTest) {
+  using std::chrono::milliseconds;
+  DiskManagerUnlimitedMemory memory_dm;
+  DiskManagerLatency dm(&memory_dm, {milliseconds(2), milliseconds(1), 0, 4, false});
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::strncpy(data, "A test string.", sizeof(data));
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    dm.WritePage(page_id, data);
+  }
+  EXPECT_EQ(16, dm.GetNumWrites());
+
+  // Scenario: reads one after the other each take the full latency.
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    dm.ReadPage(page_id * 2, buf);
+  }
+  auto serial = std::chrono::steady_clock::now() - start;
+  EXPECT_GE(serial, milliseconds(8));
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // Scenario: a batch of eight scattered pages takes two rounds through the queue.
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(8);
+  std::vector<std::pair<page_id_t, char *>> reads;
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    reads.emplace_back(page_id * 2, bufs[page_id].data());
+  }
+  start = std::chrono::steady_clock::now();
+  dm.ReadPages(reads);
+  auto batched = std::chrono::steady_clock::now() - start;
+  EXPECT_GE(batched, milliseconds(4));
+  EXPECT_LT(batched, 2 * serial);
+  EXPECT_EQ(std::memcmp(bufs[7].data(), data, sizeof(data)), 0);
+  EXPECT_EQ(12, dm.GetNumReads());
+
+  // Scenario: asynchronous requests complete in the order the device finishes them.
+  std::vector<int> completed;
+  std::vector<DiskManager::AsyncIoRequest> requests;
+  requests.push_back({false, 3, buf, [&completed](bool success) { completed.push_back(0); }});
+  requests.push_back({true, 5, data, [&completed](bool success) { completed.push_back(1); }});
+  dm.SubmitIo(std::move(requests));
+  EXPECT_EQ((std::vector<int>{1, 0}), completed);
+
+  // Scenario: consecutive pages are one I/O, and each page takes its share of the bandwidth.
+  DiskManagerLatency disk_dm(&memory_dm, {milliseconds(20), milliseconds(20), 1000 * BUSTUB_PAGE_SIZE, 1, true});
+  disk_dm.ReadPages({{4, bufs[0].data()}, {5, bufs[1].data()}, {6, bufs[2].data()}});
+  EXPECT_EQ(milliseconds(3), disk_dm.GetTransferTime());
+  start = std::chrono::steady_clock::now();
+  disk_dm.ReadPage(7, buf);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, milliseconds(10));
+}
+
+/** Fetch and unpin the given pages, batch_size pages at a time, return the time it took in ms. */
+auto FetchBenchmarkCall(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids, size_t batch_size) -> double {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < page_ids.size(); i += batch_size) {
+    std::vector<page_id_t> batch(page_ids.begin() + i, page_ids.begin() + std::min(i + batch_size, page_ids.size()));
+    if (batch_size == 1) {
+      bpm->FetchPage(batch[0]);
+    } else {
+      bpm->FetchPages(batch);
+    }
+    bpm->UnpinPages(batch, false);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(elapsed.count()) / 1000;
+}
+
+TEST_F(DiskManagerTest, DISABLED_LatencyBenchmark) {  // NOLINT
+  const int num_pages = 1024;
+  const int num_random_pages = 256;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  DiskManagerUnlimitedMemory memory_dm;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    memory_dm.WritePage(page_id, data);
+  }
+  std::vector<page_id_t> sequential(num_pages);
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    sequential[page_id] = page_id;
+  }
+  std::mt19937 gen(15445);
+  std::vector<page_id_t> random(num_random_pages);
+  for (auto &page_id : random) {
+    page_id = std::uniform_int_distribution<page_id_t>(0, num_pages - 1)(gen);
+  }
+
+  std::cout << "This test fetches pages through a buffer pool of 64 frames on simulated devices: " << num_pages
+            << " pages in order, one at a time and in batches of 32, then " << num_random_pages
+            << " random pages one at a time and in batches of 32." << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  std::vector<std::pair<const char *, DiskProfile>> profiles = {
+      {"nvme", DiskProfile::Nvme()}, {"sata_ssd", DiskProfile::SataSsd()}, {"hdd", DiskProfile::Hdd()}};
+  for (const auto &[name, profile] : profiles) {
+    std::cout << name;
+    for (const auto *page_ids : {&sequential, &random}) {
+      for (size_t batch_size : {1, 32}) {
+        DiskManagerLatency dm(&memory_dm, profile);
+        BufferPoolManagerInstance bpm(64, &dm);
+        std::cout << (page_ids == &sequential ? " sequential" : " random") << "_batch" << batch_size << "="
+                  << FetchBenchmarkCall(&bpm, *page_ids, batch_size) << "ms";
+      }
+    }
+    std::cout << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, TablespaceTest) {
+  std::vector<std::string> db_files = {"test.db", "test_1.db", "test_2.db"};
+  const page_id_t num_pages = 14;
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> data(num_pages);
+  {
+    DiskManagerTablespace dm(db_files, 2);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      data[page_id].fill(static_cast<char>('a' + page_id));
+      if (page_id % 2 == 0) {
+        dm.WritePage(page_id, data[page_id].data());
+      }
+    }
+    // Scenario: a batch that spans all the files is split up among their queues.
+    std::vector<std::pair<page_id_t, const char *>> writes;
+    for (page_id_t page_id = 1; page_id < num_pages; page_id += 2) {
+      writes.emplace_back(page_id, data[page_id].data());
+    }
+    dm.WritePages(writes);
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+    EXPECT_EQ(num_pages, dm.GetNumPages());
+
+    // Scenario: the asynchronous requests of a batch complete on the queues of their files.
+    std::array<char, BUSTUB_PAGE_SIZE> buf;
+    std::promise<bool> done;
+    dm.ReadPageAsync(9, buf.data(), [&done](bool success) { done.set_value(success); });
+    EXPECT_TRUE(done.get_future().get());
+    EXPECT_EQ(buf, data[9]);
+  }
+
+  // Scenario: every file got its stripes, and the pages read back from all files after reopening.
+  DiskManagerPosix file_0("test.db", FsyncPolicy::Never, 64, false);
+  EXPECT_EQ(6, file_0.GetNumPages());
+  file_0.ShutDown();
+  DiskManagerTablespace dm(db_files, 2);
+  EXPECT_EQ(0, dm.FileOf(13));
+  EXPECT_EQ(5, dm.LocalPageId(13));
+  EXPECT_EQ(num_pages, dm.GetNumPages());
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(num_pages);
+  std::vector<std::pair<page_id_t, char *>> reads;
+  for (page_id_t page_id = num_pages - 1; page_id >= 0; page_id--) {
+    reads.emplace_back(page_id, bufs[page_id].data());
+  }
+  dm.ReadPages(reads);
+  EXPECT_EQ(bufs, data);
+
+  // Scenario: truncating cuts each file down to its part of the remaining pages.
+  dm.TruncatePages(9);
+  EXPECT_EQ(9, dm.GetNumPages());
+  dm.TruncatePages(5);
+  EXPECT_EQ(5, dm.GetNumPages());
+  dm.ReadPage(4, bufs[0].data());
+  EXPECT_EQ(bufs[0], data[4]);
+  dm.ShutDown();
+  remove("test_1.db");
+  remove("test_2.db");
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
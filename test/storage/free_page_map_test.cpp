@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map_test.cpp
+//
+// Identification: test/storage/free_page_map_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/free_page_map.h"
+
+namespace bustub {
+
+class FreePageMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, AllocateTest) {
+  DiskManagerPosix disk_manager("test.db");
+  FreePageMap map(&disk_manager);
+
+  // Scenario: pages are handed out in order, skipping the map page.
+  EXPECT_EQ(0, map.AllocatePage());
+  EXPECT_EQ(2, map.AllocatePage());
+  EXPECT_EQ(3, map.AllocatePage());
+  EXPECT_EQ(4, map.GetNumPages());
+
+  // Scenario: freed pages are reused lowest first, before the file grows.
+  map.DeallocatePage(3);
+  map.DeallocatePage(2);
+  map.DeallocatePage(2);
+  map.DeallocatePage(1);
+  map.DeallocatePage(10);
+  EXPECT_EQ(2, map.GetNumFreePages());
+  EXPECT_TRUE(map.IsFree(2));
+  EXPECT_FALSE(map.IsFree(1));
+  EXPECT_EQ(2, map.AllocatePage());
+  EXPECT_EQ(3, map.AllocatePage());
+  EXPECT_EQ(4, map.AllocatePage());
+  EXPECT_EQ(0, map.GetNumFreePages());
+
+  // Scenario: the second range has its own map page.
+  page_id_t page_id = 0;
+  while (page_id < FreePageMap::PAGES_PER_MAP_PAGE) {
+    page_id = map.AllocatePage();
+  }
+  EXPECT_EQ(FreePageMap::PAGES_PER_MAP_PAGE, page_id);
+  EXPECT_EQ(FreePageMap::PAGES_PER_MAP_PAGE + 2, map.AllocatePage());
+  map.DeallocatePage(FreePageMap::PAGES_PER_MAP_PAGE + 2);
+  EXPECT_EQ(FreePageMap::PAGES_PER_MAP_PAGE + 2, map.AllocatePage());
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, InstancesTest) {
+  DiskManagerPosix disk_manager("test.db");
+  FreePageMap map(&disk_manager, 3);
+
+  // Scenario: every instance only gets its own pages; pages skipped over go to the other instances.
+  EXPECT_EQ(2, map.AllocatePage(2));
+  EXPECT_EQ(1, map.GetNumFreePages());
+  EXPECT_EQ(0, map.AllocatePage(0));
+  EXPECT_EQ(3, map.AllocatePage(0));
+  EXPECT_EQ(4, map.AllocatePage(1));
+  EXPECT_EQ(5, map.AllocatePage(2));
+  EXPECT_EQ(7, map.AllocatePage(1));
+  EXPECT_EQ(1, map.GetNumFreePages());
+  EXPECT_TRUE(map.IsFree(6));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, RecoverAndTruncateTest) {
+  char data[BUSTUB_PAGE_SIZE];
+  std::memset(data, 'x', sizeof(data));
+  {
+    DiskManagerPosix disk_manager("test.db");
+    FreePageMap map(&disk_manager);
+    for (int i = 0; i < 10; i++) {
+      disk_manager.WritePage(map.AllocatePage(), data);
+    }
+    map.DeallocatePage(3);
+    map.DeallocatePage(8);
+    map.DeallocatePage(9);
+    map.DeallocatePage(10);
+  }
+
+  // Scenario: the free pages come back after a restart.
+  DiskManagerPosix disk_manager("test.db");
+  {
+    FreePageMap map(&disk_manager);
+    EXPECT_EQ(11, map.GetNumPages());
+    EXPECT_EQ(4, map.GetNumFreePages());
+    EXPECT_TRUE(map.IsFree(3));
+    EXPECT_TRUE(map.IsFree(10));
+
+    // Scenario: the free pages at the end are cut off the file, the one in the middle stays.
+    EXPECT_EQ(3, map.TruncateFreePages());
+    EXPECT_EQ(8, disk_manager.GetNumPages());
+    EXPECT_EQ(8, map.GetNumPages());
+    EXPECT_EQ(0, map.TruncateFreePages());
+    EXPECT_EQ(3, map.AllocatePage());
+    EXPECT_EQ(8, map.AllocatePage());
+  }
+
+  // Scenario: pages taken off the map stay taken after a restart.
+  FreePageMap map(&disk_manager);
+  EXPECT_EQ(0, map.GetNumFreePages());
+  EXPECT_EQ(8, map.AllocatePage());
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, NotAMapTest) {
+  char data[BUSTUB_PAGE_SIZE];
+  std::memset(data, 'x', sizeof(data));
+  DiskManagerPosix disk_manager("test.db");
+  disk_manager.WritePage(0, data);
+  disk_manager.WritePage(1, data);
+  EXPECT_THROW(FreePageMap map(&disk_manager), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreePageMapTest, BufferPoolTest) {
+  auto old_free_page_map = bpm_free_page_map;
+  bpm_free_page_map = true;
+  DiskManagerPosix disk_manager("test.db");
+  {
+    BufferPoolManagerInstance bpm(4, &disk_manager);
+    ASSERT_NE(nullptr, bpm.GetFreePageMap());
+    page_id_t page_ids[4];
+    for (auto &page_id : page_ids) {
+      ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+      bpm.UnpinPage(page_id, true);
+    }
+    EXPECT_EQ(4, page_ids[3]);
+
+    // Scenario: a deleted page is reused.
+    EXPECT_TRUE(bpm.DeletePage(page_ids[1]));
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    EXPECT_EQ(page_ids[1], page_id);
+    bpm.UnpinPage(page_id, false);
+    bpm.FlushAllPages();
+    EXPECT_TRUE(bpm.DeletePage(page_ids[0]));
+    EXPECT_TRUE(bpm.DeletePage(page_ids[3]));
+    EXPECT_EQ(2, bpm.GetFreePageMap()->GetNumFreePages());
+    EXPECT_EQ(1, bpm.GetFreePageMap()->TruncateFreePages());
+  }
+
+  // Scenario: the instances of a parallel buffer pool share the map, which they recover from the file.
+  {
+    ParallelBufferPoolManager bpm(2, 4, &disk_manager);
+    EXPECT_EQ(1, bpm.GetFreePageMap()->GetNumFreePages());
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    EXPECT_EQ(0, page_id);
+    bpm.UnpinPage(page_id, false);
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    EXPECT_EQ(5, page_id);
+    bpm.UnpinPage(page_id, false);
+    EXPECT_TRUE(bpm.GetFreePageMap()->IsFree(4));
+  }
+  bpm_free_page_map = old_free_page_map;
+}
+
+}  // namespace bustub
@@ -0,0 +1,457 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/pax_page.h"
+#include "storage/page/table_page.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_vacuum.h"
+#include "storage/table/tuple.h"
+#include "storage/table/tuple_batch.h"
+#include "storage/table/tuple_view.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+  Transaction txn(0);
+  Schema schema({Column{"a", TypeId::VARCHAR, 400}});
+  Tuple tuple(std::vector<Value>{ValueFactory::GetVarcharValue(std::string(300, 'x'))}, &schema);
+
+  auto table = std::make_unique<TableHeap>(&bpm, nullptr, nullptr, &txn);
+  page_id_t first_page_id = table->GetFirstPageId();
+  std::vector<RID> rids(100);
+  for (auto &rid : rids) {
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, &txn));
+  }
+  page_id_t last_page_id = rids.back().GetPageId();
+  EXPECT_NE(first_page_id, last_page_id);
+
+  // Scenario: every page is in the map, and the full pages are known to be full.
+  FreeSpaceMap *map = table->GetFreeSpaceMap();
+  size_t num_pages = map->GetNumPages();
+  EXPECT_GT(num_pages, 5);
+  EXPECT_EQ(last_page_id, map->GetLastPageId());
+  EXPECT_LT(map->GetFreeSpace(first_page_id), TablePage::GetSpaceNeeded(tuple));
+
+  // Scenario: a delete makes room in the first page, and the next insert goes straight there.
+  ASSERT_TRUE(table->MarkDelete(rids[0], &txn));
+  table->ApplyDelete(rids[0], &txn);
+  EXPECT_GE(map->GetFreeSpace(first_page_id), TablePage::GetSpaceNeeded(tuple));
+  EXPECT_EQ(first_page_id, map->FindPage(TablePage::GetSpaceNeeded(tuple)));
+  RID rid;
+  ASSERT_TRUE(table->InsertTuple(tuple, &rid, &txn));
+  EXPECT_EQ(first_page_id, rid.GetPageId());
+
+  // Scenario: flushing the buffer pool writes the map back, and it is loaded back when the table is opened again.
+  bpm.FlushAllPages();
+  FreeSpaceMap stored(&bpm);
+  ASSERT_TRUE(stored.Load(map->GetRootPageId(), {first_page_id, last_page_id}));
+  EXPECT_EQ(2, stored.GetNumPages());
+  EXPECT_EQ(last_page_id, stored.GetLastPageId());
+  page_id_t map_page_id = map->GetRootPageId();
+  table = std::make_unique<TableHeap>(&bpm, nullptr, nullptr, first_page_id, map_page_id);
+  map = table->GetFreeSpaceMap();
+  EXPECT_EQ(num_pages, map->GetNumPages());
+  EXPECT_EQ(last_page_id, map->GetLastPageId());
+  EXPECT_LT(map->GetFreeSpace(first_page_id), TablePage::GetSpaceNeeded(tuple));
+  ASSERT_TRUE(table->InsertTuple(tuple, &rid, &txn));
+  EXPECT_EQ(last_page_id, rid.GetPageId());
+
+  EXPECT_EQ(map_page_id, map->GetRootPageId());
+
+  // Scenario: a table opened without a map gets one built from its page chain, and its pages are left as they were.
+  table = std::make_unique<TableHeap>(&bpm, nullptr, nullptr, first_page_id);
+  map = table->GetFreeSpaceMap();
+  EXPECT_EQ(num_pages, map->GetNumPages());
+  EXPECT_EQ(last_page_id, map->GetLastPageId());
+  EXPECT_NE(map_page_id, map->GetRootPageId());
+  auto first_page = static_cast<TablePage *>(bpm.FetchPage(first_page_id));
+  EXPECT_EQ(INVALID_PAGE_ID, first_page->GetPrevPageId());
+  bpm.UnpinPage(first_page_id, false);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BulkInsertTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+  Transaction txn(0);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 400}});
+  TableHeap table(&bpm, nullptr, nullptr, &txn);
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(Tuple({ValueFactory::GetIntegerValue(-1), ValueFactory::GetVarcharValue("")}, &schema),
+                                &rid, &txn));
+
+  // Scenario: the tuples go to fresh pages, a few batches of them, after the page that is already there.
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 500; i++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(i),
+                                           ValueFactory::GetVarcharValue(std::string(100, 'x'))},
+                        &schema);
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(table.BulkInsertTuples(tuples, &rids, &txn));
+  ASSERT_EQ(tuples.size(), rids.size());
+  EXPECT_NE(rid.GetPageId(), rids[0].GetPageId());
+  EXPECT_EQ(tuples.size() + 1, txn.GetWriteSet()->size());
+  for (size_t i = 0; i < rids.size(); i += 50) {
+    Tuple tuple;
+    ASSERT_TRUE(table.GetTuple(rids[i], &tuple, &txn));
+    EXPECT_EQ(static_cast<int>(i), tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+
+  // Scenario: the pages are written out, chained in order and known to the free space map.
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager.ReadPage(rids.back().GetPageId(), data);
+  EXPECT_EQ(rids.back().GetPageId(), *reinterpret_cast<page_id_t *>(data));
+  int num_tuples = 0;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    EXPECT_EQ(num_tuples - 1, it->GetValue(&schema, 0).GetAs<int32_t>());
+    num_tuples++;
+  }
+  EXPECT_EQ(tuples.size() + 1, num_tuples);
+  EXPECT_EQ(rids.back().GetPageId(), table.GetFreeSpaceMap()->GetLastPageId());
+
+  // Scenario: a plain insert fills up the room left in the last page.
+  ASSERT_TRUE(table.InsertTuple(tuples[0], &rid, &txn));
+  EXPECT_EQ(rids.back().GetPageId(), rid.GetPageId());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PageTuplesTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+  Transaction txn(0);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 400}});
+  TableHeap table(&bpm, nullptr, nullptr, &txn);
+  std::vector<RID> rids(200);
+  for (int i = 0; i < 200; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))}, &schema);
+    ASSERT_TRUE(table.InsertTuple(tuple, &rids[i], &txn));
+  }
+  for (int i = 0; i < 200; i += 3) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    table.ApplyDelete(rids[i], &txn);
+  }
+
+  // Scenario: reading the table a page at a time yields what the iterator does, in the same order.
+  std::vector<std::pair<RID, int>> expected;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    expected.emplace_back(it->GetRid(), it->GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  std::vector<std::pair<RID, int>> scanned;
+  TupleBatch batch;
+  Tuple tuple;
+  size_t num_pages = 0;
+  for (page_id_t page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID; num_pages++) {
+    page_id = table.GetPageTuples(page_id, &batch);
+    for (size_t i = 0; i < batch.Size(); i++) {
+      batch.GetTuple(i, &tuple);
+      EXPECT_EQ(batch.GetRid(i), tuple.GetRid());
+      EXPECT_EQ(std::string(tuple.GetValue(&schema, 0).GetAs<int32_t>() % 50, 'x'),
+                tuple.GetValue(&schema, 1).ToString());
+      scanned.emplace_back(tuple.GetRid(), tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+  EXPECT_EQ(expected, scanned);
+  EXPECT_EQ(133, scanned.size());
+  EXPECT_EQ(table.GetFreeSpaceMap()->GetNumPages(), num_pages);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, TupleViewTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+  Transaction txn(0);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 400}});
+  TableHeap table(&bpm, nullptr, nullptr, &txn);
+  std::vector<RID> rids(200);
+  for (int i = 0; i < 200; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))}, &schema);
+    ASSERT_TRUE(table.InsertTuple(tuple, &rids[i], &txn));
+  }
+  for (int i = 0; i < 200; i += 3) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    table.ApplyDelete(rids[i], &txn);
+  }
+
+  // Scenario: the views of a page point into its frame and agree with the batch read of the same page.
+  page_id_t page_id = table.GetFirstPageId();
+  std::vector<TupleView> views;
+  TupleBatch batch;
+  {
+    PageGuard guard;
+    page_id_t next_page_id = table.GetPageTupleViews(page_id, &guard, &views);
+    ASSERT_NE(nullptr, guard.GetPage());
+    EXPECT_EQ(next_page_id, table.GetPageTuples(page_id, &batch));
+    ASSERT_EQ(batch.Size(), views.size());
+    const char *frame = guard.GetPage()->GetData();
+    Tuple tuple;
+    for (size_t i = 0; i < views.size(); i++) {
+      EXPECT_GE(views[i].GetData(), frame);
+      EXPECT_LT(views[i].GetData(), frame + BUSTUB_PAGE_SIZE);
+      EXPECT_EQ(batch.GetRid(i), views[i].GetRid());
+      batch.GetTuple(i, &tuple);
+      EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), views[i].GetValue(&schema, 0).GetAs<int32_t>());
+      EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), views[i].AsTuple()->GetValue(&schema, 1).ToString());
+    }
+
+    // Scenario: a materialized tuple owns its bytes.
+    views[0].Materialize(&tuple);
+    EXPECT_NE(views[0].GetData(), tuple.GetData());
+    EXPECT_EQ(views[0].GetRid(), tuple.GetRid());
+    EXPECT_EQ(views[0].GetValue(&schema, 0).GetAs<int32_t>(), tuple.GetValue(&schema, 0).GetAs<int32_t>());
+
+    // Scenario: while the guard holds the page, it stays pinned.
+    EXPECT_EQ(1, bpm.FetchPage(page_id)->GetPinCount() - 1);
+    bpm.UnpinPage(page_id, false);
+  }
+
+  // Scenario: once the guard is gone, the page is neither pinned nor latched.
+  Page *page = bpm.FetchPage(page_id);
+  EXPECT_EQ(1, page->GetPinCount());
+  page->WLatch();
+  page->WUnlatch();
+  bpm.UnpinPage(page_id, false);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PaxTableTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+  Transaction txn(0);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 20}, Column{"c", TypeId::BIGINT}});
+  TableHeap table(&bpm, nullptr, nullptr, &txn, TableFormat::PAX, &schema);
+  EXPECT_EQ(TableFormat::PAX, table.GetFormat());
+  auto make_tuple = [&schema](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 20, 'x')),
+                  ValueFactory::GetBigIntValue(i * 1000L)},
+                 &schema);
+  };
+  std::vector<RID> rids(1000);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(table.InsertTuple(make_tuple(i), &rids[i], &txn));
+  }
+  EXPECT_NE(rids.front().GetPageId(), rids.back().GetPageId());
+
+  // Scenario: a tuple comes back the way it went in, whether read whole or a column at a time.
+  Tuple tuple;
+  for (int i = 0; i < 1000; i += 37) {
+    ASSERT_TRUE(table.GetTuple(rids[i], &tuple, &txn));
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(std::string(i % 20, 'x'), tuple.GetValue(&schema, 1).ToString());
+    EXPECT_EQ(i * 1000L, tuple.GetValue(&schema, 2).GetAs<int64_t>());
+  }
+  {
+    PageGuard guard;
+    table.ScanPage(rids[5].GetPageId(), &guard);
+    auto page = static_cast<PaxPage *>(guard.GetPage());
+    ASSERT_TRUE(page->IsPaxPage());
+    EXPECT_EQ(5, page->GetValue(rids[5].GetSlotNum(), 0).GetAs<int32_t>());
+    EXPECT_EQ("xxxxx", page->GetValue(rids[5].GetSlotNum(), 1).ToString());
+    EXPECT_EQ(5000L, page->GetValue(rids[5].GetSlotNum(), 2).GetAs<int64_t>());
+  }
+
+  // Scenario: a value longer than the column is declared to hold does not go in.
+  RID rid;
+  Tuple too_long({ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(std::string(21, 'x')),
+                  ValueFactory::GetBigIntValue(0)},
+                 &schema);
+  EXPECT_FALSE(table.InsertTuple(too_long, &rid, &txn));
+
+  // Scenario: a rolled back delete keeps the tuple, an applied one frees its slot for the next insert.
+  ASSERT_TRUE(table.MarkDelete(rids[1], &txn));
+  table.RollbackDelete(rids[1], &txn);
+  ASSERT_TRUE(table.GetTuple(rids[1], &tuple, &txn));
+  for (int i = 0; i < 1000; i += 2) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    table.ApplyDelete(rids[i], &txn);
+  }
+  EXPECT_FALSE(table.GetTuple(rids[0], &tuple, &txn));
+  EXPECT_GE(table.GetFreeSpaceMap()->GetFreeSpace(rids[0].GetPageId()), PaxPage::GetSpaceNeeded(schema));
+  size_t num_pages = table.GetFreeSpaceMap()->GetNumPages();
+  for (int i = 0; i < 500; i += 2) {
+    ASSERT_TRUE(table.InsertTuple(make_tuple(i), &rid, &txn));
+  }
+  EXPECT_EQ(num_pages, table.GetFreeSpaceMap()->GetNumPages());
+
+  // Scenario: the iterator and the page-at-a-time read see the same tuples.
+  std::vector<int> expected;
+  for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+    EXPECT_EQ(std::string(it->GetValue(&schema, 0).GetAs<int32_t>() % 20, 'x'), it->GetValue(&schema, 1).ToString());
+    expected.push_back(it->GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(750, expected.size());
+  std::vector<int> scanned;
+  TupleBatch batch;
+  for (page_id_t page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id = table.GetPageTuples(page_id, &batch);
+    for (size_t i = 0; i < batch.Size(); i++) {
+      batch.GetTuple(i, &tuple);
+      scanned.push_back(tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+  EXPECT_EQ(expected, scanned);
+
+  // Scenario: the table is still PAX when it is opened again.
+  bpm.FlushAllPages();
+  TableHeap reopened(&bpm, nullptr, nullptr, table.GetFirstPageId(), table.GetFreeSpaceMap()->GetRootPageId(),
+                     &schema);
+  EXPECT_EQ(TableFormat::PAX, reopened.GetFormat());
+  ASSERT_TRUE(reopened.GetTuple(rids[999], &tuple, &txn));
+  EXPECT_EQ(999, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, VacuumPagesTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(16, &disk_manager);
+  Transaction txn(0);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 400}});
+  TableHeap table(&bpm, nullptr, nullptr, &txn);
+  std::vector<RID> rids(400);
+  for (int i = 0; i < 400; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(100, 'x'))}, &schema);
+    ASSERT_TRUE(table.InsertTuple(tuple, &rids[i], &txn));
+  }
+  // Keep every fifth tuple; the one delete that is not applied yet pins its page.
+  std::vector<int> expected;
+  for (int i = 0; i < 400; i++) {
+    if (i % 5 == 0) {
+      expected.push_back(i);
+      continue;
+    }
+    ASSERT_TRUE(table.MarkDelete(rids[i], &txn));
+    if (i != 201) {
+      table.ApplyDelete(rids[i], &txn);
+    }
+  }
+  size_t num_pages = table.GetFreeSpaceMap()->GetNumPages();
+
+  // Scenario: the sparse pages are merged, and every tuple that moves is reported with its old and new RID.
+  size_t num_moved = 0;
+  auto on_move = [&](const Tuple &tuple, const RID &new_rid) {
+    EXPECT_FALSE(tuple.GetRid() == new_rid);
+    Tuple moved;
+    ASSERT_TRUE(table.GetTuple(new_rid, &moved, &txn, false));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), moved.GetValue(&schema, 0).GetAs<int32_t>());
+    num_moved++;
+  };
+  size_t num_freed_pages = 0;
+  EXPECT_EQ(INVALID_PAGE_ID, table.VacuumPages(table.GetFirstPageId(), 1000, on_move, &txn, &num_freed_pages));
+  EXPECT_GE(num_freed_pages, num_pages / 3);
+  EXPECT_GT(num_moved, 0);
+  EXPECT_EQ(num_pages - num_freed_pages, table.GetFreeSpaceMap()->GetNumPages());
+
+  // Scenario: the tuples are all still there, and the chain holds the pages the free space map knows of.
+  std::vector<int> scanned;
+  TupleBatch batch;
+  Tuple tuple;
+  size_t num_chained_pages = 0;
+  for (page_id_t page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID; num_chained_pages++) {
+    page_id = table.GetPageTuples(page_id, &batch);
+    for (size_t i = 0; i < batch.Size(); i++) {
+      batch.GetTuple(i, &tuple);
+      scanned.push_back(tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+  std::sort(scanned.begin(), scanned.end());
+  EXPECT_EQ(expected, scanned);
+  EXPECT_EQ(table.GetFreeSpaceMap()->GetNumPages(), num_chained_pages);
+
+  // Scenario: the tuple whose delete is pending stayed where it was.
+  table.RollbackDelete(rids[201], &txn);
+  ASSERT_TRUE(table.GetTuple(rids[201], &tuple, &txn));
+  EXPECT_EQ(201, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+
+  // Scenario: the map of the vacuumed table is loaded back as it was left.
+  bpm.FlushAllPages();
+  TableHeap reopened(&bpm, nullptr, nullptr, table.GetFirstPageId(), table.GetFreeSpaceMap()->GetRootPageId());
+  EXPECT_EQ(num_chained_pages, reopened.GetFreeSpaceMap()->GetNumPages());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, TableVacuumTest) {
+  DiskManagerUnlimitedMemory disk_manager;
+  BufferPoolManagerInstance bpm(32, &disk_manager);
+  LockManager lock_manager;
+  TransactionManager txn_manager(&lock_manager, nullptr);
+  Catalog catalog(&bpm, &lock_manager, nullptr);
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 400}});
+  Transaction *txn = txn_manager.Begin();
+  std::vector<TableInfo *> tables{catalog.CreateTable(txn, "t1", schema), catalog.CreateTable(txn, "t2", schema)};
+  for (auto *table_info : tables) {
+    std::vector<RID> rids(300);
+    for (int i = 0; i < 300; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(100, 'x'))}, &schema);
+      ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rids[i], txn));
+    }
+    for (int i = 0; i < 300; i++) {
+      if (i % 10 != 0) {
+        ASSERT_TRUE(table_info->table_->MarkDelete(rids[i], txn));
+      }
+    }
+  }
+  txn_manager.Commit(txn);
+  delete txn;
+  catalog.CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(nullptr, "t1_a", "t1", schema,
+                                                                               Schema({schema.GetColumn(0)}), {0}, 8,
+                                                                               IntegerHashFunctionType{});
+  auto count_tuples = [](TableInfo *table_info) {
+    size_t num_tuples = 0;
+    TupleBatch batch;
+    for (page_id_t page_id = table_info->table_->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+      page_id = table_info->table_->GetPageTuples(page_id, &batch);
+      num_tuples += batch.Size();
+    }
+    return num_tuples;
+  };
+
+  // Scenario: vacuuming a table merges its pages and leaves its tuples alone.
+  TableVacuum vacuum(&catalog, &bpm, &txn_manager, &lock_manager);
+  size_t num_pages = tables[0]->table_->GetFreeSpaceMap()->GetNumPages();
+  size_t num_freed_pages = vacuum.VacuumTable(tables[0]->oid_);
+  EXPECT_GT(num_freed_pages, 0);
+  EXPECT_EQ(num_pages - num_freed_pages, tables[0]->table_->GetFreeSpaceMap()->GetNumPages());
+  EXPECT_EQ(30, count_tuples(tables[0]));
+  EXPECT_GT(vacuum.GetNumMovedTuples(), 0);
+  EXPECT_EQ(0, vacuum.VacuumTable(tables[0]->oid_));
+
+  // Scenario: the background thread gets around to the other table.
+  num_pages = tables[1]->table_->GetFreeSpaceMap()->GetNumPages();
+  vacuum.Start();
+  for (int i = 0; i < 100 && vacuum.GetNumFreedPages() == num_freed_pages; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  vacuum.Stop();
+  EXPECT_LT(tables[1]->table_->GetFreeSpaceMap()->GetNumPages(), num_pages);
+  EXPECT_EQ(30, count_tuples(tables[1]));
+}
+
+}  // namespace bustub
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+using bustub::AccessType;
+using bustub::frame_id_t;
+using bustub::page_id_t;
+using bustub::ReplacerType;
+
+using Trace = std::vector<std::pair<page_id_t, AccessType>>;
+
+static const std::vector<std::pair<std::string, ReplacerType>> POLICIES = {
+    {"lru-k", ReplacerType::LRUK}, {"lru", ReplacerType::LRU},     {"clock", ReplacerType::Clock},
+    {"arc", ReplacerType::ARC},    {"2q", ReplacerType::TwoQueue}, {"tinylfu", ReplacerType::TinyLFU},
+};
+
+auto ParseAccessType(const std::string &str) -> AccessType {
+  auto lower = bustub::StringUtil::Lower(str);
+  if (lower == "l" || lower == "lookup") {
+    return AccessType::Lookup;
+  }
+  if (lower == "s" || lower == "scan") {
+    return AccessType::Scan;
+  }
+  if (lower == "i" || lower == "index") {
+    return AccessType::Index;
+  }
+  if (lower == "u" || lower == "unknown") {
+    return AccessType::Unknown;
+  }
+  throw bustub::Exception(fmt::format("unexpected access type: {}", str));
+}
+
+/**
+ * Read a trace file. Every line holds a page id, optionally followed by the access type (lookup, scan, index or
+ * unknown, or their first letter). Empty lines and lines starting with '#' are skipped.
+ */
+auto ReadTrace(const std::string &path) -> Trace {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw bustub::Exception(fmt::format("cannot open trace file: {}", path));
+  }
+  Trace trace;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream in(line);
+    std::string page;
+    std::string type;
+    if (!(in >> page) || page[0] == '#') {
+      continue;
+    }
+    trace.emplace_back(std::stoi(page), (in >> type) ? ParseAccessType(type) : AccessType::Unknown);
+  }
+  return trace;
+}
+
+/**
+ * Generate a synthetic trace.
+ *   oltp:  lookups on num_pages pages, skewed so that a small hot set receives most of them
+ *   scan:  repeated sequential scans over num_pages pages
+ *   mixed: oltp lookups interleaved with scans over a table twice as large as the OLTP data
+ */
+auto GenerateTrace(const std::string &workload, size_t num_accesses, size_t num_pages) -> Trace {
+  std::mt19937 gen(15445);
+  // An 80/20 skew: 80% of the lookups go to 20% of the pages.
+  std::uniform_real_distribution<double> coin(0, 1);
+  std::uniform_int_distribution<page_id_t> hot(0, static_cast<page_id_t>(num_pages / 5));
+  std::uniform_int_distribution<page_id_t> any(0, static_cast<page_id_t>(num_pages - 1));
+  auto lookup = [&]() -> page_id_t { return coin(gen) < 0.8 ? hot(gen) : any(gen); };
+
+  Trace trace;
+  trace.reserve(num_accesses);
+  auto scan_start = static_cast<page_id_t>(num_pages);
+  page_id_t scan_next = scan_start;
+  while (trace.size() < num_accesses) {
+    if (workload == "oltp") {
+      trace.emplace_back(lookup(), AccessType::Lookup);
+    } else if (workload == "scan") {
+      trace.emplace_back(static_cast<page_id_t>(trace.size() % num_pages), AccessType::Scan);
+    } else if (workload == "mixed") {
+      // One scan step for every four lookups.
+      if (trace.size() % 5 == 4) {
+        trace.emplace_back(scan_next++, AccessType::Scan);
+        if (scan_next == scan_start + static_cast<page_id_t>(2 * num_pages)) {
+          scan_next = scan_start;
+        }
+      } else {
+        trace.emplace_back(lookup(), AccessType::Lookup);
+      }
+    } else {
+      throw bustub::Exception(fmt::format("unknown workload: {}", workload));
+    }
+  }
+  return trace;
+}
+
+/**
+ * Replay a trace against a buffer pool of pool_size frames that unpins every page right after accessing it, the way
+ * BufferPoolManagerInstance drives its replacer, and return the number of hits.
+ */
+auto Replay(bustub::Replacer *replacer, size_t pool_size, const Trace &trace) -> size_t {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(pool_size, bustub::INVALID_PAGE_ID);
+  size_t num_used = 0;
+  size_t hits = 0;
+  for (const auto &[page_id, access_type] : trace) {
+    frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      frame_id = it->second;
+      hits++;
+    } else {
+      if (num_used < pool_size) {
+        frame_id = static_cast<frame_id_t>(num_used++);
+      } else {
+        if (!replacer->Evict(&frame_id)) {
+          throw bustub::Exception("replacer has no victim although every frame is unpinned");
+        }
+        page_table.erase(frame_pages[frame_id]);
+      }
+      page_table[page_id] = frame_id;
+      frame_pages[frame_id] = page_id;
+    }
+    replacer->RecordAccess(frame_id, page_id, access_type);
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return hits;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-sim");
+  program.add_argument("--trace").help("replay the page accesses recorded in this file");
+  program.add_argument("--workload").help("generate a synthetic trace instead: oltp, scan or mixed");
+  program.add_argument("--accesses").help("number of accesses of the synthetic trace");
+  program.add_argument("--pages").help("number of pages touched by the lookups of the synthetic trace");
+  program.add_argument("--pool-size").help("comma-separated buffer pool sizes to simulate");
+  program.add_argument("--policies").help("comma-separated policies: lru-k, lru, clock, arc, 2q, tinylfu");
+  program.add_argument("--k").help("lookback constant of the LRU-K replacer");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  try {
+    Trace trace;
+    if (program.present("--trace")) {
+      trace = ReadTrace(program.get("--trace"));
+    } else {
+      std::string workload = program.present("--workload") ? program.get("--workload") : "mixed";
+      size_t num_accesses = program.present("--accesses") ? std::stoul(program.get("--accesses")) : 1000000;
+      size_t num_pages = program.present("--pages") ? std::stoul(program.get("--pages")) : 10000;
+      trace = GenerateTrace(workload, num_accesses, num_pages);
+    }
+
+    std::vector<size_t> pool_sizes;
+    for (const auto &size : bustub::StringUtil::Split(program.present("--pool-size") ? program.get("--pool-size")
+                                                                                       : "256,1024,4096",
+                                                      ',')) {
+      pool_sizes.push_back(std::stoul(size));
+    }
+
+    std::vector<std::pair<std::string, ReplacerType>> policies;
+    if (program.present("--policies")) {
+      for (const auto &name : bustub::StringUtil::Split(program.get("--policies"), ',')) {
+        auto it = std::find_if(POLICIES.begin(), POLICIES.end(), [&](const auto &policy) {
+          return policy.first == bustub::StringUtil::Lower(name);
+        });
+        if (it == POLICIES.end()) {
+          throw bustub::Exception(fmt::format("unknown policy: {}", name));
+        }
+        policies.push_back(*it);
+      }
+    } else {
+      policies = POLICIES;
+    }
+    size_t k = program.present("--k") ? std::stoul(program.get("--k")) : bustub::LRUK_REPLACER_K;
+
+    fmt::print("accesses: {}\n", trace.size());
+    fmt::print("<<< BEGIN\n");
+    for (size_t pool_size : pool_sizes) {
+      for (const auto &[name, replacer_type] : policies) {
+        auto replacer = bustub::MakeReplacer(replacer_type, pool_size, k);
+        size_t hits = Replay(replacer.get(), pool_size, trace);
+        double hit_ratio = trace.empty() ? 0 : static_cast<double>(hits) / trace.size();
+        fmt::print("pool_size={} policy={} hits={} misses={} hit_ratio={:.4f}\n", pool_size, name, hits,
+                   trace.size() - hits, hit_ratio);
+      }
+    }
+    fmt::print(">>> END\n");
+  } catch (const bustub::Exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -120,6 +120,7 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--duration").help("run terrier bench for n milliseconds");
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
+  program.add_argument("--bpm-instances").help("number of buffer pool instances (shards) in terrier bench");
 
   try {
     program.parse_args(argc, argv);
@@ -129,7 +130,13 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  size_t bpm_instances = 1;
+  if (program.present("--bpm-instances")) {
+    bpm_instances = std::stoul(program.get("--bpm-instances"));
+  }
+  std::cerr << "x: " << bpm_instances << " buffer pool instance(s)" << std::endl;
+
+  auto bustub = std::make_unique<bustub::BustubInstance>(bpm_instances);
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
   // create schema